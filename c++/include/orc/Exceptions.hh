@@ -67,6 +67,18 @@ namespace orc {
     SchemaEvolutionError(const SchemaEvolutionError&);
     SchemaEvolutionError& operator=(const SchemaEvolutionError&) = delete;
   };
+
+  /**
+   * Thrown when an allocation would take more memory than a limit allows.
+   */
+  class MemoryLimitExceeded : public std::runtime_error {
+   public:
+    explicit MemoryLimitExceeded(const std::string& what_arg);
+    explicit MemoryLimitExceeded(const char* what_arg);
+    ~MemoryLimitExceeded() noexcept override;
+    MemoryLimitExceeded(const MemoryLimitExceeded&);
+    MemoryLimitExceeded& operator=(const MemoryLimitExceeded&) = delete;
+  };
 }  // namespace orc
 
 #endif
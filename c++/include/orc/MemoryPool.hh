@@ -22,19 +22,84 @@
 #include "orc/Int128.hh"
 #include "orc/orc-config.hh"
 
+#include <limits>
 #include <memory>
 
 namespace orc {
 
+  /**
+   * The allocations of a MemoryPool that keeps track of them.
+   */
+  struct MemoryPoolStats {
+    // the bytes that the pool holds now and held at most
+    uint64_t allocatedBytes = 0;
+    uint64_t peakAllocatedBytes = 0;
+    // the number of calls to malloc and how many of them reused freed memory
+    uint64_t allocationCount = 0;
+    uint64_t reusedAllocationCount = 0;
+  };
+
   class MemoryPool {
    public:
     virtual ~MemoryPool();
 
     virtual char* malloc(uint64_t size) = 0;
     virtual void free(char* p) = 0;
+
+    /**
+     * Allocate memory whose address is a multiple of the alignment, which is
+     * a power of two. The memory must be freed with freeAligned. By default,
+     * the pool takes a little more memory from malloc to align it.
+     */
+    virtual char* mallocAligned(uint64_t size, uint64_t alignment);
+    virtual void freeAligned(char* p);
+
+    /**
+     * Get the allocations of the pool.
+     * @return false if the pool does not keep track of them
+     */
+    virtual bool getStats(MemoryPoolStats& stats) const;
   };
   MemoryPool* getDefaultPool();
 
+  /**
+   * Create a pool that backs the allocations of at least the threshold,
+   * which is at least 2 MiB, with transparent huge pages where the platform
+   * supports them. These allocations are rounded up to whole huge pages, so
+   * the pool suits the large batches of wide scans, whose pages then take
+   * fewer TLB entries. The smaller allocations come from malloc.
+   */
+  std::unique_ptr<MemoryPool> createHugePageMemoryPool(uint64_t threshold = 2 * 1024 * 1024);
+
+  /**
+   * Create a pool that allocates from the parent pool and counts the bytes
+   * that are allocated now and at most. The bytes may not exceed the limit,
+   * beyond which malloc throws MemoryLimitExceeded.
+   *
+   * The pool is thread-safe if the parent pool is. It must outlive the
+   * memory that it allocates.
+   */
+  std::unique_ptr<MemoryPool> createTrackingMemoryPool(
+      MemoryPool& parent, uint64_t limit = std::numeric_limits<uint64_t>::max());
+
+  /**
+   * Create a pool that rounds the allocations of up to 4 MiB up to a power
+   * of two and caches the freed memory of each size to allocate it again, as
+   * the readers and writers allocate many buffers of the same few sizes,
+   * such as the compression block size. The cache is split into shards that
+   * are each used by a few threads, so that the threads rarely wait on each
+   * other. Larger allocations and frees beyond the cache capacity go to the
+   * parent pool.
+   *
+   * The pool is thread-safe if the parent pool is. It must outlive the
+   * memory that it allocates.
+   */
+  std::unique_ptr<MemoryPool> createSizeClassMemoryPool(
+      MemoryPool& parent, uint64_t cacheCapacity = 64 * 1024 * 1024);
+
+  // the alignment of the memory of a DataBuffer, which suits SIMD registers
+  constexpr uint64_t DATA_BUFFER_ALIGNMENT = 64;
+
   template <class T>
   class DataBuffer {
    private:
@@ -82,6 +147,22 @@ namespace orc {
 
     void reserve(uint64_t _size);
     void resize(uint64_t _size);
+
+    /**
+     * Resize the buffer without initializing the new elements, which the
+     * caller is expected to overwrite. Unlike resize, the capacity grows to
+     * at least twice its size, so that a buffer that is resized for every
+     * batch is reallocated a logarithmic number of times.
+     */
+    void resizeUninitialized(uint64_t _size);
+
+    /**
+     * Give back the unused memory once the buffer uses less than a quarter of
+     * its capacity. The capacity is cut to twice the size, so that a buffer
+     * whose size varies a little is not reallocated over and over.
+     * @return whether the buffer was reallocated
+     */
+    bool shrinkToFit();
   };
 
   // Specializations for char
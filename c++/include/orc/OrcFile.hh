@@ -19,7 +19,9 @@
 #ifndef ORC_FILE_HH
 #define ORC_FILE_HH
 
+#include <future>
 #include <string>
+#include <vector>
 
 #include "orc/Reader.hh"
 #include "orc/Writer.hh"
@@ -31,6 +33,14 @@
 
 namespace orc {
 
+  /**
+   * A range of bytes in a stream.
+   */
+  struct ReadRange {
+    uint64_t offset;
+    uint64_t length;
+  };
+
   /**
    * An abstract interface for providing ORC readers a stream of bytes.
    */
@@ -58,6 +68,38 @@ namespace orc {
      */
     virtual void read(void* buf, uint64_t length, uint64_t offset) = 0;
 
+    /**
+     * Read several ranges of the file, each into its own buffer.
+     * The default implementation calls read() for each range in turn.
+     * Streams that can serve several requests at once should override it.
+     * @param ranges the ranges to read.
+     * @param buffers the buffers to read the ranges into, one per range.
+     */
+    virtual void readv(const std::vector<ReadRange>& ranges, const std::vector<void*>& buffers);
+
+    /**
+     * Start reading several ranges of the file, each into its own buffer.
+     * The default implementation calls readv() on another thread, so the
+     * stream must support concurrent reads. The buffers must stay valid
+     * until the returned future is ready.
+     * @param ranges the ranges to read.
+     * @param buffers the buffers to read the ranges into, one per range.
+     * @return a future that is ready once all ranges have been read.
+     */
+    virtual std::future<void> readAsync(const std::vector<ReadRange>& ranges,
+                                        const std::vector<void*>& buffers);
+
+    /**
+     * Get the bytes of a range of the file without copying them, which is
+     * possible when the stream holds the whole file in memory. The bytes
+     * stay valid for the lifetime of the stream.
+     * The default implementation returns nullptr.
+     * @param offset the position in the stream of the range.
+     * @param length the number of bytes in the range.
+     * @return the bytes or nullptr if the range must be read.
+     */
+    virtual const char* getMappedRange(uint64_t offset, uint64_t length) const;
+
     /**
      * Get the name of the stream for error messages.
      */
@@ -122,6 +164,15 @@ namespace orc {
   std::unique_ptr<InputStream> readLocalFile(const std::string& path,
                                              ReaderMetrics* metrics = nullptr);
 
+  /**
+   * Create a stream to a local file that is mapped into memory. The
+   * column readers read the bytes of the file directly from the mapping.
+   * @param path the name of the file in the local file system
+   * @param metrics the metrics of the reader
+   */
+  std::unique_ptr<InputStream> readMappedLocalFile(const std::string& path,
+                                                   ReaderMetrics* metrics = nullptr);
+
   /**
    * Create a stream to an HDFS file.
    * @param path the uri of the file in HDFS
@@ -28,6 +28,7 @@
 #include "orc/sargs/SearchArgument.hh"
 
 #include <atomic>
+#include <functional>
 #include <map>
 #include <memory>
 #include <set>
@@ -59,9 +60,165 @@ namespace orc {
     std::atomic<uint64_t> IOBlockingLatencyUs{0};
     std::atomic<uint64_t> SelectedRowGroupCount{0};
     std::atomic<uint64_t> EvaluatedRowGroupCount{0};
+    // PrefetchStripeCount is the number of stripes read ahead on a background
+    // thread. PrefetchHiddenLatencyUs is the part of their I/O latency that
+    // overlapped with decoding, PrefetchBlockingLatencyUs the time the reader
+    // still had to wait for them.
+    std::atomic<uint64_t> PrefetchStripeCount{0};
+    std::atomic<uint64_t> PrefetchHiddenLatencyUs{0};
+    std::atomic<uint64_t> PrefetchBlockingLatencyUs{0};
+    // FileTailCacheHit and FileTailCacheMiss count the readers that found or
+    // did not find the tail of their file in the FileTailCache.
+    std::atomic<uint64_t> FileTailCacheHit{0};
+    std::atomic<uint64_t> FileTailCacheMiss{0};
+    // DecompressedChunkCacheHit and DecompressedChunkCacheMiss count the
+    // compressed chunks that were found or not found in the
+    // DecompressedChunkCache.
+    std::atomic<uint64_t> DecompressedChunkCacheHit{0};
+    std::atomic<uint64_t> DecompressedChunkCacheMiss{0};
+    // The MemoryPool fields are the stats of the memory pool of the reader
+    // after the last batch, if the pool keeps track of them, as the pools of
+    // createTrackingMemoryPool and createSizeClassMemoryPool do.
+    // StripeArenaPeakBytes is the most memory that the column readers of a
+    // stripe took from the stripe arena, if it is enabled.
+    std::atomic<uint64_t> MemoryPoolAllocatedBytes{0};
+    std::atomic<uint64_t> MemoryPoolPeakBytes{0};
+    std::atomic<uint64_t> MemoryPoolAllocationCount{0};
+    std::atomic<uint64_t> MemoryPoolReusedAllocationCount{0};
+    std::atomic<uint64_t> StripeArenaPeakBytes{0};
   };
   ReaderMetrics* getDefaultReaderMetrics();
 
+  /**
+   * A process-wide cache of the parsed tails of ORC files, i.e. their
+   * postscript, footer and metadata. createReader consults it, so opening a
+   * file again does not read and parse its tail, and the readers of a file
+   * share one copy of it.
+   *
+   * Entries are keyed by the cache key set with ReaderOptions::setCacheKey()
+   * and the length of the file. Readers without a cache key do not use the
+   * cache. The least recently used entries are evicted once the cache holds
+   * more than its capacity. The cache is disabled until a capacity is set.
+   *
+   * All methods are thread-safe.
+   */
+  class FileTailCache {
+   public:
+    virtual ~FileTailCache();
+
+    /**
+     * Set the maximum number of bytes of the cached tails and evict entries
+     * until they fit. A capacity of 0 disables the cache.
+     */
+    virtual void setCapacity(uint64_t bytes) = 0;
+
+    /**
+     * Get the maximum number of bytes of the cached tails.
+     */
+    virtual uint64_t getCapacity() const = 0;
+
+    /**
+     * Get the number of bytes of the cached tails.
+     */
+    virtual uint64_t getSize() const = 0;
+
+    /**
+     * Get the number of cached tails.
+     */
+    virtual uint64_t getEntryCount() const = 0;
+
+    /**
+     * Get the number of lookups that found the tail of their file.
+     */
+    virtual uint64_t getHitCount() const = 0;
+
+    /**
+     * Get the number of lookups that did not find the tail of their file.
+     */
+    virtual uint64_t getMissCount() const = 0;
+
+    /**
+     * Remove all entries.
+     */
+    virtual void clear() = 0;
+  };
+
+  /**
+   * Get the process-wide file tail cache.
+   */
+  FileTailCache* getFileTailCache();
+
+  /**
+   * A process-wide cache of the decompressed chunks of the streams that the
+   * row readers read, so that scanning the same stripes again, from any
+   * reader of the file, does not decompress them again.
+   *
+   * Chunks are keyed by the cache key set with ReaderOptions::setCacheKey()
+   * and the length of the file, the offset of their stream in the file and
+   * their offset in the stream. The chunks of readers without a cache key
+   * are not cached, as a stale chunk would be returned as column data. The
+   * cache is split into shards that are locked separately, and each shard
+   * evicts its least recently used chunks once it holds more than its share
+   * of the capacity. The cache is disabled until a capacity is set.
+   *
+   * All methods are thread-safe.
+   */
+  class DecompressedChunkCache {
+   public:
+    virtual ~DecompressedChunkCache();
+
+    /**
+     * Set the maximum number of bytes of the cached chunks and evict chunks
+     * until they fit. A capacity of 0 disables the cache.
+     */
+    virtual void setCapacity(uint64_t bytes) = 0;
+
+    /**
+     * Get the maximum number of bytes of the cached chunks.
+     */
+    virtual uint64_t getCapacity() const = 0;
+
+    /**
+     * Get the number of bytes of the cached chunks.
+     */
+    virtual uint64_t getSize() const = 0;
+
+    /**
+     * Get the number of cached chunks.
+     */
+    virtual uint64_t getEntryCount() const = 0;
+
+    /**
+     * Get the number of chunks that were found in the cache.
+     */
+    virtual uint64_t getHitCount() const = 0;
+
+    /**
+     * Get the number of chunks that were not found in the cache.
+     */
+    virtual uint64_t getMissCount() const = 0;
+
+    /**
+     * Set the pool that the chunks that are added from now on are allocated
+     * from, so that a TrackingMemoryPool counts them. The cached chunks are
+     * given back to the pool that they came from, which must outlive them:
+     * clear the cache before the pool is destroyed.
+     *
+     * Defaults to the default memory pool.
+     */
+    virtual void setMemoryPool(MemoryPool& pool) = 0;
+
+    /**
+     * Remove all chunks.
+     */
+    virtual void clear() = 0;
+  };
+
+  /**
+   * Get the process-wide decompressed chunk cache.
+   */
+  DecompressedChunkCache* getDecompressedChunkCache();
+
   /**
    * Options for creating a Reader.
    */
@@ -113,6 +270,19 @@ namespace orc {
      */
     ReaderOptions& setTailLocation(uint64_t offset);
 
+    /**
+     * Set the key that identifies the content of the file in the
+     * FileTailCache and the DecompressedChunkCache. It must differ between
+     * files and change whenever the file changes, such as the path together
+     * with the modification time or the ETag of an object. The name of the
+     * stream does not do: all MemoryInputStreams have the same name and a
+     * file that is rewritten in place keeps its name, so a reader could get
+     * the tail or the data of another file.
+     *
+     * Defaults to empty, which does not use the caches.
+     */
+    ReaderOptions& setCacheKey(const std::string& key);
+
     /**
      * Get the stream to write warnings or errors to.
      */
@@ -129,6 +299,11 @@ namespace orc {
      */
     uint64_t getTailLocation() const;
 
+    /**
+     * Get the key that identifies the content of the file in the caches.
+     */
+    const std::string& getCacheKey() const;
+
     /**
      * Get the memory allocator.
      */
@@ -140,6 +315,14 @@ namespace orc {
     ReaderMetrics* getReaderMetrics() const;
   };
 
+  /**
+   * Selects the rows of a batch that a RowReader returns. Only the fields of
+   * the batch that the filter reads are decoded when it is called. All flags
+   * of selected, which has one byte per row of the batch, are set on entry
+   * and the filter clears the flags of the rows to drop.
+   */
+  using RowFilter = std::function<void(const StructVectorBatch& batch, char* selected)>;
+
   /**
    * Options for creating a RowReader.
    */
@@ -356,9 +539,185 @@ namespace orc {
      * Whether reader throws or returns null when value overflows for schema evolution.
      */
     bool getThrowOnSchemaEvolutionOverflow() const;
+
+    /**
+     * Set the number of stripes to read ahead on background threads.
+     *
+     * While the current stripe is decoded, the footers and the streams of the
+     * selected columns of the following stripes are read into memory, so that
+     * moving to the next stripe does not block on I/O. The InputStream and the
+     * MemoryPool of the reader must support concurrent calls.
+     *
+     * Defaults to 0, which disables prefetching.
+     */
+    RowReaderOptions& setPrefetchStripeCount(uint32_t count);
+
+    /**
+     * Get the number of stripes to read ahead.
+     */
+    uint32_t getPrefetchStripeCount() const;
+
+    /**
+     * Set the maximum number of bytes held by the stripes that are read ahead.
+     * A stripe that does not fit into the budget is read when it is reached.
+     *
+     * Defaults to 256MB.
+     */
+    RowReaderOptions& setPrefetchMemoryBudget(uint64_t bytes);
+
+    /**
+     * Get the maximum number of bytes held by the stripes that are read ahead.
+     */
+    uint64_t getPrefetchMemoryBudget() const;
+
+    /**
+     * Set whether to read the streams of a stripe with a few large requests.
+     *
+     * The ranges of the streams of the selected columns that are at most
+     * getCoalesceMaxGap() bytes apart are merged and read at once, and the
+     * column readers consume slices of the resulting buffers instead of
+     * issuing one request per stream. This pays off on storage with a high
+     * per-request latency at the cost of holding the selected streams of the
+     * current stripe in memory.
+     *
+     * The stripe footer is read with the same InputStream::readv request as
+     * the index section, when the index is needed, and the data section, if
+     * each takes at most getCoalesceMaxGap() bytes. The other streams are
+     * read with a second request once the footer gives their ranges.
+     *
+     * Defaults to false.
+     */
+    RowReaderOptions& setCoalesceReads(bool coalesce);
+
+    /**
+     * Get whether to read the streams of a stripe with a few large requests.
+     */
+    bool getCoalesceReads() const;
+
+    /**
+     * Set the largest number of unneeded bytes between two streams that are
+     * read with a single request when reads are coalesced.
+     *
+     * Defaults to 1MB.
+     */
+    RowReaderOptions& setCoalesceMaxGap(uint64_t bytes);
+
+    /**
+     * Get the largest gap between two streams that are read together.
+     */
+    uint64_t getCoalesceMaxGap() const;
+
+    /**
+     * Set the number of threads that decode the columns of a batch.
+     *
+     * The children of a struct are decoded concurrently on a pool of threads
+     * that is owned by the RowReader. Wide columns such as strings, decimals
+     * and timestamps are decoded by tasks of their own, while narrow columns
+     * are grouped into shared tasks. This pays off for wide schemas. The
+     * InputStream and the MemoryPool of the reader must support concurrent
+     * calls.
+     *
+     * Defaults to 0. Values of 0 and 1 disable parallel column decoding, so
+     * all columns are decoded on the calling thread; a single thread would
+     * only add the cost of handing the tasks over.
+     */
+    RowReaderOptions& setColumnDecodeThreadCount(uint32_t count);
+
+    /**
+     * Get the number of threads that decode the columns of a batch.
+     */
+    uint32_t getColumnDecodeThreadCount() const;
+
+    /**
+     * Set a filter that selects the rows to read.
+     *
+     * For each batch the given top-level fields are decoded first and passed
+     * to the filter. The other fields are then decoded for the selected rows
+     * only, skipping the values of the dropped rows. The batches that
+     * RowReader::next returns hold the selected rows only, so that
+     * RowReader::getRowNumber is the first row of the range they were
+     * selected from. This pays off for selective filters on wide schemas.
+     *
+     * The columns of the boolean, integer, floating point, string and struct
+     * types skip each run of dropped rows. The other columns decode every
+     * row from the first to the last selected one of a batch and then drop
+     * the others, so a sparse filter saves little on them. The columns are
+     * decoded concurrently if setColumnDecodeThreadCount() asks for it.
+     * A filter cannot be combined with setEnableLazyDecoding(), and
+     * creating the RowReader throws ParseError then.
+     *
+     * @param columns the names of the selected top-level fields that the filter reads
+     * @param filter the filter, or an empty function to read all rows
+     */
+    RowReaderOptions& setRowFilter(const std::list<std::string>& columns, RowFilter filter);
+
+    /**
+     * Get the names of the fields that the row filter reads.
+     */
+    const std::list<std::string>& getRowFilterColumns() const;
+
+    /**
+     * Get the row filter.
+     */
+    const RowFilter& getRowFilter() const;
+
+    /**
+     * Set the largest number of rows that the RowReader returns.
+     *
+     * Once the rows are returned, RowReader::next returns false and no more
+     * stripes are read or prefetched. When the rows are read in order, which
+     * is without a search argument or a row filter, the remaining rows also
+     * bound the batches and the coalesced reads of the last stripe, which
+     * only cover the row groups up to the limit.
+     *
+     * Defaults to no limit.
+     */
+    RowReaderOptions& limit(uint64_t rows);
+
+    /**
+     * Get the largest number of rows that the RowReader returns.
+     */
+    uint64_t getLimit() const;
+
+    /**
+     * Set the most memory that the read and decompression buffers of the
+     * streams may hold at once.
+     *
+     * The RowReader lends these buffers from a pool, which keeps the released
+     * buffers of up to 4 MiB for the following streams and stripes. A stream
+     * holds its buffers only while it has bytes left to read, or to
+     * decompress. When the buffers that are in use would exceed the limit,
+     * the RowReader throws MemoryLimitExceeded. The buffers of a coalesced
+     * or prefetched stripe are not counted.
+     *
+     * Defaults to no limit.
+     */
+    RowReaderOptions& setReadBufferMemoryLimit(uint64_t bytes);
+
+    /**
+     * Get the most memory that the read and decompression buffers may hold.
+     */
+    uint64_t getReadBufferMemoryLimit() const;
+
+    /**
+     * Enable or disable the stripe arena. When enabled, the column readers
+     * take their memory from an arena that is freed at once when they are
+     * dropped at the end of each stripe, instead of allocating and freeing
+     * their many buffers one by one. The column readers are then built anew
+     * for every stripe.
+     *
+     * Defaults to false.
+     */
+    RowReaderOptions& setUseStripeArena(bool useStripeArena);
+
+    /**
+     * Get whether the column readers take their memory from a stripe arena.
+     */
+    bool getUseStripeArena() const;
   };
 
   class RowReader;
+  class ParallelRowReader;
 
   /**
    * The interface for reading ORC file meta-data and constructing RowReaders.
@@ -552,6 +911,29 @@ namespace orc {
      */
     virtual std::unique_ptr<RowReader> createRowReader(const RowReaderOptions& options) const = 0;
 
+    /**
+     * Create a ParallelRowReader based on this reader, which decodes up to
+     * threadCount stripes at the same time.
+     *
+     * The stripes are decoded on background threads, which call
+     * InputStream::read and InputStream::readv of the file and allocate from
+     * the MemoryPool of the reader concurrently. Both must be thread safe,
+     * as the local file streams and the default memory pool are.
+     *
+     * Each thread decodes all batches of its stripe before the caller takes
+     * them, so the memory of the batches is bounded only in whole decoded
+     * stripes, up to threadCount of them. The stripes share the read buffer
+     * memory limit and the column decode threads of the options.
+     *
+     * The default implementation throws NotImplementedYet.
+     * @param options RowReader Options
+     * @param batchSize the number of rows in each batch
+     * @param threadCount the number of stripes to decode concurrently
+     * @return a ParallelRowReader to read the rows
+     */
+    virtual std::unique_ptr<ParallelRowReader> createParallelRowReader(
+        const RowReaderOptions& options, uint64_t batchSize, uint32_t threadCount) const;
+
     /**
      * Get the name of the input stream.
      */
@@ -658,6 +1040,44 @@ namespace orc {
      */
     virtual void seekToRow(uint64_t rowNumber) = 0;
   };
+
+  /**
+   * A reader that decodes several stripes at the same time on background
+   * threads, each into its own batches, and returns the batches in the
+   * order of the file. Besides the stripe whose batches are being returned,
+   * at most threadCount stripes are decoded or waiting to be returned at
+   * any time, which bounds the memory of the batches.
+   *
+   * The input stream and the memory pool of the reader are used from
+   * several threads at once. See Reader::createParallelRowReader().
+   */
+  class ParallelRowReader {
+   public:
+    virtual ~ParallelRowReader();
+
+    /**
+     * Get the selected type of the rows in the file.
+     * See RowReader::getSelectedType().
+     */
+    virtual const Type& getSelectedType() const = 0;
+
+    /**
+     * Get the selected columns of the file.
+     */
+    virtual const std::vector<bool> getSelectedColumns() const = 0;
+
+    /**
+     * Get the next row batch. The batch belongs to the caller and is not
+     * reused by the reader.
+     * @return the batch or nullptr if the end of the file was reached
+     */
+    virtual std::unique_ptr<ColumnVectorBatch> next() = 0;
+
+    /**
+     * Get the row number of the first row in the previously returned batch.
+     */
+    virtual uint64_t getRowNumber() const = 0;
+  };
 }  // namespace orc
 
 #endif
@@ -49,6 +49,12 @@ namespace orc {
     std::atomic<uint64_t> IOCount{0};
     // Record the lantency of IO blocking
     std::atomic<uint64_t> IOBlockingLatencyUs{0};
+    // The stats of the memory pool of the writer after the last batch, if
+    // the pool keeps track of them
+    std::atomic<uint64_t> MemoryPoolAllocatedBytes{0};
+    std::atomic<uint64_t> MemoryPoolPeakBytes{0};
+    std::atomic<uint64_t> MemoryPoolAllocationCount{0};
+    std::atomic<uint64_t> MemoryPoolReusedAllocationCount{0};
   };
   /**
    * Options for creating a Writer.
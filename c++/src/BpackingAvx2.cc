@@ -0,0 +1,103 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "BpackingAvx2.hh"
+#include "BpackingDefault.hh"
+#include "Dispatch.hh"
+#include "RLEv2.hh"
+
+#if defined(ORC_HAVE_RUNTIME_AVX2)
+
+#include <immintrin.h>
+
+namespace orc {
+
+  namespace {
+    // the number of values unpacked by one iteration
+    const uint64_t VALUES_PER_VECTOR = 4;
+
+    /**
+     * Unpack count values, a multiple of VALUES_PER_VECTOR, that start on
+     * the first bit of the buffer. The word of each value must lie within
+     * the buffer.
+     */
+    ORC_TARGET_AVX2 void unpackWords(const char* buffer, int64_t* data, uint64_t count,
+                                     uint64_t fbs) {
+      const __m256i byteSwap =
+          _mm256_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2,
+                           1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+      const __m256i bitInByte = _mm256_set1_epi64x(7);
+      const __m256i step = _mm256_set1_epi64x(static_cast<int64_t>(VALUES_PER_VECTOR * fbs));
+      const __m128i rightShift = _mm_cvtsi64_si128(static_cast<int64_t>(64 - fbs));
+      const auto* base = reinterpret_cast<const long long*>(buffer);
+      int64_t width = static_cast<int64_t>(fbs);
+      __m256i bitPositions = _mm256_setr_epi64x(0, width, 2 * width, 3 * width);
+      for (uint64_t i = 0; i < count; i += VALUES_PER_VECTOR) {
+        __m256i words = _mm256_i64gather_epi64(base, _mm256_srli_epi64(bitPositions, 3), 1);
+        words = _mm256_shuffle_epi8(words, byteSwap);
+        words = _mm256_sllv_epi64(words, _mm256_and_si256(bitPositions, bitInByte));
+        words = _mm256_srl_epi64(words, rightShift);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(data + i), words);
+        bitPositions = _mm256_add_epi64(bitPositions, step);
+      }
+    }
+  }  // namespace
+
+  void BitUnpackAVX2::readLongs(RleDecoderV2* decoder, int64_t* data, uint64_t offset,
+                                uint64_t len, uint64_t fbs) {
+    // a word holds the value and the bits before it within its first byte
+    if (fbs > 56 && fbs != 64) {
+      BitUnpackDefault::readLongs(decoder, data, offset, len, fbs);
+      return;
+    }
+    UnpackDefault unpackDefault(decoder);
+    uint64_t curIdx = offset;
+    uint64_t end = offset + len;
+    while (curIdx < end) {
+      // the vector loop starts on a byte boundary and reads a word for each
+      // value, so it stops 8 bytes before the end of the buffer
+      uint64_t count = 0;
+      uint64_t available = decoder->bufLength();
+      if (decoder->getBitsLeft() == 0 && available >= sizeof(uint64_t)) {
+        count = ((available - sizeof(uint64_t)) * 8 + 7) / fbs + 1;
+        if (count > end - curIdx) {
+          count = end - curIdx;
+        }
+        count -= count % VALUES_PER_VECTOR;
+      }
+      if (count == 0) {
+        unpackDefault.plainUnpackLongs(data, curIdx, 1, fbs);
+        curIdx += 1;
+        continue;
+      }
+      const char* buffer = decoder->getBufStart();
+      unpackWords(buffer, data + curIdx, count, fbs);
+      curIdx += count;
+      uint64_t bits = count * fbs;
+      decoder->setBufStart(buffer + bits / 8);
+      if (bits % 8 != 0) {
+        decoder->setCurByte(decoder->readByte());
+        decoder->setBitsLeft(static_cast<uint32_t>(8 - bits % 8));
+      }
+    }
+  }
+
+}  // namespace orc
+
+#endif
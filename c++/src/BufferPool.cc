@@ -0,0 +1,162 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "BufferPool.hh"
+
+#include "orc/Exceptions.hh"
+
+#include <sstream>
+
+namespace orc {
+
+  const uint64_t BufferPool::MIN_POOLED_SIZE;
+  const uint64_t BufferPool::MAX_POOLED_SIZE;
+
+  // the index of the size class of a pooled buffer size
+  static size_t getSizeClass(uint64_t size) {
+    size_t sizeClass = 0;
+    for (uint64_t classSize = BufferPool::MIN_POOLED_SIZE; classSize < size; classSize <<= 1) {
+      ++sizeClass;
+    }
+    return sizeClass;
+  }
+
+  BufferPool::BufferPool(MemoryPool& pool, uint64_t _memoryLimit)
+      : memoryPool(pool),
+        memoryLimit(_memoryLimit),
+        freeBuffers(getSizeClass(MAX_POOLED_SIZE) + 1),
+        lentBytes(0),
+        keptBytes(0) {
+    // PASS
+  }
+
+  BufferPool::~BufferPool() {
+    freeKeptBuffers();
+  }
+
+  void BufferPool::freeKeptBuffers() {
+    for (auto& buffers : freeBuffers) {
+      for (char* buffer : buffers) {
+        memoryPool.free(buffer);
+      }
+      buffers.clear();
+    }
+    keptBytes = 0;
+  }
+
+  char* BufferPool::acquire(uint64_t size, uint64_t& capacity) {
+    bool isPooled = size <= MAX_POOLED_SIZE;
+    size_t sizeClass = 0;
+    capacity = size;
+    if (isPooled) {
+      sizeClass = getSizeClass(size);
+      capacity = MIN_POOLED_SIZE << sizeClass;
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (isPooled && !freeBuffers[sizeClass].empty()) {
+        char* buffer = freeBuffers[sizeClass].back();
+        freeBuffers[sizeClass].pop_back();
+        keptBytes -= capacity;
+        lentBytes += capacity;
+        return buffer;
+      }
+      if (lentBytes + keptBytes + capacity > memoryLimit) {
+        // make room by dropping the buffers of the other sizes
+        freeKeptBuffers();
+        if (lentBytes + capacity > memoryLimit) {
+          std::stringstream msg;
+          msg << "Read buffers would take " << lentBytes + capacity
+              << " bytes, more than the limit of " << memoryLimit;
+          throw MemoryLimitExceeded(msg.str());
+        }
+      }
+      lentBytes += capacity;
+    }
+    try {
+      return memoryPool.malloc(capacity);
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(mutex);
+      lentBytes -= capacity;
+      throw;
+    }
+  }
+
+  void BufferPool::release(char* buffer, uint64_t capacity) {
+    if (capacity <= MAX_POOLED_SIZE) {
+      std::lock_guard<std::mutex> lock(mutex);
+      freeBuffers[getSizeClass(capacity)].push_back(buffer);
+      lentBytes -= capacity;
+      keptBytes += capacity;
+      return;
+    }
+    memoryPool.free(buffer);
+    std::lock_guard<std::mutex> lock(mutex);
+    lentBytes -= capacity;
+  }
+
+  uint64_t BufferPool::getMemoryUsage() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return lentBytes + keptBytes;
+  }
+
+  uint64_t BufferPool::getLentMemory() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return lentBytes;
+  }
+
+  PooledBuffer::PooledBuffer(MemoryPool& pool, BufferPool* _bufferPool)
+      : memoryPool(pool), bufferPool(_bufferPool), buffer(nullptr), bufferCapacity(0) {
+    // PASS
+  }
+
+  PooledBuffer::~PooledBuffer() {
+    release();
+  }
+
+  void PooledBuffer::setBufferPool(BufferPool* pool) {
+    release();
+    bufferPool = pool;
+  }
+
+  void PooledBuffer::reserve(uint64_t size) {
+    if (buffer != nullptr && bufferCapacity >= size) {
+      return;
+    }
+    release();
+    if (bufferPool != nullptr) {
+      buffer = bufferPool->acquire(size, bufferCapacity);
+    } else {
+      buffer = memoryPool.malloc(size);
+      bufferCapacity = size;
+    }
+  }
+
+  void PooledBuffer::release() {
+    if (buffer != nullptr) {
+      if (bufferPool != nullptr) {
+        bufferPool->release(buffer, bufferCapacity);
+      } else {
+        memoryPool.free(buffer);
+      }
+      buffer = nullptr;
+      bufferCapacity = 0;
+    }
+  }
+
+}  // namespace orc
@@ -0,0 +1,127 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ORC_BUFFER_POOL_HH
+#define ORC_BUFFER_POOL_HH
+
+#include "orc/MemoryPool.hh"
+
+#include <mutex>
+#include <vector>
+
+namespace orc {
+
+  /**
+   * Lends the buffers that the streams of a RowReader read and decompress
+   * into. The streams borrow a buffer when they need one and give it back
+   * once they reach the end or no longer point into it, so that the many
+   * streams of a wide schema do not each hold a buffer of their own. The
+   * buffers up to MAX_POOLED_SIZE are rounded up to a power of two and the
+   * returned ones are kept to be lent again. The lent and the kept buffers
+   * together may not take more than the memory limit.
+   *
+   * The methods may be called concurrently.
+   */
+  class BufferPool {
+   public:
+    // the sizes of the smallest and the largest buffers that are kept
+    static const uint64_t MIN_POOLED_SIZE = 4 * 1024;
+    static const uint64_t MAX_POOLED_SIZE = 4 * 1024 * 1024;
+
+    BufferPool(MemoryPool& pool, uint64_t memoryLimit);
+    ~BufferPool();
+
+    /**
+     * Borrow a buffer.
+     * @param size the least size of the buffer
+     * @param capacity set to the size of the buffer
+     * @throws MemoryLimitExceeded if the buffer would exceed the memory limit
+     */
+    char* acquire(uint64_t size, uint64_t& capacity);
+
+    /**
+     * Give back a buffer that acquire returned.
+     */
+    void release(char* buffer, uint64_t capacity);
+
+    // the bytes of the lent and the kept buffers
+    uint64_t getMemoryUsage() const;
+
+    // the bytes of the lent buffers
+    uint64_t getLentMemory() const;
+
+    uint64_t getMemoryLimit() const {
+      return memoryLimit;
+    }
+
+   private:
+    MemoryPool& memoryPool;
+    const uint64_t memoryLimit;
+    mutable std::mutex mutex;
+    // the kept buffers of each power of two from MIN_POOLED_SIZE on
+    std::vector<std::vector<char*>> freeBuffers;
+    uint64_t lentBytes;
+    uint64_t keptBytes;
+
+    // free the kept buffers, must hold the mutex
+    void freeKeptBuffers();
+  };
+
+  /**
+   * A buffer that is borrowed from a BufferPool, or allocated from the
+   * MemoryPool if there is no BufferPool, when it is needed and given back
+   * when it is released or destroyed.
+   */
+  class PooledBuffer {
+   public:
+    PooledBuffer(MemoryPool& pool, BufferPool* bufferPool);
+    ~PooledBuffer();
+
+    PooledBuffer(const PooledBuffer&) = delete;
+    PooledBuffer& operator=(const PooledBuffer&) = delete;
+
+    // borrow the next buffers from the given pool, or allocate them if nullptr
+    void setBufferPool(BufferPool* pool);
+
+    /**
+     * Make the buffer hold at least the given number of bytes. The content
+     * is not kept when the buffer grows.
+     */
+    void reserve(uint64_t size);
+
+    // give the buffer back
+    void release();
+
+    char* data() const {
+      return buffer;
+    }
+
+    uint64_t capacity() const {
+      return bufferCapacity;
+    }
+
+   private:
+    MemoryPool& memoryPool;
+    BufferPool* bufferPool;
+    char* buffer;
+    uint64_t bufferCapacity;
+  };
+
+}  // namespace orc
+
+#endif
@@ -18,10 +18,18 @@
 
 #include <string.h>
 #include <algorithm>
+#include <bitset>
 #include <iostream>
 #include <utility>
+#include <vector>
 
 #include "ByteRLE.hh"
+#include "ByteRleAvx2.hh"
+#include "ByteRleDefault.hh"
+#if defined(ORC_HAVE_RUNTIME_AVX512)
+#include "ByteRleAvx512.hh"
+#endif
+#include "Dispatch.hh"
 #include "Utils.hh"
 #include "orc/Exceptions.hh"
 
@@ -309,6 +317,104 @@ namespace orc {
     // PASS
   }
 
+  uint64_t ByteRleDecoder::nextAndCount(char* data, uint64_t numValues, char* notNull) {
+    next(data, numValues, notNull);
+    return countNonZero(data, numValues);
+  }
+
+  uint64_t ByteRleDecoder::skipAndCount(uint64_t numValues) {
+    // page through the values and count the ones that are not zero
+    const uint64_t MAX_BUFFER_SIZE = 32768;
+    char buffer[MAX_BUFFER_SIZE];
+    uint64_t count = 0;
+    while (numValues > 0) {
+      uint64_t chunkSize = std::min(numValues, MAX_BUFFER_SIZE);
+      next(buffer, chunkSize, nullptr);
+      count += countNonZero(buffer, chunkSize);
+      numValues -= chunkSize;
+    }
+    return count;
+  }
+
+  struct CountNonZeroDynamicFunction {
+    using FunctionType = decltype(&ByteRleDefault::countNonZero);
+
+    static std::vector<std::pair<DispatchLevel, FunctionType>> implementations() {
+      return {{DispatchLevel::NONE, ByteRleDefault::countNonZero},
+#if defined(ORC_HAVE_RUNTIME_AVX2)
+              {DispatchLevel::AVX2, ByteRleAVX2::countNonZero},
+#endif
+#if defined(ORC_HAVE_RUNTIME_AVX512)
+              {DispatchLevel::AVX512, ByteRleAVX512::countNonZero},
+#endif
+      };
+    }
+  };
+
+  uint64_t countNonZero(const char* data, uint64_t numValues) {
+    static DynamicDispatch<CountNonZeroDynamicFunction> dispatch;
+    return dispatch.func(data, numValues);
+  }
+
+  struct CountBitsDynamicFunction {
+    using FunctionType = decltype(&ByteRleDefault::countBits);
+
+    static std::vector<std::pair<DispatchLevel, FunctionType>> implementations() {
+#if defined(ORC_HAVE_RUNTIME_AVX2)
+      return {{DispatchLevel::NONE, ByteRleDefault::countBits},
+              {DispatchLevel::AVX2, ByteRleAVX2::countBits}};
+#else
+      return {{DispatchLevel::NONE, ByteRleDefault::countBits}};
+#endif
+    }
+  };
+
+  uint64_t countBits(const unsigned char* data, uint64_t numBytes) {
+    static DynamicDispatch<CountBitsDynamicFunction> dispatch;
+    return dispatch.func(data, numBytes);
+  }
+
+  struct FillRunDynamicFunction {
+    using FunctionType = decltype(&ByteRleDefault::fillRun);
+
+    static std::vector<std::pair<DispatchLevel, FunctionType>> implementations() {
+      return {{DispatchLevel::NONE, ByteRleDefault::fillRun},
+#if defined(ORC_HAVE_RUNTIME_AVX2)
+              {DispatchLevel::AVX2, ByteRleAVX2::fillRun},
+#endif
+#if defined(ORC_HAVE_RUNTIME_AVX512)
+              {DispatchLevel::AVX512, ByteRleAVX512::fillRun},
+#endif
+      };
+    }
+  };
+
+  uint64_t fillRun(char* data, char value, uint64_t numValues, const char* notNull) {
+    static DynamicDispatch<FillRunDynamicFunction> dispatch;
+    return dispatch.func(data, value, numValues, notNull);
+  }
+
+  struct UnpackBooleansDynamicFunction {
+    using FunctionType = decltype(&ByteRleDefault::unpackBooleans);
+
+    static std::vector<std::pair<DispatchLevel, FunctionType>> implementations() {
+      return {{DispatchLevel::NONE, ByteRleDefault::unpackBooleans},
+#if defined(ORC_HAVE_RUNTIME_AVX2)
+              {DispatchLevel::AVX2, ByteRleAVX2::unpackBooleans},
+#endif
+#if defined(ORC_HAVE_RUNTIME_AVX512)
+              {DispatchLevel::AVX512, ByteRleAVX512::unpackBooleans},
+#endif
+      };
+    }
+  };
+
+  uint64_t unpackBooleans(const unsigned char* bits, uint64_t bitOffset, char* data,
+                          uint64_t numValues, const char* notNull) {
+    static DynamicDispatch<UnpackBooleansDynamicFunction> dispatch;
+    return dispatch.func(bits, bitOffset, data, numValues, notNull);
+  }
+
   class ByteRleDecoderImpl : public ByteRleDecoder {
    public:
     ByteRleDecoderImpl(std::unique_ptr<SeekableInputStream> input, ReaderMetrics* metrics);
@@ -332,6 +438,8 @@ namespace orc {
 
    protected:
     void nextInternal(char* data, uint64_t numValues, char* notNull);
+    // skip the given number of bytes and count the bits that are set in them
+    uint64_t skipAndCountBits(uint64_t numValues);
     inline void nextBuffer();
     inline signed char readByte();
     inline void readHeader();
@@ -431,6 +539,33 @@ namespace orc {
     }
   }
 
+  uint64_t ByteRleDecoderImpl::skipAndCountBits(uint64_t numValues) {
+    uint64_t bitCount = 0;
+    while (numValues > 0) {
+      if (remainingValues == 0) {
+        readHeader();
+      }
+      size_t count = std::min(static_cast<size_t>(numValues), remainingValues);
+      remainingValues -= count;
+      numValues -= count;
+      if (repeating) {
+        bitCount += std::bitset<8>(static_cast<unsigned char>(value)).count() * count;
+      } else {
+        // count the literals in place instead of copying them out
+        while (count > 0) {
+          if (bufferStart == bufferEnd) {
+            nextBuffer();
+          }
+          size_t countSize = std::min(count, static_cast<size_t>(bufferEnd - bufferStart));
+          bitCount += countBits(reinterpret_cast<const unsigned char*>(bufferStart), countSize);
+          bufferStart += countSize;
+          count -= countSize;
+        }
+      }
+    }
+    return bitCount;
+  }
+
   void ByteRleDecoderImpl::next(char* data, uint64_t numValues, char* notNull) {
     SCOPED_STOPWATCH(metrics, ByteDecodingLatencyUs, ByteDecodingCall);
     nextInternal(data, numValues, notNull);
@@ -452,12 +587,7 @@ namespace orc {
       uint64_t consumed = 0;
       if (repeating) {
         if (notNull) {
-          for (uint64_t i = 0; i < count; ++i) {
-            if (notNull[position + i]) {
-              data[position + i] = value;
-              consumed += 1;
-            }
-          }
+          consumed = fillRun(data + position, value, count, notNull + position);
         } else {
           memset(data + position, value, count);
           consumed = count;
@@ -520,9 +650,21 @@ namespace orc {
      */
     virtual void next(char* data, uint64_t numValues, char* notNull) override;
 
+    /**
+     * Read a number of values into the batch and count the true ones.
+     */
+    virtual uint64_t nextAndCount(char* data, uint64_t numValues, char* notNull) override;
+
+    /**
+     * Seek over a number of values and count the true ones.
+     */
+    virtual uint64_t skipAndCount(uint64_t numValues) override;
+
    protected:
     size_t remainingBits;
     char lastByte;
+    // the rest of lastByte followed by the bytes of the current batch
+    std::vector<unsigned char> bits;
   };
 
   BooleanRleDecoderImpl::BooleanRleDecoderImpl(std::unique_ptr<SeekableInputStream> input,
@@ -565,71 +707,52 @@ namespace orc {
     }
   }
 
-  void BooleanRleDecoderImpl::next(char* data, uint64_t numValues, char* notNull) {
+  uint64_t BooleanRleDecoderImpl::skipAndCount(uint64_t numValues) {
     SCOPED_STOPWATCH(metrics, ByteDecodingLatencyUs, ByteDecodingCall);
-    // next spot to fill in
-    uint64_t position = 0;
-
-    // use up any remaining bits
-    if (notNull) {
-      while (remainingBits > 0 && position < numValues) {
-        if (notNull[position]) {
-          remainingBits -= 1;
-          data[position] = (static_cast<unsigned char>(lastByte) >> remainingBits) & 0x1;
-        } else {
-          data[position] = 0;
-        }
-        position += 1;
-      }
+    // the unread bits of lastByte are its low remainingBits bits
+    unsigned char rest = static_cast<unsigned char>(
+        static_cast<unsigned char>(lastByte) & ((1U << remainingBits) - 1));
+    if (numValues <= remainingBits) {
+      remainingBits -= numValues;
+      return std::bitset<8>(static_cast<unsigned char>(rest >> remainingBits)).count();
+    }
+    uint64_t count = std::bitset<8>(rest).count();
+    numValues -= remainingBits;
+    count += skipAndCountBits(numValues / 8);
+    if (numValues % 8 != 0) {
+      ByteRleDecoderImpl::nextInternal(&lastByte, 1, nullptr);
+      remainingBits = 8 - (numValues % 8);
+      count += std::bitset<8>(static_cast<unsigned char>(lastByte) >> remainingBits).count();
     } else {
-      while (remainingBits > 0 && position < numValues) {
-        remainingBits -= 1;
-        data[position++] = (static_cast<unsigned char>(lastByte) >> remainingBits) & 0x1;
-      }
+      remainingBits = 0;
     }
+    return count;
+  }
 
-    // count the number of nonNulls remaining
-    uint64_t nonNulls = numValues - position;
-    if (notNull) {
-      for (uint64_t i = position; i < numValues; ++i) {
-        if (!notNull[i]) {
-          nonNulls -= 1;
-        }
-      }
-    }
+  void BooleanRleDecoderImpl::next(char* data, uint64_t numValues, char* notNull) {
+    nextAndCount(data, numValues, notNull);
+  }
 
-    // fill in the remaining values
-    if (nonNulls == 0) {
-      while (position < numValues) {
-        data[position++] = 0;
-      }
-    } else if (position < numValues) {
-      // read the new bytes into the array
-      uint64_t bytesRead = (nonNulls + 7) / 8;
-      ByteRleDecoderImpl::nextInternal(data + position, bytesRead, nullptr);
-      lastByte = data[position + bytesRead - 1];
-      remainingBits = bytesRead * 8 - nonNulls;
-      // expand the array backwards so that we don't clobber the data
-      uint64_t bitsLeft = bytesRead * 8 - remainingBits;
-      if (notNull) {
-        for (int64_t i = static_cast<int64_t>(numValues) - 1; i >= static_cast<int64_t>(position);
-             --i) {
-          if (notNull[i]) {
-            uint64_t shiftPosn = (-bitsLeft) % 8;
-            data[i] = (data[position + (bitsLeft - 1) / 8] >> shiftPosn) & 0x1;
-            bitsLeft -= 1;
-          } else {
-            data[i] = 0;
-          }
-        }
-      } else {
-        for (int64_t i = static_cast<int64_t>(numValues) - 1; i >= static_cast<int64_t>(position);
-             --i, --bitsLeft) {
-          uint64_t shiftPosn = (-bitsLeft) % 8;
-          data[i] = (data[position + (bitsLeft - 1) / 8] >> shiftPosn) & 0x1;
-        }
-      }
+  uint64_t BooleanRleDecoderImpl::nextAndCount(char* data, uint64_t numValues, char* notNull) {
+    SCOPED_STOPWATCH(metrics, ByteDecodingLatencyUs, ByteDecodingCall);
+    uint64_t nonNulls = notNull ? countNonZero(notNull, numValues) : numValues;
+    uint64_t newBits = nonNulls > remainingBits ? nonNulls - remainingBits : 0;
+    uint64_t bytesRead = (newBits + 7) / 8;
+    // leave room for the kernels to read a word past the last byte
+    if (bits.size() < bytesRead + 1 + sizeof(uint64_t)) {
+      bits.resize(bytesRead + 1 + sizeof(uint64_t));
+    }
+    bits[0] = static_cast<unsigned char>(lastByte);
+    uint64_t bitOffset = 8 - remainingBits;
+    if (bytesRead > 0) {
+      ByteRleDecoderImpl::nextInternal(reinterpret_cast<char*>(bits.data() + 1), bytesRead,
+                                       nullptr);
+      lastByte = static_cast<char>(bits[bytesRead]);
+      remainingBits = bytesRead * 8 - newBits;
+    } else {
+      remainingBits -= nonNulls;
     }
+    return unpackBooleans(bits.data(), bitOffset, data, numValues, notNull);
   }
 
   std::unique_ptr<ByteRleDecoder> createBooleanRleDecoder(
@@ -83,8 +83,57 @@ namespace orc {
      *    pointer is not null, positions that are false are skipped.
      */
     virtual void next(char* data, uint64_t numValues, char* notNull) = 0;
+
+    /**
+     * Read a number of values into the batch like next and count the values
+     * that are not zero, which saves the caller a scan of the batch.
+     * @return the number of values that are not zero
+     */
+    virtual uint64_t nextAndCount(char* data, uint64_t numValues, char* notNull);
+
+    /**
+     * Seek over a given number of values like skip and count the values
+     * that are not zero, which lets the column readers count the nulls
+     * they skip.
+     * @return the number of values that are not zero
+     */
+    virtual uint64_t skipAndCount(uint64_t numValues);
   };
 
+  /**
+   * Count the bytes that are not zero with the best implementation for
+   * the CPU.
+   */
+  uint64_t countNonZero(const char* data, uint64_t numValues);
+
+  /**
+   * Count the bits that are set with the best implementation for the CPU.
+   */
+  uint64_t countBits(const unsigned char* data, uint64_t numBytes);
+
+  /**
+   * Set the positions that are true in notNull to the value of a run with
+   * the best implementation for the CPU.
+   * @return the number of positions that were set
+   */
+  uint64_t fillRun(char* data, char value, uint64_t numValues, const char* notNull);
+
+  /**
+   * Expand booleans, stored as bits with the most significant bit first,
+   * into one byte per value with the best implementation for the CPU. The
+   * positions that are false in notNull are set to 0 and do not consume a
+   * bit.
+   * @param bits the packed booleans, which must be readable for 8 bytes
+   *    after the last bit that is used
+   * @param bitOffset the index of the first bit to use
+   * @param data the array to expand into
+   * @param numValues the number of values to expand
+   * @param notNull if not null, the positions that hold a value
+   * @return the number of values that are true
+   */
+  uint64_t unpackBooleans(const unsigned char* bits, uint64_t bitOffset, char* data,
+                          uint64_t numValues, const char* notNull);
+
   /**
    * Create a byte RLE encoder.
    * @param output the output stream to write to
@@ -0,0 +1,132 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "ByteRleAvx2.hh"
+#include "ByteRleDefault.hh"
+#include "Dispatch.hh"
+
+#if defined(ORC_HAVE_RUNTIME_AVX2)
+
+#include <immintrin.h>
+#include <string.h>
+
+namespace orc {
+
+  namespace {
+    const uint64_t VALUES_PER_VECTOR = 32;
+
+    inline uint32_t reverseBitsInBytes(uint32_t word) {
+      word = ((word >> 1) & 0x55555555U) | ((word & 0x55555555U) << 1);
+      word = ((word >> 2) & 0x33333333U) | ((word & 0x33333333U) << 2);
+      return ((word >> 4) & 0x0F0F0F0FU) | ((word & 0x0F0F0F0FU) << 4);
+    }
+
+    // the 32 bits from the given bit on, with the first one in the least significant bit
+    inline uint32_t loadBits(const unsigned char* bits, uint64_t bitOffset) {
+      uint64_t word;
+      memcpy(&word, bits + bitOffset / 8, sizeof(word));
+      uint64_t low = reverseBitsInBytes(static_cast<uint32_t>(word));
+      uint64_t high = reverseBitsInBytes(static_cast<uint32_t>(word >> 32));
+      return static_cast<uint32_t>(((high << 32) | low) >> (bitOffset % 8));
+    }
+
+    // one byte per bit of the mask, the first bit in the least significant bit
+    ORC_TARGET_AVX2 inline __m256i expandMask(uint32_t mask) {
+      const __m256i spread = _mm256_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 2,
+                                              2, 2, 2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3);
+      const __m256i select = _mm256_set1_epi64x(static_cast<int64_t>(0x8040201008040201ULL));
+      __m256i bytes = _mm256_shuffle_epi8(_mm256_set1_epi32(static_cast<int>(mask)), spread);
+      __m256i set = _mm256_cmpeq_epi8(_mm256_and_si256(bytes, select), select);
+      return _mm256_and_si256(set, _mm256_set1_epi8(1));
+    }
+
+    // the mask of the bytes that are zero
+    ORC_TARGET_AVX2 inline uint32_t zeroMask(const char* data) {
+      __m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+      return static_cast<uint32_t>(
+          _mm256_movemask_epi8(_mm256_cmpeq_epi8(values, _mm256_setzero_si256())));
+    }
+  }  // namespace
+
+  ORC_TARGET_AVX2 uint64_t ByteRleAVX2::countNonZero(const char* data, uint64_t numValues) {
+    uint64_t count = 0;
+    uint64_t position = 0;
+    for (; numValues - position >= VALUES_PER_VECTOR; position += VALUES_PER_VECTOR) {
+      count += VALUES_PER_VECTOR - static_cast<uint64_t>(_mm_popcnt_u32(zeroMask(data + position)));
+    }
+    return count + ByteRleDefault::countNonZero(data + position, numValues - position);
+  }
+
+  ORC_TARGET_AVX2 uint64_t ByteRleAVX2::countBits(const unsigned char* data, uint64_t numBytes) {
+    uint64_t count = 0;
+    uint64_t position = 0;
+    for (; numBytes - position >= sizeof(uint64_t); position += sizeof(uint64_t)) {
+      uint64_t word;
+      memcpy(&word, data + position, sizeof(word));
+      count += static_cast<uint64_t>(_mm_popcnt_u64(word));
+    }
+    return count + ByteRleDefault::countBits(data + position, numBytes - position);
+  }
+
+  ORC_TARGET_AVX2 uint64_t ByteRleAVX2::fillRun(char* data, char value, uint64_t numValues,
+                                                const char* notNull) {
+    const __m256i values = _mm256_set1_epi8(value);
+    uint64_t filled = 0;
+    uint64_t position = 0;
+    for (; numValues - position >= VALUES_PER_VECTOR; position += VALUES_PER_VECTOR) {
+      __m256i mask = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(notNull + position));
+      __m256i nulls = _mm256_cmpeq_epi8(mask, _mm256_setzero_si256());
+      auto* target = reinterpret_cast<__m256i*>(data + position);
+      _mm256_storeu_si256(target, _mm256_blendv_epi8(values, _mm256_loadu_si256(target), nulls));
+      uint32_t nullMask = static_cast<uint32_t>(_mm256_movemask_epi8(nulls));
+      filled += VALUES_PER_VECTOR - static_cast<uint64_t>(_mm_popcnt_u32(nullMask));
+    }
+    return filled + ByteRleDefault::fillRun(data + position, value, numValues - position,
+                                            notNull + position);
+  }
+
+  ORC_TARGET_AVX2 uint64_t ByteRleAVX2::unpackBooleans(const unsigned char* bits,
+                                                       uint64_t bitOffset, char* data,
+                                                       uint64_t numValues, const char* notNull) {
+    // pdep is microcoded on some CPUs, where the default kernel is faster under nulls
+    if (notNull && !CpuInfo::getInstance()->hasEfficientBmi2()) {
+      return ByteRleDefault::unpackBooleans(bits, bitOffset, data, numValues, notNull);
+    }
+    uint64_t ones = 0;
+    uint64_t position = 0;
+    for (; numValues - position >= VALUES_PER_VECTOR; position += VALUES_PER_VECTOR) {
+      uint32_t present = ~0U;
+      uint32_t values = loadBits(bits, bitOffset);
+      if (notNull) {
+        // deposit the next bits into the present positions
+        present = ~zeroMask(notNull + position);
+        values = _pdep_u32(values, present);
+      }
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(data + position), expandMask(values));
+      bitOffset += static_cast<uint64_t>(_mm_popcnt_u32(present));
+      ones += static_cast<uint64_t>(_mm_popcnt_u32(values));
+    }
+    return ones + ByteRleDefault::unpackBooleans(bits, bitOffset, data + position,
+                                                 numValues - position,
+                                                 notNull ? notNull + position : nullptr);
+  }
+
+}  // namespace orc
+
+#endif
@@ -0,0 +1,98 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "ByteRleAvx512.hh"
+
+#include <immintrin.h>
+#include <string.h>
+
+namespace orc {
+
+  namespace {
+    // reverse the order of the bits within each byte
+    inline uint64_t reverseBitsInBytes(uint64_t word) {
+      word = ((word >> 1) & 0x5555555555555555ULL) | ((word & 0x5555555555555555ULL) << 1);
+      word = ((word >> 2) & 0x3333333333333333ULL) | ((word & 0x3333333333333333ULL) << 2);
+      return ((word >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((word & 0x0F0F0F0F0F0F0F0FULL) << 4);
+    }
+
+    // the 64 bits from the given bit on, with the first one in the least significant bit
+    inline uint64_t loadBits(const unsigned char* bits, uint64_t bitOffset) {
+      uint64_t word;
+      memcpy(&word, bits + bitOffset / 8, sizeof(word));
+      word = reverseBitsInBytes(word);
+      uint64_t shift = bitOffset % 8;
+      if (shift != 0) {
+        word >>= shift;
+        word |= reverseBitsInBytes(bits[bitOffset / 8 + 8]) << (64 - shift);
+      }
+      return word;
+    }
+
+    // the mask of the first numValues lanes
+    inline __mmask64 laneMask(uint64_t numValues) {
+      return numValues >= 64 ? ~0ULL : (1ULL << numValues) - 1;
+    }
+  }  // namespace
+
+  uint64_t ByteRleAVX512::countNonZero(const char* data, uint64_t numValues) {
+    uint64_t count = 0;
+    for (uint64_t position = 0; position < numValues; position += 64) {
+      __mmask64 lanes = laneMask(numValues - position);
+      __m512i values = _mm512_maskz_loadu_epi8(lanes, data + position);
+      count += static_cast<uint64_t>(_mm_popcnt_u64(_mm512_test_epi8_mask(values, values)));
+    }
+    return count;
+  }
+
+  uint64_t ByteRleAVX512::fillRun(char* data, char value, uint64_t numValues,
+                                  const char* notNull) {
+    const __m512i values = _mm512_set1_epi8(value);
+    uint64_t filled = 0;
+    for (uint64_t position = 0; position < numValues; position += 64) {
+      __mmask64 lanes = laneMask(numValues - position);
+      __m512i mask = _mm512_maskz_loadu_epi8(lanes, notNull + position);
+      __mmask64 present = _mm512_test_epi8_mask(mask, mask);
+      _mm512_mask_storeu_epi8(data + position, present, values);
+      filled += static_cast<uint64_t>(_mm_popcnt_u64(present));
+    }
+    return filled;
+  }
+
+  uint64_t ByteRleAVX512::unpackBooleans(const unsigned char* bits, uint64_t bitOffset,
+                                         char* data, uint64_t numValues, const char* notNull) {
+    const __m512i one = _mm512_set1_epi8(1);
+    uint64_t ones = 0;
+    for (uint64_t position = 0; position < numValues; position += 64) {
+      __mmask64 lanes = laneMask(numValues - position);
+      __mmask64 present = lanes;
+      if (notNull) {
+        __m512i mask = _mm512_maskz_loadu_epi8(lanes, notNull + position);
+        present = _mm512_test_epi8_mask(mask, mask);
+      }
+      // deposit the next bits into the present lanes
+      uint64_t values = _pdep_u64(loadBits(bits, bitOffset), present);
+      _mm512_mask_storeu_epi8(data + position, lanes, _mm512_maskz_mov_epi8(values, one));
+      bitOffset += static_cast<uint64_t>(_mm_popcnt_u64(present));
+      ones += static_cast<uint64_t>(_mm_popcnt_u64(values));
+    }
+    return ones;
+  }
+
+}  // namespace orc
@@ -0,0 +1,44 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef ORC_BYTERLE_AVX512_HH
+#define ORC_BYTERLE_AVX512_HH
+
+#include <cstdint>
+
+namespace orc {
+
+  /**
+   * The AVX-512 versions of the kernels in ByteRleDefault. The bits are
+   * deposited into the present positions with pdep and expanded to bytes
+   * from the resulting mask, 64 values at a time.
+   */
+  class ByteRleAVX512 {
+   public:
+    static uint64_t countNonZero(const char* data, uint64_t numValues);
+
+    static uint64_t fillRun(char* data, char value, uint64_t numValues, const char* notNull);
+
+    static uint64_t unpackBooleans(const unsigned char* bits, uint64_t bitOffset, char* data,
+                                   uint64_t numValues, const char* notNull);
+  };
+
+}  // namespace orc
+
+#endif
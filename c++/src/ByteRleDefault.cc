@@ -0,0 +1,116 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "ByteRleDefault.hh"
+
+#include <string.h>
+
+namespace orc {
+
+  namespace {
+    // the expansion of each byte into one byte per bit, most significant bit first
+    struct BitExpansion {
+      char bytes[256][8];
+      uint8_t ones[256];
+
+      BitExpansion() {
+        for (int value = 0; value < 256; ++value) {
+          ones[value] = 0;
+          for (int bit = 0; bit < 8; ++bit) {
+            bytes[value][bit] = static_cast<char>((value >> (7 - bit)) & 0x1);
+            ones[value] = static_cast<uint8_t>(ones[value] + bytes[value][bit]);
+          }
+        }
+      }
+    };
+
+    const BitExpansion& getBitExpansion() {
+      static const BitExpansion expansion;
+      return expansion;
+    }
+  }  // namespace
+
+  uint64_t ByteRleDefault::countNonZero(const char* data, uint64_t numValues) {
+    uint64_t count = 0;
+    for (uint64_t i = 0; i < numValues; ++i) {
+      count += data[i] != 0;
+    }
+    return count;
+  }
+
+  uint64_t ByteRleDefault::countBits(const unsigned char* data, uint64_t numBytes) {
+    const uint8_t* ones = getBitExpansion().ones;
+    uint64_t count = 0;
+    for (uint64_t i = 0; i < numBytes; ++i) {
+      count += ones[data[i]];
+    }
+    return count;
+  }
+
+  uint64_t ByteRleDefault::fillRun(char* data, char value, uint64_t numValues,
+                                   const char* notNull) {
+    uint64_t filled = 0;
+    for (uint64_t i = 0; i < numValues; ++i) {
+      if (notNull[i]) {
+        data[i] = value;
+        filled += 1;
+      }
+    }
+    return filled;
+  }
+
+  uint64_t ByteRleDefault::unpackBooleans(const unsigned char* bits, uint64_t bitOffset,
+                                          char* data, uint64_t numValues, const char* notNull) {
+    uint64_t ones = 0;
+    uint64_t position = 0;
+    if (notNull) {
+      for (; position < numValues; ++position) {
+        if (notNull[position]) {
+          char value = static_cast<char>((bits[bitOffset / 8] >> (7 - bitOffset % 8)) & 0x1);
+          data[position] = value;
+          ones += static_cast<uint64_t>(value);
+          bitOffset += 1;
+        } else {
+          data[position] = 0;
+        }
+      }
+      return ones;
+    }
+
+    // use the bits up to the next byte boundary one at a time
+    for (; position < numValues && bitOffset % 8 != 0; ++position, ++bitOffset) {
+      char value = static_cast<char>((bits[bitOffset / 8] >> (7 - bitOffset % 8)) & 0x1);
+      data[position] = value;
+      ones += static_cast<uint64_t>(value);
+    }
+    // then expand whole bytes from the table
+    const BitExpansion& expansion = getBitExpansion();
+    const unsigned char* byte = bits + bitOffset / 8;
+    for (; numValues - position >= 8; position += 8, ++byte) {
+      memcpy(data + position, expansion.bytes[*byte], 8);
+      ones += expansion.ones[*byte];
+    }
+    for (uint64_t bit = 0; position < numValues; ++position, ++bit) {
+      data[position] = expansion.bytes[*byte][bit];
+      ones += static_cast<uint64_t>(data[position]);
+    }
+    return ones;
+  }
+
+}  // namespace orc
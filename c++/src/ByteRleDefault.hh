@@ -0,0 +1,64 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef ORC_BYTERLE_DEFAULT_HH
+#define ORC_BYTERLE_DEFAULT_HH
+
+#include <cstdint>
+
+namespace orc {
+
+  class ByteRleDefault {
+   public:
+    /**
+     * Count the bytes that are not zero.
+     */
+    static uint64_t countNonZero(const char* data, uint64_t numValues);
+
+    /**
+     * Count the bits that are set.
+     */
+    static uint64_t countBits(const unsigned char* data, uint64_t numBytes);
+
+    /**
+     * Set the positions that are true in notNull to the value of a run and
+     * leave the other positions alone.
+     * @return the number of positions that were set
+     */
+    static uint64_t fillRun(char* data, char value, uint64_t numValues, const char* notNull);
+
+    /**
+     * Expand booleans, stored as bits with the most significant bit first,
+     * into one byte per value. The positions that are false in notNull are
+     * set to 0 and do not consume a bit.
+     * @param bits the packed booleans, which must be readable for 8 bytes
+     *    after the last bit that is used
+     * @param bitOffset the index of the first bit to use
+     * @param data the array to expand into
+     * @param numValues the number of values to expand
+     * @param notNull if not null, the positions that hold a value
+     * @return the number of values that are true
+     */
+    static uint64_t unpackBooleans(const unsigned char* bits, uint64_t bitOffset, char* data,
+                                   uint64_t numValues, const char* notNull);
+  };
+
+}  // namespace orc
+
+#endif
@@ -24,9 +24,11 @@
 #include "ConvertColumnReader.hh"
 #include "RLE.hh"
 #include "SchemaEvolution.hh"
+#include "ThreadPool.hh"
 #include "orc/Exceptions.hh"
 
 #include <math.h>
+#include <algorithm>
 #include <iostream>
 
 namespace orc {
@@ -35,6 +37,14 @@ namespace orc {
     // PASS
   }
 
+  ThreadPool* StripeStreams::getDecodePool() const {
+    return nullptr;
+  }
+
+  MemoryPool& StripeStreams::getBatchMemoryPool() const {
+    return getMemoryPool();
+  }
+
   inline RleVersion convertRleVersion(proto::ColumnEncoding_Kind kind) {
     switch (static_cast<int64_t>(kind)) {
       case proto::ColumnEncoding_Kind_DIRECT:
@@ -52,36 +62,28 @@ namespace orc {
       : columnId(type.getColumnId()),
         memoryPool(stripe.getMemoryPool()),
         metrics(stripe.getReaderMetrics()) {
+    ColumnReader::rebind(stripe);
+  }
+
+  ColumnReader::~ColumnReader() {
+    // PASS
+  }
+
+  void ColumnReader::rebind(StripeStreams& stripe) {
     std::unique_ptr<SeekableInputStream> stream =
         stripe.getStream(columnId, proto::Stream_Kind_PRESENT, true);
     if (stream.get()) {
       notNullDecoder = createBooleanRleDecoder(std::move(stream), metrics);
+    } else {
+      notNullDecoder.reset();
     }
   }
 
-  ColumnReader::~ColumnReader() {
-    // PASS
-  }
-
   uint64_t ColumnReader::skip(uint64_t numValues) {
     ByteRleDecoder* decoder = notNullDecoder.get();
     if (decoder) {
-      // page through the values that we want to skip
-      // and count how many are non-null
-      const size_t MAX_BUFFER_SIZE = 32768;
-      size_t bufferSize = std::min(MAX_BUFFER_SIZE, static_cast<size_t>(numValues));
-      char buffer[MAX_BUFFER_SIZE];
-      uint64_t remaining = numValues;
-      while (remaining > 0) {
-        uint64_t chunkSize = std::min(remaining, static_cast<uint64_t>(bufferSize));
-        decoder->next(buffer, chunkSize, nullptr);
-        remaining -= chunkSize;
-        for (uint64_t i = 0; i < chunkSize; ++i) {
-          if (!buffer[i]) {
-            numValues -= 1;
-          }
-        }
-      }
+      // count the non-null values from the runs of the present stream
+      numValues = decoder->skipAndCount(numValues);
     }
     return numValues;
   }
@@ -94,13 +96,10 @@ namespace orc {
     ByteRleDecoder* decoder = notNullDecoder.get();
     if (decoder) {
       char* notNullArray = rowBatch.notNull.data();
-      decoder->next(notNullArray, numValues, incomingMask);
-      // check to see if there are nulls in this batch
-      for (uint64_t i = 0; i < numValues; ++i) {
-        if (!notNullArray[i]) {
-          rowBatch.hasNulls = true;
-          return;
-        }
+      // there are nulls in this batch unless every value is present
+      if (decoder->nextAndCount(notNullArray, numValues, incomingMask) < numValues) {
+        rowBatch.hasNulls = true;
+        return;
       }
     } else if (incomingMask) {
       // If we don't have a notNull stream, copy the incomingMask
@@ -111,6 +110,203 @@ namespace orc {
     rowBatch.hasNulls = false;
   }
 
+  // Move the selected values to the start of the array.
+  template <typename T>
+  static void compactValues(T* values, const char* selected, uint64_t numValues) {
+    uint64_t count = 0;
+    for (uint64_t i = 0; i < numValues; ++i) {
+      if (selected[i]) {
+        values[count++] = values[i];
+      }
+    }
+  }
+
+  // Select the children of the kept rows of a list or map and rewrite the offsets.
+  static void compactOffsets(int64_t* offsets, const char* selected, uint64_t numValues,
+                             DataBuffer<char>& childSelected) {
+    childSelected.resizeUninitialized(static_cast<uint64_t>(offsets[numValues]));
+    memset(childSelected.data(), 0, childSelected.size());
+    int64_t count = 0;
+    uint64_t kept = 0;
+    for (uint64_t i = 0; i < numValues; ++i) {
+      int64_t start = offsets[i];
+      int64_t end = offsets[i + 1];
+      memset(childSelected.data() + start, selected[i], static_cast<size_t>(end - start));
+      if (selected[i]) {
+        offsets[kept++] = count;
+        count += end - start;
+      }
+    }
+    offsets[kept] = count;
+  }
+
+  static void compactBatch(ColumnVectorBatch& batch, const char* selected);
+
+  // Keep the selected values of the child of a list or map, unless the child is not read.
+  static void compactChild(ColumnVectorBatch* child, const DataBuffer<char>& selected) {
+    if (child != nullptr && child->numElements == selected.size()) {
+      compactBatch(*child, selected.data());
+    }
+  }
+
+  /**
+   * Keep the selected rows of a batch, moving them to its start.
+   */
+  static void compactBatch(ColumnVectorBatch& batch, const char* selected) {
+    uint64_t numValues = batch.numElements;
+    uint64_t count = 0;
+    for (uint64_t i = 0; i < numValues; ++i) {
+      count += selected[i] ? 1 : 0;
+    }
+    if (count == numValues) {
+      return;
+    }
+    if (batch.hasNulls) {
+      compactValues(batch.notNull.data(), selected, numValues);
+    }
+    if (auto longs = dynamic_cast<LongVectorBatch*>(&batch)) {
+      compactValues(longs->data.data(), selected, numValues);
+    } else if (auto ints = dynamic_cast<IntVectorBatch*>(&batch)) {
+      compactValues(ints->data.data(), selected, numValues);
+    } else if (auto shorts = dynamic_cast<ShortVectorBatch*>(&batch)) {
+      compactValues(shorts->data.data(), selected, numValues);
+    } else if (auto bytes = dynamic_cast<ByteVectorBatch*>(&batch)) {
+      compactValues(bytes->data.data(), selected, numValues);
+    } else if (auto doubles = dynamic_cast<DoubleVectorBatch*>(&batch)) {
+      compactValues(doubles->data.data(), selected, numValues);
+    } else if (auto floats = dynamic_cast<FloatVectorBatch*>(&batch)) {
+      compactValues(floats->data.data(), selected, numValues);
+    } else if (auto strings = dynamic_cast<StringVectorBatch*>(&batch)) {
+      compactValues(strings->data.data(), selected, numValues);
+      compactValues(strings->length.data(), selected, numValues);
+      if (auto encoded = dynamic_cast<EncodedStringVectorBatch*>(&batch)) {
+        compactValues(encoded->index.data(), selected, numValues);
+      }
+    } else if (auto decimals64 = dynamic_cast<Decimal64VectorBatch*>(&batch)) {
+      compactValues(decimals64->values.data(), selected, numValues);
+    } else if (auto decimals128 = dynamic_cast<Decimal128VectorBatch*>(&batch)) {
+      compactValues(decimals128->values.data(), selected, numValues);
+    } else if (auto timestamps = dynamic_cast<TimestampVectorBatch*>(&batch)) {
+      compactValues(timestamps->data.data(), selected, numValues);
+      compactValues(timestamps->nanoseconds.data(), selected, numValues);
+    } else if (auto structs = dynamic_cast<StructVectorBatch*>(&batch)) {
+      for (auto field : structs->fields) {
+        compactBatch(*field, selected);
+      }
+    } else if (auto lists = dynamic_cast<ListVectorBatch*>(&batch)) {
+      DataBuffer<char> childSelected(batch.memoryPool, 0);
+      compactOffsets(lists->offsets.data(), selected, numValues, childSelected);
+      compactChild(lists->elements.get(), childSelected);
+    } else if (auto maps = dynamic_cast<MapVectorBatch*>(&batch)) {
+      DataBuffer<char> childSelected(batch.memoryPool, 0);
+      compactOffsets(maps->offsets.data(), selected, numValues, childSelected);
+      compactChild(maps->keys.get(), childSelected);
+      compactChild(maps->elements.get(), childSelected);
+    } else if (auto unions = dynamic_cast<UnionVectorBatch*>(&batch)) {
+      std::vector<uint64_t> childCounts(unions->children.size(), 0);
+      for (size_t tag = 0; tag < unions->children.size(); ++tag) {
+        ColumnVectorBatch& child = *unions->children[tag];
+        DataBuffer<char> childSelected(batch.memoryPool, child.numElements);
+        memset(childSelected.data(), 0, child.numElements);
+        for (uint64_t i = 0; i < numValues; ++i) {
+          if (selected[i] && unions->tags[i] == tag) {
+            childSelected[unions->offsets[i]] = 1;
+          }
+        }
+        compactBatch(child, childSelected.data());
+      }
+      for (uint64_t i = 0; i < numValues; ++i) {
+        if (selected[i]) {
+          unions->offsets[i] = childCounts[unions->tags[i]]++;
+        }
+      }
+      compactValues(unions->tags.data(), selected, numValues);
+      compactValues(unions->offsets.data(), selected, numValues);
+    } else {
+      throw NotImplementedYet("Row selection is not supported for " + batch.toString());
+    }
+    batch.numElements = count;
+  }
+
+  // Count the values that are not null among the given rows.
+  static uint64_t countNonNull(const char* notNull, uint64_t start, uint64_t end) {
+    if (notNull == nullptr) {
+      return end - start;
+    }
+    uint64_t count = 0;
+    for (uint64_t i = start; i < end; ++i) {
+      count += notNull[i] ? 1 : 0;
+    }
+    return count;
+  }
+
+  /**
+   * Read the selected runs of rows to the start of the batch and skip the
+   * values of the other runs. The present stream of all rows must be read
+   * into the batch already.
+   * @param readRun reads the values of count rows to the given position of
+   *           the batch, given the mask of the rows or nullptr
+   * @param skipRun skips the given number of non-null values
+   */
+  template <typename ReadRun, typename SkipRun>
+  static void readSelectedRuns(ColumnVectorBatch& rowBatch, uint64_t numValues,
+                               const char* selected, ReadRun readRun, SkipRun skipRun) {
+    char* notNull = rowBatch.hasNulls ? rowBatch.notNull.data() : nullptr;
+    uint64_t output = 0;
+    uint64_t row = 0;
+    while (row < numValues) {
+      uint64_t end = row + 1;
+      while (end < numValues && (selected[end] != 0) == (selected[row] != 0)) {
+        ++end;
+      }
+      if (selected[row]) {
+        readRun(output, end - row, notNull == nullptr ? nullptr : notNull + row);
+        if (notNull != nullptr) {
+          memmove(notNull + output, notNull + row, end - row);
+        }
+        output += end - row;
+      } else {
+        uint64_t count = countNonNull(notNull, row, end);
+        if (count > 0) {
+          skipRun(count);
+        }
+      }
+      row = end;
+    }
+    rowBatch.numElements = output;
+    if (notNull != nullptr) {
+      rowBatch.hasNulls = countNonNull(notNull, 0, output) < output;
+    }
+  }
+
+  void ColumnReader::nextSelected(ColumnVectorBatch& rowBatch, uint64_t numValues, char* notNull,
+                                  const char* selected) {
+    // decode the rows from the first to the last selected one and skip the others
+    uint64_t start = 0;
+    while (start < numValues && !selected[start]) {
+      ++start;
+    }
+    uint64_t end = numValues;
+    while (end > start && !selected[end - 1]) {
+      --end;
+    }
+    uint64_t skipped = countNonNull(notNull, 0, start);
+    if (skipped > 0) {
+      skip(skipped);
+    }
+    if (start < end) {
+      next(rowBatch, end - start, notNull == nullptr ? nullptr : notNull + start);
+      compactBatch(rowBatch, selected + start);
+    } else {
+      rowBatch.numElements = 0;
+      rowBatch.hasNulls = false;
+    }
+    skipped = countNonNull(notNull, end, numValues);
+    if (skipped > 0) {
+      skip(skipped);
+    }
+  }
+
   void ColumnReader::seekToRowGroup(std::unordered_map<uint64_t, PositionProvider>& positions) {
     if (notNullDecoder.get()) {
       notNullDecoder->seek(positions.at(columnId));
@@ -135,6 +331,26 @@ namespace orc {
     }
   }
 
+  /**
+   * Read the selected runs of a byte or boolean column. The runs are decoded
+   * into a byte buffer and widened into the batch.
+   */
+  template <typename BatchType>
+  static void readSelectedBytes(ByteRleDecoder& rle, BatchType& batch, uint64_t numValues,
+                                const char* selected) {
+    DataBuffer<char> bytes(batch.memoryPool, numValues);
+    auto* ptr = batch.data.data();
+    readSelectedRuns(
+        batch, numValues, selected,
+        [&rle, &bytes, ptr](uint64_t output, uint64_t count, char* runNotNull) {
+          rle.next(bytes.data(), count, runNotNull);
+          for (uint64_t i = 0; i < count; ++i) {
+            ptr[output + i] = static_cast<int8_t>(bytes[i]);
+          }
+        },
+        [&rle](uint64_t count) { rle.skip(count); });
+  }
+
   template <typename BatchType>
   class BooleanColumnReader : public ColumnReader {
    private:
@@ -144,20 +360,25 @@ namespace orc {
     BooleanColumnReader(const Type& type, StripeStreams& stipe);
     ~BooleanColumnReader() override;
 
+    void rebind(StripeStreams& stripe) override;
+
     uint64_t skip(uint64_t numValues) override;
 
     void next(ColumnVectorBatch& rowBatch, uint64_t numValues, char* notNull) override;
 
+    void nextSelected(ColumnVectorBatch& rowBatch, uint64_t numValues, char* notNull,
+                      const char* selected) override;
+
     void seekToRowGroup(std::unordered_map<uint64_t, PositionProvider>& positions) override;
+
+   private:
+    void openStreams(StripeStreams& stripe);
   };
 
   template <typename BatchType>
   BooleanColumnReader<BatchType>::BooleanColumnReader(const Type& type, StripeStreams& stripe)
       : ColumnReader(type, stripe) {
-    std::unique_ptr<SeekableInputStream> stream =
-        stripe.getStream(columnId, proto::Stream_Kind_DATA, true);
-    if (stream == nullptr) throw ParseError("DATA stream not found in Boolean column");
-    rle = createBooleanRleDecoder(std::move(stream), metrics);
+    openStreams(stripe);
   }
 
   template <typename BatchType>
@@ -165,6 +386,20 @@ namespace orc {
     // PASS
   }
 
+  template <typename BatchType>
+  void BooleanColumnReader<BatchType>::rebind(StripeStreams& stripe) {
+    ColumnReader::rebind(stripe);
+    openStreams(stripe);
+  }
+
+  template <typename BatchType>
+  void BooleanColumnReader<BatchType>::openStreams(StripeStreams& stripe) {
+    std::unique_ptr<SeekableInputStream> stream =
+        stripe.getStream(columnId, proto::Stream_Kind_DATA, true);
+    if (stream == nullptr) throw ParseError("DATA stream not found in Boolean column");
+    rle = createBooleanRleDecoder(std::move(stream), metrics);
+  }
+
   template <typename BatchType>
   uint64_t BooleanColumnReader<BatchType>::skip(uint64_t numValues) {
     numValues = ColumnReader::skip(numValues);
@@ -185,6 +420,14 @@ namespace orc {
     expandBytesToIntegers(ptr, numValues);
   }
 
+  template <typename BatchType>
+  void BooleanColumnReader<BatchType>::nextSelected(ColumnVectorBatch& rowBatch,
+                                                    uint64_t numValues, char* notNull,
+                                                    const char* selected) {
+    ColumnReader::next(rowBatch, numValues, notNull);
+    readSelectedBytes(*rle, dynamic_cast<BatchType&>(rowBatch), numValues, selected);
+  }
+
   template <typename BatchType>
   void BooleanColumnReader<BatchType>::seekToRowGroup(
       std::unordered_map<uint64_t, PositionProvider>& positions) {
@@ -199,14 +442,16 @@ namespace orc {
 
    public:
     ByteColumnReader(const Type& type, StripeStreams& stripe) : ColumnReader(type, stripe) {
-      std::unique_ptr<SeekableInputStream> stream =
-          stripe.getStream(columnId, proto::Stream_Kind_DATA, true);
-      if (stream == nullptr) throw ParseError("DATA stream not found in Byte column");
-      rle = createByteRleDecoder(std::move(stream), metrics);
+      openStreams(stripe);
     }
 
     ~ByteColumnReader() override = default;
 
+    void rebind(StripeStreams& stripe) override {
+      ColumnReader::rebind(stripe);
+      openStreams(stripe);
+    }
+
     uint64_t skip(uint64_t numValues) override {
       numValues = ColumnReader::skip(numValues);
       rle->skip(numValues);
@@ -223,10 +468,24 @@ namespace orc {
       expandBytesToIntegers(ptr, numValues);
     }
 
+    void nextSelected(ColumnVectorBatch& rowBatch, uint64_t numValues, char* notNull,
+                      const char* selected) override {
+      ColumnReader::next(rowBatch, numValues, notNull);
+      readSelectedBytes(*rle, dynamic_cast<BatchType&>(rowBatch), numValues, selected);
+    }
+
     void seekToRowGroup(std::unordered_map<uint64_t, PositionProvider>& positions) override {
       ColumnReader::seekToRowGroup(positions);
       rle->seek(positions.at(columnId));
     }
+
+   private:
+    void openStreams(StripeStreams& stripe) {
+      std::unique_ptr<SeekableInputStream> stream =
+          stripe.getStream(columnId, proto::Stream_Kind_DATA, true);
+      if (stream == nullptr) throw ParseError("DATA stream not found in Byte column");
+      rle = createByteRleDecoder(std::move(stream), metrics);
+    }
   };
 
   template <typename BatchType>
@@ -236,17 +495,18 @@ namespace orc {
 
    public:
     IntegerColumnReader(const Type& type, StripeStreams& stripe) : ColumnReader(type, stripe) {
-      RleVersion vers = convertRleVersion(stripe.getEncoding(columnId).kind());
-      std::unique_ptr<SeekableInputStream> stream =
-          stripe.getStream(columnId, proto::Stream_Kind_DATA, true);
-      if (stream == nullptr) throw ParseError("DATA stream not found in Integer column");
-      rle = createRleDecoder(std::move(stream), true, vers, memoryPool, metrics);
+      openStreams(stripe);
     }
 
     ~IntegerColumnReader() override {
       // PASS
     }
 
+    void rebind(StripeStreams& stripe) override {
+      ColumnReader::rebind(stripe);
+      openStreams(stripe);
+    }
+
     uint64_t skip(uint64_t numValues) override {
       numValues = ColumnReader::skip(numValues);
       rle->skip(numValues);
@@ -259,10 +519,31 @@ namespace orc {
                 rowBatch.hasNulls ? rowBatch.notNull.data() : nullptr);
     }
 
+    void nextSelected(ColumnVectorBatch& rowBatch, uint64_t numValues, char* notNull,
+                      const char* selected) override {
+      ColumnReader::next(rowBatch, numValues, notNull);
+      auto* data = dynamic_cast<BatchType&>(rowBatch).data.data();
+      readSelectedRuns(
+          rowBatch, numValues, selected,
+          [this, data](uint64_t output, uint64_t count, char* runNotNull) {
+            rle->next(data + output, count, runNotNull);
+          },
+          [this](uint64_t count) { rle->skip(count); });
+    }
+
     void seekToRowGroup(std::unordered_map<uint64_t, PositionProvider>& positions) override {
       ColumnReader::seekToRowGroup(positions);
       rle->seek(positions.at(columnId));
     }
+
+   private:
+    void openStreams(StripeStreams& stripe) {
+      RleVersion vers = convertRleVersion(stripe.getEncoding(columnId).kind());
+      std::unique_ptr<SeekableInputStream> stream =
+          stripe.getStream(columnId, proto::Stream_Kind_DATA, true);
+      if (stream == nullptr) throw ParseError("DATA stream not found in Integer column");
+      rle = createRleDecoder(std::move(stream), true, vers, memoryPool, metrics);
+    }
   };
 
   class TimestampColumnReader : public ColumnReader {
@@ -278,13 +559,25 @@ namespace orc {
     TimestampColumnReader(const Type& type, StripeStreams& stripe, bool isInstantType);
     ~TimestampColumnReader() override;
 
+    void rebind(StripeStreams& stripe) override;
+
     uint64_t skip(uint64_t numValues) override;
 
     void next(ColumnVectorBatch& rowBatch, uint64_t numValues, char* notNull) override;
 
     void seekToRowGroup(std::unordered_map<uint64_t, PositionProvider>& positions) override;
+
+   private:
+    // the factor for the stored nanoseconds, indexed by their low 3 bits
+    static const int64_t NANO_SCALE[8];
+
+    void openStreams(StripeStreams& stripe);
+    bool getBatchOffset(int64_t minTime, int64_t maxTime, int64_t& offset) const;
   };
 
+  const int64_t TimestampColumnReader::NANO_SCALE[8] = {
+      1, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000};
+
   TimestampColumnReader::TimestampColumnReader(const Type& type, StripeStreams& stripe,
                                                bool isInstantType)
       : ColumnReader(type, stripe),
@@ -292,6 +585,20 @@ namespace orc {
         readerTimezone(isInstantType ? getTimezoneByName("GMT") : stripe.getReaderTimezone()),
         epochOffset(writerTimezone.getEpoch()),
         sameTimezone(&writerTimezone == &readerTimezone) {
+    openStreams(stripe);
+  }
+
+  TimestampColumnReader::~TimestampColumnReader() {
+    // PASS
+  }
+
+  void TimestampColumnReader::rebind(StripeStreams& stripe) {
+    // the stripes that a reader is moved to have the same writer timezone
+    ColumnReader::rebind(stripe);
+    openStreams(stripe);
+  }
+
+  void TimestampColumnReader::openStreams(StripeStreams& stripe) {
     RleVersion vers = convertRleVersion(stripe.getEncoding(columnId).kind());
     std::unique_ptr<SeekableInputStream> stream =
         stripe.getStream(columnId, proto::Stream_Kind_DATA, true);
@@ -302,10 +609,6 @@ namespace orc {
     nanoRle = createRleDecoder(std::move(stream), false, vers, memoryPool, metrics);
   }
 
-  TimestampColumnReader::~TimestampColumnReader() {
-    // PASS
-  }
-
   uint64_t TimestampColumnReader::skip(uint64_t numValues) {
     numValues = ColumnReader::skip(numValues);
     secondsRle->skip(numValues);
@@ -323,35 +626,80 @@ namespace orc {
     nanoRle->next(nanoBuffer, numValues, notNull);
 
     // Construct the values
+    int64_t minTime = INT64_MAX;
+    int64_t maxTime = INT64_MIN;
     for (uint64_t i = 0; i < numValues; i++) {
       if (notNull == nullptr || notNull[i]) {
-        uint64_t zeros = nanoBuffer[i] & 0x7;
-        nanoBuffer[i] >>= 3;
-        if (zeros != 0) {
-          for (uint64_t j = 0; j <= zeros; ++j) {
-            nanoBuffer[i] *= 10;
+        nanoBuffer[i] = (nanoBuffer[i] >> 3) * NANO_SCALE[nanoBuffer[i] & 0x7];
+        secsBuffer[i] += epochOffset;
+        minTime = std::min(minTime, secsBuffer[i]);
+        maxTime = std::max(maxTime, secsBuffer[i]);
+      }
+    }
+    if (!sameTimezone && minTime <= maxTime) {
+      int64_t offset;
+      if (getBatchOffset(minTime, maxTime, offset)) {
+        if (offset != 0) {
+          for (uint64_t i = 0; i < numValues; i++) {
+            if (notNull == nullptr || notNull[i]) {
+              secsBuffer[i] += offset;
+            }
           }
         }
-        int64_t writerTime = secsBuffer[i] + epochOffset;
-        if (!sameTimezone) {
-          // adjust timestamp value to same wall clock time if writer and reader
-          // time zones have different rules, which is required for Apache Orc.
-          const auto& wv = writerTimezone.getVariant(writerTime);
-          const auto& rv = readerTimezone.getVariant(writerTime);
-          if (!wv.hasSameTzRule(rv)) {
-            // If the timezone adjustment moves the millis across a DST boundary,
-            // we need to reevaluate the offsets.
-            int64_t adjustedTime = writerTime + wv.gmtOffset - rv.gmtOffset;
-            const auto& adjustedReader = readerTimezone.getVariant(adjustedTime);
-            writerTime = writerTime + wv.gmtOffset - adjustedReader.gmtOffset;
+      } else {
+        for (uint64_t i = 0; i < numValues; i++) {
+          if (notNull == nullptr || notNull[i]) {
+            // adjust timestamp value to same wall clock time if writer and reader
+            // time zones have different rules, which is required for Apache Orc.
+            int64_t writerTime = secsBuffer[i];
+            const auto& wv = writerTimezone.getVariant(writerTime);
+            const auto& rv = readerTimezone.getVariant(writerTime);
+            if (!wv.hasSameTzRule(rv)) {
+              // If the timezone adjustment moves the millis across a DST boundary,
+              // we need to reevaluate the offsets.
+              int64_t adjustedTime = writerTime + wv.gmtOffset - rv.gmtOffset;
+              const auto& adjustedReader = readerTimezone.getVariant(adjustedTime);
+              secsBuffer[i] = writerTime + wv.gmtOffset - adjustedReader.gmtOffset;
+            }
           }
         }
-        secsBuffer[i] = writerTime;
-        if (secsBuffer[i] < 0 && nanoBuffer[i] > 999999) {
-          secsBuffer[i] -= 1;
-        }
       }
     }
+    for (uint64_t i = 0; i < numValues; i++) {
+      if ((notNull == nullptr || notNull[i]) && secsBuffer[i] < 0 && nanoBuffer[i] > 999999) {
+        secsBuffer[i] -= 1;
+      }
+    }
+  }
+
+  /**
+   * Get the offset that moves all of the times in [minTime, maxTime] from the
+   * writer to the reader timezone, when no transition of either timezone
+   * falls within the times.
+   * @return false if the offset differs between the times
+   */
+  bool TimestampColumnReader::getBatchOffset(int64_t minTime, int64_t maxTime,
+                                             int64_t& offset) const {
+    int64_t start, end;
+    const auto& wv = writerTimezone.getVariantRange(minTime, start, end);
+    if (maxTime > end) {
+      return false;
+    }
+    const auto& rv = readerTimezone.getVariantRange(minTime, start, end);
+    if (maxTime > end) {
+      return false;
+    }
+    if (wv.hasSameTzRule(rv)) {
+      offset = 0;
+      return true;
+    }
+    int64_t shift = wv.gmtOffset - rv.gmtOffset;
+    const auto& adjustedReader = readerTimezone.getVariantRange(minTime + shift, start, end);
+    if (maxTime + shift > end) {
+      return false;
+    }
+    offset = wv.gmtOffset - adjustedReader.gmtOffset;
+    return true;
   }
 
   void TimestampColumnReader::seekToRowGroup(
@@ -367,10 +715,15 @@ namespace orc {
     DoubleColumnReader(const Type& type, StripeStreams& stripe);
     ~DoubleColumnReader() override {}
 
+    void rebind(StripeStreams& stripe) override;
+
     uint64_t skip(uint64_t numValues) override;
 
     void next(ColumnVectorBatch& rowBatch, uint64_t numValues, char* notNull) override;
 
+    void nextSelected(ColumnVectorBatch& rowBatch, uint64_t numValues, char* notNull,
+                      const char* selected) override;
+
     void seekToRowGroup(std::unordered_map<uint64_t, PositionProvider>& positions) override;
 
    private:
@@ -379,6 +732,19 @@ namespace orc {
     const char* bufferPointer;
     const char* bufferEnd;
 
+    void openStreams(StripeStreams& stripe);
+
+    // skip the given number of non-null values
+    void skipValues(uint64_t numValues);
+
+    ValueType readValue() {
+      if constexpr (columnKind == FLOAT) {
+        return readFloat<ValueType>();
+      } else {
+        return readDouble<ValueType>();
+      }
+    }
+
     unsigned char readByte() {
       if (bufferPointer == bufferEnd) {
         int length;
@@ -445,16 +811,37 @@ namespace orc {
   template <TypeKind columnKind, bool isLittleEndian, typename ValueType, typename BatchType>
   DoubleColumnReader<columnKind, isLittleEndian, ValueType, BatchType>::DoubleColumnReader(
       const Type& type, StripeStreams& stripe)
-      : ColumnReader(type, stripe), bufferPointer(nullptr), bufferEnd(nullptr) {
+      : ColumnReader(type, stripe) {
+    openStreams(stripe);
+  }
+
+  template <TypeKind columnKind, bool isLittleEndian, typename ValueType, typename BatchType>
+  void DoubleColumnReader<columnKind, isLittleEndian, ValueType, BatchType>::rebind(
+      StripeStreams& stripe) {
+    ColumnReader::rebind(stripe);
+    openStreams(stripe);
+  }
+
+  template <TypeKind columnKind, bool isLittleEndian, typename ValueType, typename BatchType>
+  void DoubleColumnReader<columnKind, isLittleEndian, ValueType, BatchType>::openStreams(
+      StripeStreams& stripe) {
     inputStream = stripe.getStream(columnId, proto::Stream_Kind_DATA, true);
     if (inputStream == nullptr) throw ParseError("DATA stream not found in Double column");
+    bufferPointer = nullptr;
+    bufferEnd = nullptr;
   }
 
   template <TypeKind columnKind, bool isLittleEndian, typename ValueType, typename BatchType>
   uint64_t DoubleColumnReader<columnKind, isLittleEndian, ValueType, BatchType>::skip(
       uint64_t numValues) {
     numValues = ColumnReader::skip(numValues);
+    skipValues(numValues);
+    return numValues;
+  }
 
+  template <TypeKind columnKind, bool isLittleEndian, typename ValueType, typename BatchType>
+  void DoubleColumnReader<columnKind, isLittleEndian, ValueType, BatchType>::skipValues(
+      uint64_t numValues) {
     if (static_cast<size_t>(bufferEnd - bufferPointer) >= bytesPerValue * numValues) {
       bufferPointer += bytesPerValue * numValues;
     } else {
@@ -469,8 +856,6 @@ namespace orc {
       bufferEnd = nullptr;
       bufferPointer = nullptr;
     }
-
-    return numValues;
   }
 
   template <TypeKind columnKind, bool isLittleEndian, typename ValueType, typename BatchType>
@@ -519,6 +904,24 @@ namespace orc {
     }
   }
 
+  template <TypeKind columnKind, bool isLittleEndian, typename ValueType, typename BatchType>
+  void DoubleColumnReader<columnKind, isLittleEndian, ValueType, BatchType>::nextSelected(
+      ColumnVectorBatch& rowBatch, uint64_t numValues, char* notNull, const char* selected) {
+    ColumnReader::next(rowBatch, numValues, notNull);
+    ValueType* outArray =
+        reinterpret_cast<ValueType*>(dynamic_cast<BatchType&>(rowBatch).data.data());
+    readSelectedRuns(
+        rowBatch, numValues, selected,
+        [this, outArray](uint64_t output, uint64_t count, char* runNotNull) {
+          for (uint64_t i = 0; i < count; ++i) {
+            if (runNotNull == nullptr || runNotNull[i]) {
+              outArray[output + i] = readValue();
+            }
+          }
+        },
+        [this](uint64_t count) { skipValues(count); });
+  }
+
   template <TypeKind columnKind, bool isLittleEndian, typename ValueType, typename BatchType>
   void DoubleColumnReader<columnKind, isLittleEndian, ValueType, BatchType>::seekToRowGroup(
       std::unordered_map<uint64_t, PositionProvider>& positions) {
@@ -554,18 +957,43 @@ namespace orc {
     StringDictionaryColumnReader(const Type& type, StripeStreams& stipe);
     ~StringDictionaryColumnReader() override;
 
+    void rebind(StripeStreams& stripe) override;
+
     uint64_t skip(uint64_t numValues) override;
 
     void next(ColumnVectorBatch& rowBatch, uint64_t numValues, char* notNull) override;
 
     void nextEncoded(ColumnVectorBatch& rowBatch, uint64_t numValues, char* notNull) override;
 
+    void nextSelected(ColumnVectorBatch& rowBatch, uint64_t numValues, char* notNull,
+                      const char* selected) override;
+
     void seekToRowGroup(std::unordered_map<uint64_t, PositionProvider>& positions) override;
+
+   private:
+    void openStreams(StripeStreams& stripe);
   };
 
   StringDictionaryColumnReader::StringDictionaryColumnReader(const Type& type,
                                                              StripeStreams& stripe)
-      : ColumnReader(type, stripe), dictionary(new StringDictionary(stripe.getMemoryPool())) {
+      : ColumnReader(type, stripe), dictionary(new StringDictionary(stripe.getBatchMemoryPool())) {
+    openStreams(stripe);
+  }
+
+  StringDictionaryColumnReader::~StringDictionaryColumnReader() {
+    // PASS
+  }
+
+  void StringDictionaryColumnReader::rebind(StripeStreams& stripe) {
+    ColumnReader::rebind(stripe);
+    if (dictionary.use_count() > 1) {
+      // an encoded batch still refers to the dictionary of the previous stripe
+      dictionary = std::make_shared<StringDictionary>(stripe.getBatchMemoryPool());
+    }
+    openStreams(stripe);
+  }
+
+  void StringDictionaryColumnReader::openStreams(StripeStreams& stripe) {
     RleVersion rleVersion = convertRleVersion(stripe.getEncoding(columnId).kind());
     uint32_t dictSize = stripe.getEncoding(columnId).dictionary_size();
     std::unique_ptr<SeekableInputStream> stream =
@@ -600,10 +1028,6 @@ namespace orc {
     readFully(dictionary->dictionaryBlob.data(), blobSize, blobStream.get());
   }
 
-  StringDictionaryColumnReader::~StringDictionaryColumnReader() {
-    // PASS
-  }
-
   uint64_t StringDictionaryColumnReader::skip(uint64_t numValues) {
     numValues = ColumnReader::skip(numValues);
     rle->skip(numValues);
@@ -658,6 +1082,33 @@ namespace orc {
     rle->next(batch.index.data(), numValues, notNull);
   }
 
+  void StringDictionaryColumnReader::nextSelected(ColumnVectorBatch& rowBatch, uint64_t numValues,
+                                                  char* notNull, const char* selected) {
+    ColumnReader::next(rowBatch, numValues, notNull);
+    StringVectorBatch& byteBatch = dynamic_cast<StringVectorBatch&>(rowBatch);
+    char* blob = dictionary->dictionaryBlob.data();
+    int64_t* dictionaryOffsets = dictionary->dictionaryOffset.data();
+    char** outputStarts = byteBatch.data.data();
+    int64_t* outputLengths = byteBatch.length.data();
+    uint64_t dictionaryCount = dictionary->dictionaryOffset.size() - 1;
+    readSelectedRuns(
+        rowBatch, numValues, selected,
+        [&](uint64_t output, uint64_t count, char* runNotNull) {
+          rle->next(outputLengths + output, count, runNotNull);
+          for (uint64_t i = output; i < output + count; ++i) {
+            if (runNotNull == nullptr || runNotNull[i - output]) {
+              int64_t entry = outputLengths[i];
+              if (entry < 0 || static_cast<uint64_t>(entry) >= dictionaryCount) {
+                throw ParseError("Entry index out of range in StringDictionaryColumn");
+              }
+              outputStarts[i] = blob + dictionaryOffsets[entry];
+              outputLengths[i] = dictionaryOffsets[entry + 1] - dictionaryOffsets[entry];
+            }
+          }
+        },
+        [this](uint64_t count) { rle->skip(count); });
+  }
+
   void StringDictionaryColumnReader::seekToRowGroup(
       std::unordered_map<uint64_t, PositionProvider>& positions) {
     ColumnReader::seekToRowGroup(positions);
@@ -680,19 +1131,45 @@ namespace orc {
      */
     size_t computeSize(const int64_t* lengths, const char* notNull, uint64_t numValues);
 
+    // skip the lengths and the bytes of the given number of non-null values
+    void skipValues(uint64_t numValues);
+
+    // copy the next bytes of the blob stream
+    void readBlob(char* target, size_t length);
+
+    void openStreams(StripeStreams& stripe);
+
    public:
     StringDirectColumnReader(const Type& type, StripeStreams& stipe);
     ~StringDirectColumnReader() override;
 
+    void rebind(StripeStreams& stripe) override;
+
     uint64_t skip(uint64_t numValues) override;
 
     void next(ColumnVectorBatch& rowBatch, uint64_t numValues, char* notNull) override;
 
+    void nextSelected(ColumnVectorBatch& rowBatch, uint64_t numValues, char* notNull,
+                      const char* selected) override;
+
     void seekToRowGroup(std::unordered_map<uint64_t, PositionProvider>& positions) override;
   };
 
   StringDirectColumnReader::StringDirectColumnReader(const Type& type, StripeStreams& stripe)
       : ColumnReader(type, stripe) {
+    openStreams(stripe);
+  }
+
+  StringDirectColumnReader::~StringDirectColumnReader() {
+    // PASS
+  }
+
+  void StringDirectColumnReader::rebind(StripeStreams& stripe) {
+    ColumnReader::rebind(stripe);
+    openStreams(stripe);
+  }
+
+  void StringDirectColumnReader::openStreams(StripeStreams& stripe) {
     RleVersion rleVersion = convertRleVersion(stripe.getEncoding(columnId).kind());
     std::unique_ptr<SeekableInputStream> stream =
         stripe.getStream(columnId, proto::Stream_Kind_LENGTH, true);
@@ -704,13 +1181,14 @@ namespace orc {
     lastBufferLength = 0;
   }
 
-  StringDirectColumnReader::~StringDirectColumnReader() {
-    // PASS
+  uint64_t StringDirectColumnReader::skip(uint64_t numValues) {
+    numValues = ColumnReader::skip(numValues);
+    skipValues(numValues);
+    return numValues;
   }
 
-  uint64_t StringDirectColumnReader::skip(uint64_t numValues) {
+  void StringDirectColumnReader::skipValues(uint64_t numValues) {
     const size_t BUFFER_SIZE = 1024;
-    numValues = ColumnReader::skip(numValues);
     int64_t buffer[BUFFER_SIZE];
     uint64_t done = 0;
     size_t totalBytes = 0;
@@ -737,7 +1215,6 @@ namespace orc {
       lastBufferLength = 0;
       lastBuffer = nullptr;
     }
-    return numValues;
   }
 
   size_t StringDirectColumnReader::computeSize(const int64_t* lengths, const char* notNull,
@@ -772,13 +1249,34 @@ namespace orc {
     // figure out the total length of data we need from the blob stream
     const size_t totalLength = computeSize(lengthPtr, notNull, numValues);
 
+    byteBatch.blob.resizeUninitialized(totalLength);
+    readBlob(byteBatch.blob.data(), totalLength);
+
+    size_t filledSlots = 0;
+    char* ptr = byteBatch.blob.data();
+    if (notNull) {
+      while (filledSlots < numValues) {
+        if (notNull[filledSlots]) {
+          startPtr[filledSlots] = const_cast<char*>(ptr);
+          ptr += lengthPtr[filledSlots];
+        }
+        filledSlots += 1;
+      }
+    } else {
+      while (filledSlots < numValues) {
+        startPtr[filledSlots] = const_cast<char*>(ptr);
+        ptr += lengthPtr[filledSlots];
+        filledSlots += 1;
+      }
+    }
+  }
+
+  void StringDirectColumnReader::readBlob(char* target, size_t length) {
     // Load data from the blob stream into our buffer until we have enough
     // to get the rest directly out of the stream's buffer.
     size_t bytesBuffered = 0;
-    byteBatch.blob.resize(totalLength);
-    char* ptr = byteBatch.blob.data();
-    while (bytesBuffered + lastBufferLength < totalLength) {
-      memcpy(ptr + bytesBuffered, lastBuffer, lastBufferLength);
+    while (bytesBuffered + lastBufferLength < length) {
+      memcpy(target + bytesBuffered, lastBuffer, lastBufferLength);
       bytesBuffered += lastBufferLength;
       const void* readBuffer;
       int readLength;
@@ -789,28 +1287,39 @@ namespace orc {
       lastBufferLength = static_cast<size_t>(readLength);
     }
 
-    if (bytesBuffered < totalLength) {
-      size_t moreBytes = totalLength - bytesBuffered;
-      memcpy(ptr + bytesBuffered, lastBuffer, moreBytes);
+    if (bytesBuffered < length) {
+      size_t moreBytes = length - bytesBuffered;
+      memcpy(target + bytesBuffered, lastBuffer, moreBytes);
       lastBuffer += moreBytes;
       lastBufferLength -= moreBytes;
     }
+  }
 
-    size_t filledSlots = 0;
-    ptr = byteBatch.blob.data();
-    if (notNull) {
-      while (filledSlots < numValues) {
-        if (notNull[filledSlots]) {
-          startPtr[filledSlots] = const_cast<char*>(ptr);
-          ptr += lengthPtr[filledSlots];
-        }
-        filledSlots += 1;
-      }
-    } else {
-      while (filledSlots < numValues) {
-        startPtr[filledSlots] = const_cast<char*>(ptr);
-        ptr += lengthPtr[filledSlots];
-        filledSlots += 1;
+  void StringDirectColumnReader::nextSelected(ColumnVectorBatch& rowBatch, uint64_t numValues,
+                                              char* notNull, const char* selected) {
+    ColumnReader::next(rowBatch, numValues, notNull);
+    StringVectorBatch& byteBatch = dynamic_cast<StringVectorBatch&>(rowBatch);
+    int64_t* lengthPtr = byteBatch.length.data();
+    size_t blobLength = 0;
+    readSelectedRuns(
+        rowBatch, numValues, selected,
+        [&](uint64_t output, uint64_t count, char* runNotNull) {
+          lengthRle->next(lengthPtr + output, count, runNotNull);
+          size_t runLength = computeSize(lengthPtr + output, runNotNull, count);
+          byteBatch.blob.resizeUninitialized(blobLength + runLength);
+          readBlob(byteBatch.blob.data() + blobLength, runLength);
+          blobLength += runLength;
+        },
+        [this](uint64_t count) { skipValues(count); });
+
+    // the blob may have moved while it grew, so point to the values at the end
+    notNull = rowBatch.hasNulls ? rowBatch.notNull.data() : nullptr;
+    char** startPtr = byteBatch.data.data();
+    char* ptr = byteBatch.blob.data();
+    for (uint64_t i = 0; i < rowBatch.numElements; ++i) {
+      if (notNull == nullptr || notNull[i]) {
+        startPtr[i] = ptr;
+        ptr += lengthPtr[i];
       }
     }
   }
@@ -828,28 +1337,73 @@ namespace orc {
   class StructColumnReader : public ColumnReader {
    private:
     std::vector<std::unique_ptr<ColumnReader>> children;
+    // decodes groups of children concurrently, nullptr if they are decoded in order
+    ThreadPool* decodePool;
+    // the index of the first child of each group and the number of children at the end
+    std::vector<size_t> groupStarts;
+    // the rows of the batch that the row filter selects
+    DataBuffer<char> selectedRows;
 
    public:
     StructColumnReader(const Type& type, StripeStreams& stripe, bool useTightNumericVector = false,
                        bool throwOnSchemaEvolutionOverflow = false);
 
+    void rebind(StripeStreams& stripe) override;
+
     uint64_t skip(uint64_t numValues) override;
 
     void next(ColumnVectorBatch& rowBatch, uint64_t numValues, char* notNull) override;
 
     void nextEncoded(ColumnVectorBatch& rowBatch, uint64_t numValues, char* notNull) override;
 
+    void nextSelected(ColumnVectorBatch& rowBatch, uint64_t numValues, char* notNull,
+                      const char* selected) override;
+
     void seekToRowGroup(std::unordered_map<uint64_t, PositionProvider>& positions) override;
 
+    /**
+     * Read the next group of rows, keeping the rows that the filter selects.
+     * @return the number of selected rows
+     */
+    uint64_t nextFiltered(ColumnVectorBatch& rowBatch, uint64_t numValues,
+                          const std::vector<bool>& filterFields, const RowFilter& filter);
+
    private:
     template <bool encoded>
     void nextInternal(ColumnVectorBatch& rowBatch, uint64_t numValues, char* notNull);
+
+    // call decode with the index of each child, concurrently for the groups
+    void forEachChild(const std::function<void(size_t)>& decode);
+
+    void planGroups(const Type& type, const std::vector<bool>& selectedColumns);
   };
 
+  // The relative cost of decoding a column and its selected sub-columns.
+  static uint64_t getDecodeWeight(const Type& type, const std::vector<bool>& selectedColumns) {
+    uint64_t weight = 0;
+    for (uint64_t i = type.getColumnId(); i <= type.getMaximumColumnId(); ++i) {
+      weight += selectedColumns[i] ? 1 : 0;
+    }
+    switch (static_cast<int64_t>(type.getKind())) {
+      case STRING:
+      case VARCHAR:
+      case CHAR:
+      case BINARY:
+      case DECIMAL:
+      case TIMESTAMP:
+      case TIMESTAMP_INSTANT:
+        return weight * 2;
+      default:
+        return weight;
+    }
+  }
+
   StructColumnReader::StructColumnReader(const Type& type, StripeStreams& stripe,
                                          bool useTightNumericVector,
                                          bool throwOnSchemaEvolutionOverflow)
-      : ColumnReader(type, stripe) {
+      : ColumnReader(type, stripe),
+        decodePool(stripe.getDecodePool()),
+        selectedRows(memoryPool, 0) {
     // count the number of selected sub-columns
     const std::vector<bool> selectedColumns = stripe.getSelectedColumns();
     switch (static_cast<int64_t>(stripe.getEncoding(columnId).kind())) {
@@ -868,6 +1422,45 @@ namespace orc {
       default:
         throw ParseError("Unknown encoding for StructColumnReader");
     }
+    if (decodePool != nullptr) {
+      planGroups(type, selectedColumns);
+    }
+  }
+
+  void StructColumnReader::rebind(StripeStreams& stripe) {
+    ColumnReader::rebind(stripe);
+    for (auto& child : children) {
+      child->rebind(stripe);
+    }
+  }
+
+  void StructColumnReader::planGroups(const Type& type, const std::vector<bool>& selectedColumns) {
+    std::vector<uint64_t> weights;
+    uint64_t totalWeight = 0;
+    for (uint64_t i = 0; i < type.getSubtypeCount(); ++i) {
+      const Type& child = *type.getSubtype(i);
+      if (selectedColumns[child.getColumnId()]) {
+        weights.push_back(getDecodeWeight(child, selectedColumns));
+        totalWeight += weights.back();
+      }
+    }
+    // aim for two tasks per thread, but keep the narrow columns together
+    uint64_t taskCount = 2 * decodePool->getThreadCount();
+    uint64_t targetWeight = std::max<uint64_t>((totalWeight + taskCount - 1) / taskCount, 2);
+    uint64_t groupWeight = 0;
+    for (size_t i = 0; i < weights.size(); ++i) {
+      if (i == 0 || groupWeight >= targetWeight) {
+        groupStarts.push_back(i);
+        groupWeight = 0;
+      }
+      groupWeight += weights[i];
+    }
+    groupStarts.push_back(weights.size());
+    if (groupStarts.size() <= 2) {
+      // a single task gains nothing over decoding in order
+      decodePool = nullptr;
+      groupStarts.clear();
+    }
   }
 
   uint64_t StructColumnReader::skip(uint64_t numValues) {
@@ -891,16 +1484,103 @@ namespace orc {
   void StructColumnReader::nextInternal(ColumnVectorBatch& rowBatch, uint64_t numValues,
                                         char* notNull) {
     ColumnReader::next(rowBatch, numValues, notNull);
-    uint64_t i = 0;
     notNull = rowBatch.hasNulls ? rowBatch.notNull.data() : nullptr;
-    for (auto iter = children.begin(); iter != children.end(); ++iter, ++i) {
+    StructVectorBatch& batch = dynamic_cast<StructVectorBatch&>(rowBatch);
+    forEachChild([this, &batch, numValues, notNull](size_t i) {
       if (encoded) {
-        (*iter)->nextEncoded(*(dynamic_cast<StructVectorBatch&>(rowBatch).fields[i]), numValues,
-                             notNull);
+        children[i]->nextEncoded(*batch.fields[i], numValues, notNull);
       } else {
-        (*iter)->next(*(dynamic_cast<StructVectorBatch&>(rowBatch).fields[i]), numValues, notNull);
+        children[i]->next(*batch.fields[i], numValues, notNull);
+      }
+    });
+  }
+
+  void StructColumnReader::forEachChild(const std::function<void(size_t)>& decode) {
+    if (decodePool == nullptr) {
+      for (size_t i = 0; i < children.size(); ++i) {
+        decode(i);
       }
+      return;
     }
+    std::vector<std::function<void()>> tasks;
+    for (size_t group = 0; group + 1 < groupStarts.size(); ++group) {
+      size_t begin = groupStarts[group];
+      size_t end = groupStarts[group + 1];
+      tasks.push_back([&decode, begin, end]() {
+        for (size_t i = begin; i < end; ++i) {
+          decode(i);
+        }
+      });
+    }
+    decodePool->run(tasks);
+  }
+
+  void StructColumnReader::nextSelected(ColumnVectorBatch& rowBatch, uint64_t numValues,
+                                        char* notNull, const char* selected) {
+    ColumnReader::next(rowBatch, numValues, notNull);
+    notNull = rowBatch.hasNulls ? rowBatch.notNull.data() : nullptr;
+    StructVectorBatch& batch = dynamic_cast<StructVectorBatch&>(rowBatch);
+    forEachChild([this, &batch, numValues, notNull, selected](size_t i) {
+      children[i]->nextSelected(*batch.fields[i], numValues, notNull, selected);
+    });
+    uint64_t count = 0;
+    for (uint64_t i = 0; i < numValues; ++i) {
+      count += selected[i] ? 1 : 0;
+    }
+    if (notNull != nullptr) {
+      compactValues(notNull, selected, numValues);
+      rowBatch.hasNulls = countNonNull(notNull, 0, count) < count;
+    }
+    rowBatch.numElements = count;
+  }
+
+  uint64_t StructColumnReader::nextFiltered(ColumnVectorBatch& rowBatch, uint64_t numValues,
+                                            const std::vector<bool>& filterFields,
+                                            const RowFilter& filter) {
+    ColumnReader::next(rowBatch, numValues, nullptr);
+    char* notNull = rowBatch.hasNulls ? rowBatch.notNull.data() : nullptr;
+    StructVectorBatch& batch = dynamic_cast<StructVectorBatch&>(rowBatch);
+    forEachChild([this, &batch, numValues, notNull, &filterFields](size_t i) {
+      if (filterFields[i]) {
+        children[i]->next(*batch.fields[i], numValues, notNull);
+      }
+    });
+    selectedRows.resizeUninitialized(numValues);
+    char* selected = selectedRows.data();
+    memset(selected, 1, numValues);
+    filter(batch, selected);
+
+    // late materialization of the fields that the filter does not read
+    forEachChild([this, &batch, numValues, notNull, selected, &filterFields](size_t i) {
+      if (!filterFields[i]) {
+        children[i]->nextSelected(*batch.fields[i], numValues, notNull, selected);
+      }
+    });
+    uint64_t count = 0;
+    for (uint64_t i = 0; i < numValues; ++i) {
+      count += selected[i] ? 1 : 0;
+    }
+    if (count < numValues) {
+      for (size_t i = 0; i < children.size(); ++i) {
+        if (filterFields[i]) {
+          compactBatch(*batch.fields[i], selected);
+        }
+      }
+      if (notNull != nullptr) {
+        compactValues(notNull, selected, numValues);
+      }
+      batch.numElements = count;
+    }
+    return count;
+  }
+
+  uint64_t nextFiltered(ColumnReader& reader, ColumnVectorBatch& rowBatch, uint64_t numValues,
+                        const std::vector<bool>& filterFields, const RowFilter& filter) {
+    auto structReader = dynamic_cast<StructColumnReader*>(&reader);
+    if (structReader == nullptr) {
+      throw std::logic_error("Row filters need a struct as the selected type");
+    }
+    return structReader->nextFiltered(rowBatch, numValues, filterFields, filter);
   }
 
   void StructColumnReader::seekToRowGroup(
@@ -922,6 +1602,8 @@ namespace orc {
                      bool throwOnSchemaEvolutionOverflow = false);
     ~ListColumnReader() override;
 
+    void rebind(StripeStreams& stripe) override;
+
     uint64_t skip(uint64_t numValues) override;
 
     void next(ColumnVectorBatch& rowBatch, uint64_t numValues, char* notNull) override;
@@ -933,6 +1615,8 @@ namespace orc {
    private:
     template <bool encoded>
     void nextInternal(ColumnVectorBatch& rowBatch, uint64_t numValues, char* notNull);
+
+    void openStreams(StripeStreams& stripe);
   };
 
   ListColumnReader::ListColumnReader(const Type& type, StripeStreams& stripe,
@@ -941,11 +1625,7 @@ namespace orc {
       : ColumnReader(type, stripe) {
     // count the number of selected sub-columns
     const std::vector<bool> selectedColumns = stripe.getSelectedColumns();
-    RleVersion vers = convertRleVersion(stripe.getEncoding(columnId).kind());
-    std::unique_ptr<SeekableInputStream> stream =
-        stripe.getStream(columnId, proto::Stream_Kind_LENGTH, true);
-    if (stream == nullptr) throw ParseError("LENGTH stream not found in List column");
-    rle = createRleDecoder(std::move(stream), false, vers, memoryPool, metrics);
+    openStreams(stripe);
     const Type& childType = *type.getSubtype(0);
     if (selectedColumns[static_cast<uint64_t>(childType.getColumnId())]) {
       child = buildReader(childType, stripe, useTightNumericVector, throwOnSchemaEvolutionOverflow);
@@ -956,6 +1636,22 @@ namespace orc {
     // PASS
   }
 
+  void ListColumnReader::rebind(StripeStreams& stripe) {
+    ColumnReader::rebind(stripe);
+    openStreams(stripe);
+    if (child) {
+      child->rebind(stripe);
+    }
+  }
+
+  void ListColumnReader::openStreams(StripeStreams& stripe) {
+    RleVersion vers = convertRleVersion(stripe.getEncoding(columnId).kind());
+    std::unique_ptr<SeekableInputStream> stream =
+        stripe.getStream(columnId, proto::Stream_Kind_LENGTH, true);
+    if (stream == nullptr) throw ParseError("LENGTH stream not found in List column");
+    rle = createRleDecoder(std::move(stream), false, vers, memoryPool, metrics);
+  }
+
   uint64_t ListColumnReader::skip(uint64_t numValues) {
     numValues = ColumnReader::skip(numValues);
     ColumnReader* childReader = child.get();
@@ -1044,6 +1740,8 @@ namespace orc {
                     bool throwOnSchemaEvolutionOverflow = false);
     ~MapColumnReader() override;
 
+    void rebind(StripeStreams& stripe) override;
+
     uint64_t skip(uint64_t numValues) override;
 
     void next(ColumnVectorBatch& rowBatch, uint64_t numValues, char* notNull) override;
@@ -1055,6 +1753,8 @@ namespace orc {
    private:
     template <bool encoded>
     void nextInternal(ColumnVectorBatch& rowBatch, uint64_t numValues, char* notNull);
+
+    void openStreams(StripeStreams& stripe);
   };
 
   MapColumnReader::MapColumnReader(const Type& type, StripeStreams& stripe,
@@ -1062,11 +1762,7 @@ namespace orc {
       : ColumnReader(type, stripe) {
     // Determine if the key and/or value columns are selected
     const std::vector<bool> selectedColumns = stripe.getSelectedColumns();
-    RleVersion vers = convertRleVersion(stripe.getEncoding(columnId).kind());
-    std::unique_ptr<SeekableInputStream> stream =
-        stripe.getStream(columnId, proto::Stream_Kind_LENGTH, true);
-    if (stream == nullptr) throw ParseError("LENGTH stream not found in Map column");
-    rle = createRleDecoder(std::move(stream), false, vers, memoryPool, metrics);
+    openStreams(stripe);
     const Type& keyType = *type.getSubtype(0);
     if (selectedColumns[static_cast<uint64_t>(keyType.getColumnId())]) {
       keyReader =
@@ -1083,6 +1779,25 @@ namespace orc {
     // PASS
   }
 
+  void MapColumnReader::rebind(StripeStreams& stripe) {
+    ColumnReader::rebind(stripe);
+    openStreams(stripe);
+    if (keyReader) {
+      keyReader->rebind(stripe);
+    }
+    if (elementReader) {
+      elementReader->rebind(stripe);
+    }
+  }
+
+  void MapColumnReader::openStreams(StripeStreams& stripe) {
+    RleVersion vers = convertRleVersion(stripe.getEncoding(columnId).kind());
+    std::unique_ptr<SeekableInputStream> stream =
+        stripe.getStream(columnId, proto::Stream_Kind_LENGTH, true);
+    if (stream == nullptr) throw ParseError("LENGTH stream not found in Map column");
+    rle = createRleDecoder(std::move(stream), false, vers, memoryPool, metrics);
+  }
+
   uint64_t MapColumnReader::skip(uint64_t numValues) {
     numValues = ColumnReader::skip(numValues);
     ColumnReader* rawKeyReader = keyReader.get();
@@ -1188,6 +1903,8 @@ namespace orc {
     UnionColumnReader(const Type& type, StripeStreams& stipe, bool useTightNumericVector = false,
                       bool throwOnSchemaEvolutionOverflow = false);
 
+    void rebind(StripeStreams& stripe) override;
+
     uint64_t skip(uint64_t numValues) override;
 
     void next(ColumnVectorBatch& rowBatch, uint64_t numValues, char* notNull) override;
@@ -1199,6 +1916,8 @@ namespace orc {
    private:
     template <bool encoded>
     void nextInternal(ColumnVectorBatch& rowBatch, uint64_t numValues, char* notNull);
+
+    void openStreams(StripeStreams& stripe);
   };
 
   UnionColumnReader::UnionColumnReader(const Type& type, StripeStreams& stripe,
@@ -1209,10 +1928,7 @@ namespace orc {
     childrenReader.resize(numChildren);
     childrenCounts.resize(numChildren);
 
-    std::unique_ptr<SeekableInputStream> stream =
-        stripe.getStream(columnId, proto::Stream_Kind_DATA, true);
-    if (stream == nullptr) throw ParseError("LENGTH stream not found in Union column");
-    rle = createByteRleDecoder(std::move(stream), metrics);
+    openStreams(stripe);
     // figure out which types are selected
     const std::vector<bool> selectedColumns = stripe.getSelectedColumns();
     for (unsigned int i = 0; i < numChildren; ++i) {
@@ -1224,6 +1940,23 @@ namespace orc {
     }
   }
 
+  void UnionColumnReader::rebind(StripeStreams& stripe) {
+    ColumnReader::rebind(stripe);
+    openStreams(stripe);
+    for (auto& child : childrenReader) {
+      if (child) {
+        child->rebind(stripe);
+      }
+    }
+  }
+
+  void UnionColumnReader::openStreams(StripeStreams& stripe) {
+    std::unique_ptr<SeekableInputStream> stream =
+        stripe.getStream(columnId, proto::Stream_Kind_DATA, true);
+    if (stream == nullptr) throw ParseError("LENGTH stream not found in Union column");
+    rle = createByteRleDecoder(std::move(stream), metrics);
+  }
+
   uint64_t UnionColumnReader::skip(uint64_t numValues) {
     numValues = ColumnReader::skip(numValues);
     const uint64_t BUFFER_SIZE = 1024;
@@ -1373,11 +2106,16 @@ namespace orc {
     Decimal64ColumnReader(const Type& type, StripeStreams& stipe);
     ~Decimal64ColumnReader() override;
 
+    void rebind(StripeStreams& stripe) override;
+
     uint64_t skip(uint64_t numValues) override;
 
     void next(ColumnVectorBatch& rowBatch, uint64_t numValues, char* notNull) override;
 
     void seekToRowGroup(std::unordered_map<uint64_t, PositionProvider>& positions) override;
+
+   private:
+    void openStreams(StripeStreams& stripe);
   };
   const uint32_t Decimal64ColumnReader::MAX_PRECISION_64;
   const uint32_t Decimal64ColumnReader::MAX_PRECISION_128;
@@ -1405,6 +2143,19 @@ namespace orc {
       : ColumnReader(type, stripe) {
     scale = static_cast<int32_t>(type.getScale());
     precision = static_cast<int32_t>(type.getPrecision());
+    openStreams(stripe);
+  }
+
+  Decimal64ColumnReader::~Decimal64ColumnReader() {
+    // PASS
+  }
+
+  void Decimal64ColumnReader::rebind(StripeStreams& stripe) {
+    ColumnReader::rebind(stripe);
+    openStreams(stripe);
+  }
+
+  void Decimal64ColumnReader::openStreams(StripeStreams& stripe) {
     valueStream = stripe.getStream(columnId, proto::Stream_Kind_DATA, true);
     if (valueStream == nullptr) throw ParseError("DATA stream not found in Decimal64Column");
     buffer = nullptr;
@@ -1416,10 +2167,6 @@ namespace orc {
     scaleDecoder = createRleDecoder(std::move(stream), true, vers, memoryPool, metrics);
   }
 
-  Decimal64ColumnReader::~Decimal64ColumnReader() {
-    // PASS
-  }
-
   uint64_t Decimal64ColumnReader::skip(uint64_t numValues) {
     numValues = ColumnReader::skip(numValues);
     uint64_t skipped = 0;
@@ -1556,15 +2303,33 @@ namespace orc {
     Decimal64ColumnReaderV2(const Type& type, StripeStreams& stripe);
     ~Decimal64ColumnReaderV2() override;
 
+    void rebind(StripeStreams& stripe) override;
+
     uint64_t skip(uint64_t numValues) override;
 
     void next(ColumnVectorBatch& rowBatch, uint64_t numValues, char* notNull) override;
+
+   private:
+    void openStreams(StripeStreams& stripe);
   };
 
   Decimal64ColumnReaderV2::Decimal64ColumnReaderV2(const Type& type, StripeStreams& stripe)
       : ColumnReader(type, stripe) {
     scale = static_cast<int32_t>(type.getScale());
     precision = static_cast<int32_t>(type.getPrecision());
+    openStreams(stripe);
+  }
+
+  Decimal64ColumnReaderV2::~Decimal64ColumnReaderV2() {
+    // PASS
+  }
+
+  void Decimal64ColumnReaderV2::rebind(StripeStreams& stripe) {
+    ColumnReader::rebind(stripe);
+    openStreams(stripe);
+  }
+
+  void Decimal64ColumnReaderV2::openStreams(StripeStreams& stripe) {
     std::unique_ptr<SeekableInputStream> stream =
         stripe.getStream(columnId, proto::Stream_Kind_DATA, true);
     if (stream == nullptr) {
@@ -1575,10 +2340,6 @@ namespace orc {
     valueDecoder = createRleDecoder(std::move(stream), true, RleVersion_2, memoryPool, metrics);
   }
 
-  Decimal64ColumnReaderV2::~Decimal64ColumnReaderV2() {
-    // PASS
-  }
-
   uint64_t Decimal64ColumnReaderV2::skip(uint64_t numValues) {
     numValues = ColumnReader::skip(numValues);
     valueDecoder->skip(numValues);
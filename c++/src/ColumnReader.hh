@@ -21,6 +21,7 @@
 
 #include <unordered_map>
 
+#include "orc/Reader.hh"
 #include "orc/Vector.hh"
 
 #include "ByteRLE.hh"
@@ -31,6 +32,7 @@
 namespace orc {
 
   class SchemaEvolution;
+  class ThreadPool;
 
   class StripeStreams {
    public:
@@ -108,6 +110,18 @@ namespace orc {
      * @return get schema evolution utility object
      */
     virtual const SchemaEvolution* getSchemaEvolution() const = 0;
+
+    /**
+     * @return the pool that decodes sibling columns concurrently or nullptr
+     */
+    virtual ThreadPool* getDecodePool() const;
+
+    /**
+     * @return the pool for the memory that the batches may keep after the
+     * column readers are dropped, such as the dictionaries of encoded
+     * strings, which is the memory pool unless the readers use an arena
+     */
+    virtual MemoryPool& getBatchMemoryPool() const;
   };
 
   /**
@@ -125,6 +139,14 @@ namespace orc {
 
     virtual ~ColumnReader();
 
+    /**
+     * Move the reader to the start of another stripe, whose columns have the
+     * same encodings and writer timezone as the current one. The reader and
+     * its children keep their buffers and read the streams of the new stripe.
+     * @param stripe the streams of the new stripe
+     */
+    virtual void rebind(StripeStreams& stripe);
+
     /**
      * Skip number of specified rows.
      * @param numValues the number of values to skip
@@ -155,6 +177,27 @@ namespace orc {
       next(rowBatch, numValues, notNull);
     }
 
+    /**
+     * Read the next group of values, keeping only the selected rows. The
+     * values of the selected rows are stored at the start of the rowBatch
+     * and the values of the other rows are skipped where possible.
+     *
+     * The default implementation skips the rows before the first and after
+     * the last selected row, but decodes all of the rows between them and
+     * then drops the unselected ones. A sparse selection thus costs about as
+     * much as decoding the whole span. The readers of the boolean, byte,
+     * integer, floating point, string and struct columns skip each
+     * unselected run instead.
+     * @param rowBatch the memory to read into.
+     * @param numValues the number of values to read
+     * @param notNull if null, all values are not null. Otherwise, it is
+     *           a mask (with at least numValues bytes) for which values to
+     *           set.
+     * @param selected a mask (with numValues bytes) for which rows to keep
+     */
+    virtual void nextSelected(ColumnVectorBatch& rowBatch, uint64_t numValues, char* notNull,
+                              const char* selected);
+
     /**
      * Seek to beginning of a row group in the current stripe
      * @param positions a list of PositionProviders storing the positions
@@ -169,6 +212,20 @@ namespace orc {
                                             bool useTightNumericVector = false,
                                             bool throwOnSchemaEvolutionOverflow = false,
                                             bool convertToReadType = true);
+
+  /**
+   * Read the next group of rows of a struct reader, keeping the rows that
+   * the filter selects. The filter fields are decoded first and the other
+   * fields for the selected rows only.
+   * @param reader the reader of the struct
+   * @param rowBatch the memory to read into
+   * @param numValues the number of rows to read
+   * @param filterFields whether each field of the struct is read by the filter
+   * @param filter the filter
+   * @return the number of selected rows
+   */
+  uint64_t nextFiltered(ColumnReader& reader, ColumnVectorBatch& rowBatch, uint64_t numValues,
+                        const std::vector<bool>& filterFields, const RowFilter& filter);
 }  // namespace orc
 
 #endif
@@ -18,6 +18,7 @@
 
 #include "Compression.hh"
 #include "Adaptor.hh"
+#include "BufferPool.hh"
 #include "LzoDecompressor.hh"
 #include "Utils.hh"
 #include "lz4.h"
@@ -27,6 +28,7 @@
 #include <array>
 #include <iomanip>
 #include <iostream>
+#include <limits>
 #include <sstream>
 
 #include "zlib.h"
@@ -351,19 +353,47 @@ namespace orc {
     virtual void seek(PositionProvider& position) override;
     virtual std::string getName() const override = 0;
 
+    /**
+     * Serve the compressed chunks of the stream from the decompressed
+     * chunk cache and add the chunks that it misses.
+     */
+    void setChunkCache(const DecompressedChunkKey& streamKey);
+
+    /**
+     * Borrow the buffers from the given pool instead of allocating them.
+     * Must be called before the stream is read.
+     */
+    virtual void setBufferPool(BufferPool* bufferPool);
+
    protected:
     virtual void NextDecompress(const void** data, int* size, size_t availableSize) = 0;
 
+    /**
+     * Get the decompressed length of a chunk from the start of its
+     * compressed bytes, for the codecs that store it there.
+     * @param input the available compressed bytes of the chunk
+     * @param length the number of available bytes
+     * @param decompressedLength set to the decompressed length if it is known
+     * @return whether the length is known without decompressing the chunk
+     */
+    virtual bool getDecompressedLength(const char* input, size_t length,
+                                       size_t& decompressedLength) const;
+
     std::string getStreamName() const;
     void readBuffer(bool failOnEof);
     uint32_t readByte(bool failOnEof);
     void readHeader();
+    bool readCachedChunk(const void** data, int* size);
+    void skipChunkInput();
+    size_t skipChunk(size_t maxLength);
 
     MemoryPool& pool;
     std::unique_ptr<SeekableInputStream> input;
 
-    // uncompressed output
-    DataBuffer<char> outputDataBuffer;
+    // uncompressed output, which is only held while the data returned by
+    // Next points into it
+    const size_t blockSize;
+    PooledBuffer outputDataBuffer;
 
     // the current state
     DecompressState state;
@@ -391,11 +421,18 @@ namespace orc {
     // buffer. Used when we have to seek a position.
     size_t headerPosition;
     size_t inputBufferStartPosition;
+    // whether the header of a chunk was read but nothing of the chunk was returned
+    bool chunkStarting;
 
     // roughly the number of bytes returned
     off_t bytesReturned;
 
     ReaderMetrics* metrics;
+
+    // the key of the current chunk in the chunk cache, nullptr if the cache is not used
+    std::unique_ptr<DecompressedChunkKey> chunkKey;
+    // the cached chunk that the output buffer points into
+    std::shared_ptr<const DecompressedChunk> cachedChunk;
   };
 
   DecompressionStream::DecompressionStream(std::unique_ptr<SeekableInputStream> inStream,
@@ -403,7 +440,8 @@ namespace orc {
                                            ReaderMetrics* _metrics)
       : pool(_pool),
         input(std::move(inStream)),
-        outputDataBuffer(pool, bufferSize),
+        blockSize(bufferSize),
+        outputDataBuffer(pool, nullptr),
         state(DECOMPRESS_HEADER),
         outputBufferStart(nullptr),
         outputBuffer(nullptr),
@@ -415,6 +453,7 @@ namespace orc {
         inputBufferEnd(nullptr),
         headerPosition(0),
         inputBufferStartPosition(0),
+        chunkStarting(false),
         bytesReturned(0),
         metrics(_metrics) {}
 
@@ -422,6 +461,83 @@ namespace orc {
     return input->getName();
   }
 
+  void DecompressionStream::setChunkCache(const DecompressedChunkKey& streamKey) {
+    chunkKey = std::make_unique<DecompressedChunkKey>(streamKey);
+  }
+
+  void DecompressionStream::setBufferPool(BufferPool* bufferPool) {
+    outputDataBuffer.setBufferPool(bufferPool);
+  }
+
+  bool DecompressionStream::readCachedChunk(const void** data, int* size) {
+    chunkKey->chunkOffset = headerPosition;
+    std::shared_ptr<const DecompressedChunk> chunk =
+        getDecompressedChunkCacheImpl().get(*chunkKey, metrics);
+    if (chunk == nullptr) {
+      return false;
+    }
+    cachedChunk = std::move(chunk);
+    skipChunkInput();
+    state = DECOMPRESS_HEADER;
+    outputDataBuffer.release();
+    *data = cachedChunk->data();
+    *size = static_cast<int>(cachedChunk->size());
+    outputBuffer = cachedChunk->data() + cachedChunk->size();
+    outputBufferLength = 0;
+    return true;
+  }
+
+  void DecompressionStream::skipChunkInput() {
+    // skip the compressed bytes, reading no more of them from the input
+    size_t buffered = std::min(static_cast<size_t>(inputBufferEnd - inputBuffer), remainingLength);
+    inputBuffer += buffered;
+    remainingLength -= buffered;
+    if (remainingLength > 0) {
+      size_t chunkEnd = static_cast<size_t>(input->ByteCount()) + remainingLength;
+      input->Skip(static_cast<int>(remainingLength));
+      if (static_cast<size_t>(input->ByteCount()) != chunkEnd) {
+        throw ParseError("Read past EOF in DecompressionStream::skipChunkInput");
+      }
+      inputBufferStart = nullptr;
+      inputBuffer = nullptr;
+      inputBufferEnd = nullptr;
+      inputBufferStartPosition = chunkEnd;
+      remainingLength = 0;
+    }
+  }
+
+  size_t DecompressionStream::skipChunk(size_t maxLength) {
+    readHeader();
+    if (state == DECOMPRESS_EOF || remainingLength == 0) {
+      return 0;
+    }
+    if (inputBuffer == inputBufferEnd) {
+      readBuffer(true);
+    }
+    size_t chunkLength = remainingLength;
+    if (state == DECOMPRESS_START) {
+      size_t available =
+          std::min(static_cast<size_t>(inputBufferEnd - inputBuffer), remainingLength);
+      if (!getDecompressedLength(inputBuffer, available, chunkLength) ||
+          chunkLength > blockSize) {
+        return 0;
+      }
+    }
+    if (chunkLength == 0 || chunkLength > maxLength) {
+      return 0;
+    }
+    skipChunkInput();
+    state = DECOMPRESS_HEADER;
+    chunkStarting = false;
+    // nothing of the chunk is buffered for a seek into it
+    headerPosition = std::numeric_limits<size_t>::max();
+    return chunkLength;
+  }
+
+  bool DecompressionStream::getDecompressedLength(const char*, size_t, size_t&) const {
+    return false;
+  }
+
   void DecompressionStream::readBuffer(bool failOnEof) {
     SCOPED_MINUS_STOPWATCH(metrics, DecompressionLatencyUs);
     int length;
@@ -461,6 +577,10 @@ namespace orc {
         state = DECOMPRESS_START;
       }
       remainingLength = header >> 1;
+      // the three bytes of the header were read
+      headerPosition =
+          inputBufferStartPosition + static_cast<size_t>(inputBuffer - inputBufferStart) - 3;
+      chunkStarting = true;
     } else {
       remainingLength = 0;
     }
@@ -468,9 +588,6 @@ namespace orc {
 
   bool DecompressionStream::Next(const void** data, int* size) {
     SCOPED_STOPWATCH(metrics, DecompressionLatencyUs, DecompressionCall);
-    // If we are starting a new header, we will have to store its positions
-    // after decompressing.
-    bool saveBufferPositions = false;
     // If the user pushed back or seeked within the same chunk.
     if (outputBufferLength) {
       *data = outputBuffer;
@@ -482,20 +599,23 @@ namespace orc {
     }
     if (state == DECOMPRESS_HEADER || remainingLength == 0) {
       readHeader();
-      // Here we already read the three bytes of the header.
-      headerPosition =
-          inputBufferStartPosition + static_cast<size_t>(inputBuffer - inputBufferStart) - 3;
-      saveBufferPositions = true;
     }
     if (state == DECOMPRESS_EOF) {
+      outputDataBuffer.release();
       return false;
     }
+    // If we are starting a new chunk, we will have to store its positions
+    // after decompressing.
+    bool saveBufferPositions = chunkStarting;
+    chunkStarting = false;
     if (inputBuffer == inputBufferEnd) {
       readBuffer(true);
     }
     size_t availableSize =
         std::min(static_cast<size_t>(inputBufferEnd - inputBuffer), remainingLength);
     if (state == DECOMPRESS_ORIGINAL) {
+      // the data is returned from the input, so the output buffer is idle
+      outputDataBuffer.release();
       *data = inputBuffer;
       *size = static_cast<int>(availableSize);
       outputBuffer = inputBuffer + availableSize;
@@ -503,7 +623,14 @@ namespace orc {
       inputBuffer += availableSize;
       remainingLength -= availableSize;
     } else if (state == DECOMPRESS_START) {
-      NextDecompress(data, size, availableSize);
+      if (chunkKey == nullptr) {
+        NextDecompress(data, size, availableSize);
+      } else if (!readCachedChunk(data, size)) {
+        cachedChunk.reset();
+        NextDecompress(data, size, availableSize);
+        getDecompressedChunkCacheImpl().put(*chunkKey, static_cast<const char*>(*data),
+                                            static_cast<size_t>(*size));
+      }
     } else {
       throw std::logic_error(
           "Unknown compression state in "
@@ -532,9 +659,18 @@ namespace orc {
 
   bool DecompressionStream::Skip(int count) {
     bytesReturned += count;
-    // this is a stupid implementation for now.
-    // should skip entire blocks without decompressing
     while (count > 0) {
+      // pass over the chunks that end before the target without
+      // decompressing them, if their decompressed length is known
+      if (outputBufferLength == 0 && (state == DECOMPRESS_HEADER || remainingLength == 0)) {
+        size_t skipped = skipChunk(static_cast<size_t>(count));
+        if (skipped > 0) {
+          // count the chunk as if it was returned by Next
+          bytesReturned += static_cast<off_t>(skipped);
+          count -= static_cast<int>(skipped);
+          continue;
+        }
+      }
       const void* ptr;
       int len;
       if (!Next(&ptr, &len)) {
@@ -588,6 +724,7 @@ namespace orc {
     }
     // Clear state to prepare reading from a new chunk header.
     state = DECOMPRESS_HEADER;
+    chunkStarting = false;
     outputBuffer = nullptr;
     outputBufferLength = 0;
     remainingLength = 0;
@@ -601,9 +738,12 @@ namespace orc {
     } else {
       // Case 3: The seeked position is not in the input buffer, here we are
       // forcing to read it.
+      inputBufferStart = nullptr;
       inputBuffer = nullptr;
       inputBufferEnd = nullptr;
       input->seek(position);  // Actually use the input level position.
+      // nothing is buffered, the input may have given its buffer back
+      inputBufferStartPosition = static_cast<size_t>(input->ByteCount());
     }
     bytesReturned = static_cast<off_t>(input->ByteCount());
     if (!Skip(static_cast<int>(position.next()))) {
@@ -640,8 +780,8 @@ namespace orc {
     zstream.zalloc = nullptr;
     zstream.zfree = nullptr;
     zstream.opaque = nullptr;
-    zstream.next_out = reinterpret_cast<Bytef*>(outputDataBuffer.data());
-    zstream.avail_out = static_cast<uInt>(outputDataBuffer.capacity());
+    zstream.next_out = nullptr;
+    zstream.avail_out = 0;
     int64_t result = inflateInit2(&zstream, -15);
     switch (result) {
       case Z_OK:
@@ -670,6 +810,7 @@ namespace orc {
   void ZlibDecompressionStream::NextDecompress(const void** data, int* size, size_t availableSize) {
     zstream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(inputBuffer));
     zstream.avail_in = static_cast<uInt>(availableSize);
+    outputDataBuffer.reserve(blockSize);
     outputBuffer = outputDataBuffer.data();
     zstream.next_out = reinterpret_cast<Bytef*>(const_cast<char*>(outputBuffer));
     zstream.avail_out = static_cast<uInt>(outputDataBuffer.capacity());
@@ -742,14 +883,20 @@ namespace orc {
    private:
     // may need to stitch together multiple input buffers;
     // to give snappy a contiguous block
-    DataBuffer<char> inputDataBuffer;
+    PooledBuffer inputDataBuffer;
+
+   public:
+    void setBufferPool(BufferPool* bufferPool) override {
+      DecompressionStream::setBufferPool(bufferPool);
+      inputDataBuffer.setBufferPool(bufferPool);
+    }
   };
 
   BlockDecompressionStream::BlockDecompressionStream(std::unique_ptr<SeekableInputStream> inStream,
                                                      size_t blockSize, MemoryPool& _pool,
                                                      ReaderMetrics* _metrics)
       : DecompressionStream(std::move(inStream), blockSize, _pool, _metrics),
-        inputDataBuffer(pool, blockSize) {}
+        inputDataBuffer(pool, nullptr) {}
 
   void BlockDecompressionStream::NextDecompress(const void** data, int* size,
                                                 size_t availableSize) {
@@ -759,9 +906,7 @@ namespace orc {
       inputBuffer += availableSize;
     } else {
       // Did not read enough from input.
-      if (inputDataBuffer.capacity() < remainingLength) {
-        inputDataBuffer.resize(remainingLength);
-      }
+      inputDataBuffer.reserve(remainingLength);
       ::memcpy(inputDataBuffer.data(), inputBuffer, availableSize);
       inputBuffer += availableSize;
       compressed = inputDataBuffer.data();
@@ -775,8 +920,11 @@ namespace orc {
         inputBuffer += avail;
       }
     }
+    outputDataBuffer.reserve(blockSize);
     outputBufferLength = decompress(compressed, remainingLength, outputDataBuffer.data(),
                                     outputDataBuffer.capacity());
+    // the stitched block is only needed to decompress it
+    inputDataBuffer.release();
     remainingLength = 0;
     state = DECOMPRESS_HEADER;
     *data = outputDataBuffer.data();
@@ -802,6 +950,12 @@ namespace orc {
    protected:
     virtual uint64_t decompress(const char* input, uint64_t length, char* output,
                                 size_t maxOutputLength) override;
+
+    bool getDecompressedLength(const char* input, size_t length,
+                               size_t& decompressedLength) const override {
+      // the length is a varint at the start of the chunk
+      return snappy::GetUncompressedLength(input, length, &decompressedLength);
+    }
   };
 
   uint64_t SnappyDecompressionStream::decompress(const char* _input, uint64_t length, char* output,
@@ -1108,12 +1262,27 @@ namespace orc {
     virtual uint64_t decompress(const char* input, uint64_t length, char* output,
                                 size_t maxOutputLength) override;
 
+    bool getDecompressedLength(const char* input, size_t length,
+                               size_t& decompressedLength) const override;
+
    private:
     void init();
     void end();
     ZSTD_DCtx* dctx;
   };
 
+  bool ZSTDDecompressionStream::getDecompressedLength(const char* input, size_t length,
+                                                      size_t& decompressedLength) const {
+    // each chunk is a single frame, whose header holds the content size
+    // unless the writer left it out
+    unsigned long long contentSize = ZSTD_getFrameContentSize(input, length);
+    if (contentSize == ZSTD_CONTENTSIZE_UNKNOWN || contentSize == ZSTD_CONTENTSIZE_ERROR) {
+      return false;
+    }
+    decompressedLength = static_cast<size_t>(contentSize);
+    return true;
+  }
+
   uint64_t ZSTDDecompressionStream::decompress(const char* inputPtr, uint64_t length, char* output,
                                                size_t maxOutputLength) {
     return static_cast<uint64_t>(
@@ -1181,29 +1350,47 @@ namespace orc {
 
   std::unique_ptr<SeekableInputStream> createDecompressor(
       CompressionKind kind, std::unique_ptr<SeekableInputStream> input, uint64_t blockSize,
-      MemoryPool& pool, ReaderMetrics* metrics) {
+      MemoryPool& pool, ReaderMetrics* metrics, const DecompressedChunkKey* cacheKey,
+      BufferPool* bufferPool) {
+    std::unique_ptr<DecompressionStream> result;
     switch (static_cast<int64_t>(kind)) {
       case CompressionKind_NONE:
         return input;
       case CompressionKind_ZLIB:
-        return std::make_unique<ZlibDecompressionStream>(std::move(input), blockSize, pool,
-                                                         metrics);
-      case CompressionKind_SNAPPY:
-        return std::make_unique<SnappyDecompressionStream>(std::move(input), blockSize, pool,
+        result = std::make_unique<ZlibDecompressionStream>(std::move(input), blockSize, pool,
                                                            metrics);
+        break;
+      case CompressionKind_SNAPPY:
+        result = std::make_unique<SnappyDecompressionStream>(std::move(input), blockSize, pool,
+                                                             metrics);
+        break;
       case CompressionKind_LZO:
-        return std::make_unique<LzoDecompressionStream>(std::move(input), blockSize, pool, metrics);
+        result = std::make_unique<LzoDecompressionStream>(std::move(input), blockSize, pool,
+                                                          metrics);
+        break;
       case CompressionKind_LZ4:
-        return std::make_unique<Lz4DecompressionStream>(std::move(input), blockSize, pool, metrics);
+        result = std::make_unique<Lz4DecompressionStream>(std::move(input), blockSize, pool,
+                                                          metrics);
+        break;
       case CompressionKind_ZSTD:
-        return std::make_unique<ZSTDDecompressionStream>(std::move(input), blockSize, pool,
-                                                         metrics);
+        result = std::make_unique<ZSTDDecompressionStream>(std::move(input), blockSize, pool,
+                                                           metrics);
+        break;
       default: {
         std::ostringstream buffer;
         buffer << "Unknown compression codec " << kind;
         throw NotImplementedYet(buffer.str());
       }
     }
+    // without a key of the file, a chunk of another file could be returned
+    if (cacheKey != nullptr && !cacheKey->fileKey.empty() &&
+        getDecompressedChunkCacheImpl().isEnabled()) {
+      result->setChunkCache(*cacheKey);
+    }
+    if (bufferPool != nullptr) {
+      result->setBufferPool(bufferPool);
+    }
+    return result;
   }
 
 }  // namespace orc
@@ -19,11 +19,14 @@
 #ifndef ORC_COMPRESSION_HH
 #define ORC_COMPRESSION_HH
 
+#include "DecompressedChunkCache.hh"
 #include "io/InputStream.hh"
 #include "io/OutputStream.hh"
 
 namespace orc {
 
+  class BufferPool;
+
   /**
    * Create a decompressor for the given compression kind.
    * @param kind the compression type to implement
@@ -31,10 +34,15 @@ namespace orc {
    * @param bufferSize the maximum size of the buffer
    * @param pool the memory pool
    * @param metrics the reader metrics
+   * @param cacheKey identifies the stream in the decompressed chunk cache,
+   *        its chunkOffset is ignored; nullptr bypasses the cache
+   * @param bufferPool lends the buffers of the decompressor; nullptr
+   *        allocates them from the memory pool
    */
   std::unique_ptr<SeekableInputStream> createDecompressor(
       CompressionKind kind, std::unique_ptr<SeekableInputStream> input, uint64_t bufferSize,
-      MemoryPool& pool, ReaderMetrics* metrics);
+      MemoryPool& pool, ReaderMetrics* metrics, const DecompressedChunkKey* cacheKey = nullptr,
+      BufferPool* bufferPool = nullptr);
 
   /**
    * Create a compressor for the given compression kind.
@@ -32,6 +32,11 @@ namespace orc {
         fileType.createRowBatch(0, memoryPool, /*encoded=*/false, /*useTightNumericVector=*/true);
   }
 
+  void ConvertColumnReader::rebind(StripeStreams& stripe) {
+    ColumnReader::rebind(stripe);
+    reader->rebind(stripe);
+  }
+
   void ConvertColumnReader::next(ColumnVectorBatch& rowBatch, uint64_t numValues, char* notNull) {
     reader->next(*data, numValues, notNull);
     rowBatch.resize(data->capacity);
@@ -209,7 +214,7 @@ namespace orc {
 
     // contact string values to blob buffer of vector batch
     auto& dstBatch = *SafeCastBatchTo<StringVectorBatch*>(&rowBatch);
-    dstBatch.blob.resize(totalLength);
+    dstBatch.blob.resizeUninitialized(totalLength);
     char* blob = dstBatch.blob.data();
     for (uint64_t i = 0; i < numValues; ++i) {
       if (!rowBatch.hasNulls || rowBatch.notNull[i]) {
@@ -29,6 +29,8 @@ namespace orc {
     ConvertColumnReader(const Type& readType, const Type& fileType, StripeStreams& stripe,
                         bool throwOnOverflow);
 
+    void rebind(StripeStreams& stripe) override;
+
     // override next() to implement convert logic
     void next(ColumnVectorBatch& rowBatch, uint64_t numValues, char* notNull) override;
 
@@ -436,6 +436,7 @@ namespace orc {
     bool ArchParseUserSimdLevel(const std::string& simd_level, int64_t* hardware_flags) {
       enum {
         USER_SIMD_NONE,
+        USER_SIMD_AVX2,
         USER_SIMD_AVX512,
         USER_SIMD_MAX,
       };
@@ -444,6 +445,8 @@ namespace orc {
       // Parse the level
       if (simd_level == "AVX512") {
         level = USER_SIMD_AVX512;
+      } else if (simd_level == "AVX2") {
+        level = USER_SIMD_AVX2;
       } else if (simd_level == "NONE") {
         level = USER_SIMD_NONE;
       } else {
@@ -451,6 +454,9 @@ namespace orc {
       }
 
       // Disable feature as the level
+      if (level < USER_SIMD_AVX2) {
+        *hardware_flags &= ~CpuInfo::AVX2;
+      }
       if (level < USER_SIMD_AVX512) {
         *hardware_flags &= ~CpuInfo::AVX512;
       }
@@ -0,0 +1,171 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "DecompressedChunkCache.hh"
+
+#include <cstring>
+#include <functional>
+
+namespace orc {
+
+  DecompressedChunkCache::~DecompressedChunkCache() {
+    // PASS
+  }
+
+  size_t DecompressedChunkKeyHash::operator()(const DecompressedChunkKey& key) const {
+    size_t result = std::hash<std::string>()(key.fileKey);
+    for (uint64_t value : {key.fileLength, key.streamOffset, key.chunkOffset}) {
+      result = result * 31 + std::hash<uint64_t>()(value);
+    }
+    return result;
+  }
+
+  DecompressedChunkCacheImpl::DecompressedChunkCacheImpl(MemoryPool& pool)
+      : capacity(0), memoryPool(&pool), hitCount(0), missCount(0) {
+    // PASS
+  }
+
+  DecompressedChunkCacheImpl::~DecompressedChunkCacheImpl() {
+    // PASS
+  }
+
+  void DecompressedChunkCacheImpl::Shard::evict(uint64_t shardCapacity) {
+    while (size > shardCapacity) {
+      size -= entries.back().bytes;
+      index.erase(entries.back().key);
+      entries.pop_back();
+    }
+  }
+
+  DecompressedChunkCacheImpl::Shard& DecompressedChunkCacheImpl::getShard(
+      const DecompressedChunkKey& key) {
+    return shards[DecompressedChunkKeyHash()(key) % SHARD_COUNT];
+  }
+
+  uint64_t DecompressedChunkCacheImpl::getShardCapacity() const {
+    return capacity.load() / SHARD_COUNT;
+  }
+
+  void DecompressedChunkCacheImpl::setCapacity(uint64_t bytes) {
+    capacity.store(bytes);
+    for (auto& shard : shards) {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      shard.evict(getShardCapacity());
+    }
+  }
+
+  uint64_t DecompressedChunkCacheImpl::getCapacity() const {
+    return capacity.load();
+  }
+
+  uint64_t DecompressedChunkCacheImpl::getSize() const {
+    uint64_t result = 0;
+    for (auto& shard : shards) {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      result += shard.size;
+    }
+    return result;
+  }
+
+  uint64_t DecompressedChunkCacheImpl::getEntryCount() const {
+    uint64_t result = 0;
+    for (auto& shard : shards) {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      result += shard.entries.size();
+    }
+    return result;
+  }
+
+  uint64_t DecompressedChunkCacheImpl::getHitCount() const {
+    return hitCount.load();
+  }
+
+  uint64_t DecompressedChunkCacheImpl::getMissCount() const {
+    return missCount.load();
+  }
+
+  void DecompressedChunkCacheImpl::setMemoryPool(MemoryPool& pool) {
+    memoryPool.store(&pool);
+  }
+
+  void DecompressedChunkCacheImpl::clear() {
+    for (auto& shard : shards) {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      shard.evict(0);
+    }
+  }
+
+  std::shared_ptr<const DecompressedChunk> DecompressedChunkCacheImpl::get(
+      const DecompressedChunkKey& key, ReaderMetrics* metrics) {
+    Shard& shard = getShard(key);
+    std::shared_ptr<const DecompressedChunk> result;
+    {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      auto position = shard.index.find(key);
+      if (position != shard.index.end()) {
+        shard.entries.splice(shard.entries.begin(), shard.entries, position->second);
+        result = position->second->chunk;
+      }
+    }
+    if (result != nullptr) {
+      hitCount.fetch_add(1);
+      if (metrics != nullptr) {
+        metrics->DecompressedChunkCacheHit.fetch_add(1);
+      }
+    } else {
+      missCount.fetch_add(1);
+      if (metrics != nullptr) {
+        metrics->DecompressedChunkCacheMiss.fetch_add(1);
+      }
+    }
+    return result;
+  }
+
+  void DecompressedChunkCacheImpl::put(const DecompressedChunkKey& key, const char* data,
+                                       size_t length) {
+    uint64_t bytes = length + key.fileKey.size() + sizeof(Entry);
+    if (bytes > getShardCapacity()) {
+      return;
+    }
+    // copy the chunk outside of the lock
+    auto chunk = std::make_shared<DecompressedChunk>(*memoryPool.load(), length);
+    if (length > 0) {
+      memcpy(chunk->data(), data, length);
+    }
+    Shard& shard = getShard(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (shard.index.find(key) != shard.index.end()) {
+      // another reader added the chunk first
+      return;
+    }
+    shard.entries.push_front({key, std::move(chunk), bytes});
+    shard.index[key] = shard.entries.begin();
+    shard.size += bytes;
+    shard.evict(getShardCapacity());
+  }
+
+  DecompressedChunkCacheImpl& getDecompressedChunkCacheImpl() {
+    static DecompressedChunkCacheImpl cache;
+    return cache;
+  }
+
+  DecompressedChunkCache* getDecompressedChunkCache() {
+    return &getDecompressedChunkCacheImpl();
+  }
+
+}  // namespace orc
@@ -0,0 +1,129 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ORC_DECOMPRESSED_CHUNK_CACHE_HH
+#define ORC_DECOMPRESSED_CHUNK_CACHE_HH
+
+#include "orc/MemoryPool.hh"
+#include "orc/Reader.hh"
+
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace orc {
+
+  /**
+   * Identifies a compressed chunk of a stream.
+   */
+  struct DecompressedChunkKey {
+    // the key of the file given by ReaderOptions::setCacheKey(), the chunks
+    // of files without one are not cached
+    std::string fileKey;
+    uint64_t fileLength;
+    // the offset of the stream in the file
+    uint64_t streamOffset;
+    // the offset of the chunk header in the stream
+    uint64_t chunkOffset;
+
+    bool operator==(const DecompressedChunkKey& other) const {
+      return streamOffset == other.streamOffset && chunkOffset == other.chunkOffset &&
+             fileLength == other.fileLength && fileKey == other.fileKey;
+    }
+  };
+
+  struct DecompressedChunkKeyHash {
+    size_t operator()(const DecompressedChunkKey& key) const;
+  };
+
+  using DecompressedChunk = DataBuffer<char>;
+
+  class DecompressedChunkCacheImpl : public DecompressedChunkCache {
+   public:
+    /**
+     * @param pool the pool to allocate the chunks from
+     */
+    explicit DecompressedChunkCacheImpl(MemoryPool& pool = *getDefaultPool());
+    ~DecompressedChunkCacheImpl() override;
+
+    void setCapacity(uint64_t bytes) override;
+    uint64_t getCapacity() const override;
+    uint64_t getSize() const override;
+    uint64_t getEntryCount() const override;
+    uint64_t getHitCount() const override;
+    uint64_t getMissCount() const override;
+    void setMemoryPool(MemoryPool& pool) override;
+    void clear() override;
+
+    bool isEnabled() const {
+      return capacity.load() > 0;
+    }
+
+    /**
+     * Find a chunk and mark it as the most recently used of its shard.
+     * @param metrics the metrics of the reader, may be nullptr
+     * @return the chunk or nullptr if it is not cached
+     */
+    std::shared_ptr<const DecompressedChunk> get(const DecompressedChunkKey& key,
+                                                 ReaderMetrics* metrics);
+
+    /**
+     * Add a copy of a decompressed chunk.
+     */
+    void put(const DecompressedChunkKey& key, const char* data, size_t length);
+
+   private:
+    static const size_t SHARD_COUNT = 16;
+
+    struct Entry {
+      DecompressedChunkKey key;
+      std::shared_ptr<const DecompressedChunk> chunk;
+      uint64_t bytes;
+    };
+    using EntryList = std::list<Entry>;
+
+    struct Shard {
+      mutable std::mutex mutex;
+      uint64_t size = 0;
+      // the entries from the most to the least recently used
+      EntryList entries;
+      std::unordered_map<DecompressedChunkKey, EntryList::iterator, DecompressedChunkKeyHash>
+          index;
+
+      // must be called with the mutex held
+      void evict(uint64_t capacity);
+    };
+
+    std::atomic<uint64_t> capacity;
+    std::atomic<MemoryPool*> memoryPool;
+    std::atomic<uint64_t> hitCount;
+    std::atomic<uint64_t> missCount;
+    Shard shards[SHARD_COUNT];
+
+    Shard& getShard(const DecompressedChunkKey& key);
+    uint64_t getShardCapacity() const;
+  };
+
+  DecompressedChunkCacheImpl& getDecompressedChunkCacheImpl();
+
+}  // namespace orc
+
+#endif
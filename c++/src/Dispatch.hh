@@ -23,12 +23,26 @@
 #include <vector>
 
 #include "CpuInfoUtil.hh"
+#include "orc/Exceptions.hh"
+
+// The AVX2 kernels are compiled for any x86-64 target with a target attribute
+// instead of global compiler flags, so the same binary runs on CPUs without
+// AVX2 and picks the kernels at run time.
+#if (defined(__x86_64__) || defined(_M_X64)) && !defined(__MINGW32__)
+#define ORC_HAVE_RUNTIME_AVX2
+#if defined(_MSC_VER)
+#define ORC_TARGET_AVX2
+#else
+#define ORC_TARGET_AVX2 __attribute__((target("avx2,bmi2,popcnt")))
+#endif
+#endif
 
 namespace orc {
   enum class DispatchLevel : int {
     // These dispatch levels, corresponding to instruction set features,
     // are sorted in increasing order of preference.
     NONE = 0,
+    AVX2,
     AVX512,
     MAX
   };
@@ -39,6 +53,7 @@ namespace orc {
    * Typical use:
    *
    *   static void my_function_default(...);
+   *   static void my_function_avx2(...);
    *   static void my_function_avx512(...);
    *
    *   struct MyDynamicFunction {
@@ -47,6 +62,9 @@ namespace orc {
    *     static std::vector<std::pair<DispatchLevel, FunctionType>> implementations() {
    *       return {
    *         { DispatchLevel::NONE, my_function_default }
+   *   #if defined(ORC_HAVE_RUNTIME_AVX2)
+   *         , { DispatchLevel::AVX2, my_function_avx2 }
+   *   #endif
    *   #if defined(ORC_HAVE_RUNTIME_AVX512)
    *         , { DispatchLevel::AVX512, my_function_avx512 }
    *   #endif
@@ -97,6 +115,8 @@ namespace orc {
       switch (level) {
         case DispatchLevel::NONE:
           return true;
+        case DispatchLevel::AVX2:
+          return cpu_info->isSupported(CpuInfo::AVX2 | CpuInfo::BMI2);
         case DispatchLevel::AVX512:
         case DispatchLevel::MAX:
           return cpu_info->isSupported(CpuInfo::AVX512);
@@ -84,4 +84,22 @@ namespace orc {
   SchemaEvolutionError::~SchemaEvolutionError() noexcept {
     // PASS
   }
+
+  MemoryLimitExceeded::MemoryLimitExceeded(const std::string& what_arg)
+      : runtime_error(what_arg) {
+    // PASS
+  }
+
+  MemoryLimitExceeded::MemoryLimitExceeded(const char* what_arg) : runtime_error(what_arg) {
+    // PASS
+  }
+
+  MemoryLimitExceeded::MemoryLimitExceeded(const MemoryLimitExceeded& error)
+      : runtime_error(error) {
+    // PASS
+  }
+
+  MemoryLimitExceeded::~MemoryLimitExceeded() noexcept {
+    // PASS
+  }
 }  // namespace orc
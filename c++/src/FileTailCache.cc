@@ -0,0 +1,152 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "FileTailCache.hh"
+
+namespace orc {
+
+  FileTailCache::~FileTailCache() {
+    // PASS
+  }
+
+  FileTailCacheImpl::FileTailCacheImpl() : capacity(0), size(0), hitCount(0), missCount(0) {
+    // PASS
+  }
+
+  FileTailCacheImpl::~FileTailCacheImpl() {
+    // PASS
+  }
+
+  void FileTailCacheImpl::setCapacity(uint64_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex);
+    capacity = bytes;
+    evict();
+  }
+
+  uint64_t FileTailCacheImpl::getCapacity() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return capacity;
+  }
+
+  uint64_t FileTailCacheImpl::getSize() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return size;
+  }
+
+  uint64_t FileTailCacheImpl::getEntryCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries.size();
+  }
+
+  uint64_t FileTailCacheImpl::getHitCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return hitCount;
+  }
+
+  uint64_t FileTailCacheImpl::getMissCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return missCount;
+  }
+
+  void FileTailCacheImpl::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.clear();
+    index.clear();
+    size = 0;
+  }
+
+  bool FileTailCacheImpl::isEnabled() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return capacity > 0;
+  }
+
+  std::shared_ptr<const CachedFileTail> FileTailCacheImpl::get(const Key& key,
+                                                               ReaderMetrics* metrics) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto position = index.find(key);
+    if (position == index.end()) {
+      ++missCount;
+      if (metrics != nullptr) {
+        metrics->FileTailCacheMiss.fetch_add(1);
+      }
+      return nullptr;
+    }
+    ++hitCount;
+    if (metrics != nullptr) {
+      metrics->FileTailCacheHit.fetch_add(1);
+    }
+    entries.splice(entries.begin(), entries, position->second);
+    return position->second->tail;
+  }
+
+  void FileTailCacheImpl::put(const Key& key, const CachedFileTail& tail) {
+    std::lock_guard<std::mutex> lock(mutex);
+    insert(key, std::make_shared<const CachedFileTail>(tail));
+  }
+
+  void FileTailCacheImpl::putMetadata(const Key& key,
+                                      const std::shared_ptr<const proto::Metadata>& metadata) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto position = index.find(key);
+    if (position != index.end() && position->second->tail->metadata == nullptr) {
+      auto tail = std::make_shared<CachedFileTail>(*position->second->tail);
+      tail->metadata = metadata;
+      insert(key, std::move(tail));
+    }
+  }
+
+  void FileTailCacheImpl::insert(const Key& key, std::shared_ptr<const CachedFileTail> tail) {
+    auto position = index.find(key);
+    if (position != index.end()) {
+      erase(position);
+    }
+    // the serialized size is a close estimate of the memory of the messages
+    uint64_t bytes = key.cacheKey.size() + sizeof(Entry) + tail->postscript->ByteSizeLong() +
+                     tail->footer->ByteSizeLong() +
+                     (tail->metadata ? tail->metadata->ByteSizeLong() : 0);
+    if (bytes > capacity) {
+      return;
+    }
+    entries.push_front({key, std::move(tail), bytes});
+    index[key] = entries.begin();
+    size += bytes;
+    evict();
+  }
+
+  void FileTailCacheImpl::erase(std::map<Key, EntryList::iterator>::iterator position) {
+    size -= position->second->bytes;
+    entries.erase(position->second);
+    index.erase(position);
+  }
+
+  void FileTailCacheImpl::evict() {
+    while (size > capacity) {
+      erase(index.find(entries.back().key));
+    }
+  }
+
+  FileTailCacheImpl& getFileTailCacheImpl() {
+    static FileTailCacheImpl cache;
+    return cache;
+  }
+
+  FileTailCache* getFileTailCache() {
+    return &getFileTailCacheImpl();
+  }
+
+}  // namespace orc
@@ -0,0 +1,115 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ORC_FILE_TAIL_CACHE_HH
+#define ORC_FILE_TAIL_CACHE_HH
+
+#include "orc/Reader.hh"
+
+#include "wrap/orc-proto-wrapper.hh"
+
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+
+namespace orc {
+
+  /**
+   * The parsed tail of a file. The protobuf objects are shared by every
+   * reader of the file and must not be modified.
+   */
+  struct CachedFileTail {
+    std::shared_ptr<const proto::PostScript> postscript;
+    std::shared_ptr<const proto::Footer> footer;
+    // nullptr until a reader of the file loads the metadata
+    std::shared_ptr<const proto::Metadata> metadata;
+    uint64_t postscriptLength;
+  };
+
+  class FileTailCacheImpl : public FileTailCache {
+   public:
+    struct Key {
+      // the key given by ReaderOptions::setCacheKey()
+      std::string cacheKey;
+      uint64_t fileLength;
+
+      bool operator<(const Key& other) const {
+        return std::tie(cacheKey, fileLength) < std::tie(other.cacheKey, other.fileLength);
+      }
+    };
+
+    FileTailCacheImpl();
+    ~FileTailCacheImpl() override;
+
+    void setCapacity(uint64_t bytes) override;
+    uint64_t getCapacity() const override;
+    uint64_t getSize() const override;
+    uint64_t getEntryCount() const override;
+    uint64_t getHitCount() const override;
+    uint64_t getMissCount() const override;
+    void clear() override;
+
+    bool isEnabled() const;
+
+    /**
+     * Find the tail of a file and mark it as the most recently used.
+     * @param metrics the metrics of the reader, may be nullptr
+     * @return the tail or nullptr if it is not cached
+     */
+    std::shared_ptr<const CachedFileTail> get(const Key& key, ReaderMetrics* metrics);
+
+    /**
+     * Add or replace the tail of a file.
+     */
+    void put(const Key& key, const CachedFileTail& tail);
+
+    /**
+     * Add the metadata to the tail of a file, if the tail is still cached.
+     */
+    void putMetadata(const Key& key, const std::shared_ptr<const proto::Metadata>& metadata);
+
+   private:
+    struct Entry {
+      Key key;
+      std::shared_ptr<const CachedFileTail> tail;
+      uint64_t bytes;
+    };
+    using EntryList = std::list<Entry>;
+
+    mutable std::mutex mutex;
+    uint64_t capacity;
+    uint64_t size;
+    uint64_t hitCount;
+    uint64_t missCount;
+    // the entries from the most to the least recently used
+    EntryList entries;
+    std::map<Key, EntryList::iterator> index;
+
+    void insert(const Key& key, std::shared_ptr<const CachedFileTail> tail);
+    void erase(std::map<Key, EntryList::iterator>::iterator position);
+    void evict();
+  };
+
+  FileTailCacheImpl& getFileTailCacheImpl();
+
+}  // namespace orc
+
+#endif
@@ -0,0 +1,111 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "MemoryArena.hh"
+
+#include <algorithm>
+#include <cstdint>
+#include <new>
+
+namespace orc {
+
+  // keep the allocations aligned for any type
+  static const uint64_t ARENA_ALIGNMENT = 16;
+
+  MemoryArena::MemoryArena(MemoryPool& _parent, uint64_t _chunkSize)
+      : parent(_parent), chunkSize(_chunkSize), current(nullptr), remaining(0) {
+    // PASS
+  }
+
+  MemoryArena::~MemoryArena() {
+    reset();
+  }
+
+  char* MemoryArena::allocateChunk(uint64_t size) {
+    char* chunk = parent.malloc(size);
+    if (chunk == nullptr) {
+      throw std::bad_alloc();
+    }
+    chunks.push_back(chunk);
+    stats.allocatedBytes += size;
+    return chunk;
+  }
+
+  // the bytes that align the address up to the alignment
+  static uint64_t getPadding(const char* p, uint64_t alignment) {
+    return (alignment - reinterpret_cast<uintptr_t>(p) % alignment) % alignment;
+  }
+
+  char* MemoryArena::malloc(uint64_t size) {
+    return mallocAligned(size, ARENA_ALIGNMENT);
+  }
+
+  void MemoryArena::free(char*) {
+    // PASS
+  }
+
+  // The chunks are aligned to ARENA_ALIGNMENT, so a larger alignment takes
+  // at most alignment - ARENA_ALIGNMENT bytes of padding.
+  char* MemoryArena::mallocAligned(uint64_t size, uint64_t alignment) {
+    alignment = std::max(alignment, ARENA_ALIGNMENT);
+    size = (std::max<uint64_t>(size, 1) + ARENA_ALIGNMENT - 1) & ~(ARENA_ALIGNMENT - 1);
+    uint64_t maxPadding = alignment - ARENA_ALIGNMENT;
+    std::lock_guard<std::mutex> lock(mutex);
+    stats.allocationCount += 1;
+    char* result;
+    if (size + maxPadding > chunkSize / 4) {
+      char* chunk = allocateChunk(size + maxPadding);
+      result = chunk + getPadding(chunk, alignment);
+    } else {
+      uint64_t padding = getPadding(current, alignment);
+      if (size + padding > remaining) {
+        current = allocateChunk(chunkSize);
+        remaining = chunkSize;
+        padding = getPadding(current, alignment);
+      }
+      result = current + padding;
+      current += size + padding;
+      remaining -= size + padding;
+    }
+    stats.peakAllocatedBytes = std::max(stats.peakAllocatedBytes, stats.allocatedBytes);
+    return result;
+  }
+
+  void MemoryArena::freeAligned(char*) {
+    // PASS
+  }
+
+  bool MemoryArena::getStats(MemoryPoolStats& result) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    result = stats;
+    return true;
+  }
+
+  void MemoryArena::reset() {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (char* chunk : chunks) {
+      parent.free(chunk);
+    }
+    chunks.clear();
+    current = nullptr;
+    remaining = 0;
+    stats.allocatedBytes = 0;
+  }
+
+}  // namespace orc
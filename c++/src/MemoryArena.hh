@@ -0,0 +1,69 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef ORC_MEMORY_ARENA_HH
+#define ORC_MEMORY_ARENA_HH
+
+#include "orc/MemoryPool.hh"
+
+#include <mutex>
+#include <vector>
+
+namespace orc {
+
+  /**
+   * A pool that hands out the memory of large chunks, which it allocates from
+   * the parent pool, and frees all of it at once on reset. Freeing a single
+   * allocation does nothing, so the arena suits memory that lives about as
+   * long as the arena, such as that of the column readers of a stripe.
+   * Allocations larger than a quarter of a chunk get a chunk of their own.
+   *
+   * The methods may be called concurrently.
+   */
+  class MemoryArena : public MemoryPool {
+   public:
+    MemoryArena(MemoryPool& parent, uint64_t chunkSize = 1024 * 1024);
+    ~MemoryArena() override;
+
+    char* malloc(uint64_t size) override;
+    void free(char* p) override;
+    char* mallocAligned(uint64_t size, uint64_t alignment) override;
+    void freeAligned(char* p) override;
+    bool getStats(MemoryPoolStats& stats) const override;
+
+    // free all the allocated memory
+    void reset();
+
+   private:
+    MemoryPool& parent;
+    const uint64_t chunkSize;
+    mutable std::mutex mutex;
+    std::vector<char*> chunks;
+    // the unused part of the last chunk
+    char* current;
+    uint64_t remaining;
+    MemoryPoolStats stats;
+
+    // allocate a chunk from the parent pool, must hold the mutex
+    char* allocateChunk(uint64_t size);
+  };
+
+}  // namespace orc
+
+#endif
@@ -17,13 +17,26 @@
  */
 
 #include "orc/MemoryPool.hh"
+#include "orc/Exceptions.hh"
 #include "orc/Int128.hh"
 
 #include "Adaptor.hh"
 
 #include <string.h>
+#include <algorithm>
+#include <atomic>
 #include <cstdlib>
 #include <iostream>
+#include <mutex>
+#include <new>
+#include <sstream>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#ifndef _MSC_VER
+#include <sys/mman.h>
+#endif
 
 namespace orc {
 
@@ -31,12 +44,56 @@ namespace orc {
     // PASS
   }
 
+  // Take a little more memory from malloc to align it and put the address
+  // that malloc returned in front of the aligned memory.
+  char* MemoryPool::mallocAligned(uint64_t size, uint64_t alignment) {
+    alignment = std::max<uint64_t>(alignment, sizeof(char*));
+    char* block = malloc(size + alignment + sizeof(char*));
+    if (block == nullptr) {
+      return nullptr;
+    }
+    uintptr_t start = reinterpret_cast<uintptr_t>(block + sizeof(char*));
+    char* result = block + sizeof(char*) + ((alignment - start % alignment) % alignment);
+    reinterpret_cast<char**>(result)[-1] = block;
+    return result;
+  }
+
+  void MemoryPool::freeAligned(char* p) {
+    if (p != nullptr) {
+      free(reinterpret_cast<char**>(p)[-1]);
+    }
+  }
+
+  bool MemoryPool::getStats(MemoryPoolStats&) const {
+    return false;
+  }
+
+  // Allocate aligned memory that std::free releases, or nullptr if there is
+  // no such call on the platform.
+  static char* allocateAligned(uint64_t size, uint64_t alignment) {
+#ifdef _MSC_VER
+    (void)size;
+    (void)alignment;
+    return nullptr;
+#else
+    void* result = nullptr;
+    if (posix_memalign(&result, std::max<uint64_t>(alignment, sizeof(void*)), size) != 0) {
+      return nullptr;
+    }
+    return static_cast<char*>(result);
+#endif
+  }
+
   class MemoryPoolImpl : public MemoryPool {
    public:
     virtual ~MemoryPoolImpl() override;
 
     char* malloc(uint64_t size) override;
     void free(char* p) override;
+#ifndef _MSC_VER
+    char* mallocAligned(uint64_t size, uint64_t alignment) override;
+    void freeAligned(char* p) override;
+#endif
   };
 
   char* MemoryPoolImpl::malloc(uint64_t size) {
@@ -47,10 +104,341 @@ namespace orc {
     std::free(p);
   }
 
+#ifndef _MSC_VER
+  char* MemoryPoolImpl::mallocAligned(uint64_t size, uint64_t alignment) {
+    return allocateAligned(size, alignment);
+  }
+
+  void MemoryPoolImpl::freeAligned(char* p) {
+    std::free(p);
+  }
+#endif
+
   MemoryPoolImpl::~MemoryPoolImpl() {
     // PASS
   }
 
+  class HugePageMemoryPool : public MemoryPoolImpl {
+   private:
+    const uint64_t threshold;
+
+    // back the memory with huge pages if it is large enough
+    char* allocateHugePages(uint64_t size) {
+      size = (size + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+      char* result = allocateAligned(size, HUGE_PAGE_SIZE);
+#ifdef MADV_HUGEPAGE
+      if (result != nullptr) {
+        // only a hint, the memory is still usable if the kernel refuses
+        madvise(result, size, MADV_HUGEPAGE);
+      }
+#endif
+      return result;
+    }
+
+   public:
+    static const uint64_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+    explicit HugePageMemoryPool(uint64_t _threshold)
+        : threshold(std::max(_threshold, HUGE_PAGE_SIZE)) {
+      // PASS
+    }
+
+    char* malloc(uint64_t size) override {
+      char* result = size >= threshold ? allocateHugePages(size) : nullptr;
+      return result != nullptr ? result : MemoryPoolImpl::malloc(size);
+    }
+
+#ifndef _MSC_VER
+    char* mallocAligned(uint64_t size, uint64_t alignment) override {
+      char* result =
+          size >= threshold && alignment <= HUGE_PAGE_SIZE ? allocateHugePages(size) : nullptr;
+      return result != nullptr ? result : MemoryPoolImpl::mallocAligned(size, alignment);
+    }
+#endif
+  };
+
+  std::unique_ptr<MemoryPool> createHugePageMemoryPool(uint64_t threshold) {
+    return std::make_unique<HugePageMemoryPool>(threshold);
+  }
+
+  // The pools below put the size of an allocation in front of it, which
+  // keeps the memory after it aligned for any type.
+  static const uint64_t HEADER_SIZE = 16;
+
+  static char* allocateWithSize(MemoryPool& pool, uint64_t size) {
+    char* block = pool.malloc(size + HEADER_SIZE);
+    if (block == nullptr) {
+      throw std::bad_alloc();
+    }
+    *reinterpret_cast<uint64_t*>(block) = size;
+    return block + HEADER_SIZE;
+  }
+
+  static uint64_t getAllocatedSize(const char* p) {
+    return *reinterpret_cast<const uint64_t*>(p - HEADER_SIZE);
+  }
+
+  static void updatePeak(std::atomic<uint64_t>& peak, uint64_t value) {
+    uint64_t previous = peak.load();
+    while (value > previous && !peak.compare_exchange_weak(previous, value)) {
+      // PASS
+    }
+  }
+
+  class TrackingMemoryPool : public MemoryPool {
+   private:
+    MemoryPool& parent;
+    const uint64_t limit;
+    std::atomic<uint64_t> allocatedBytes{0};
+    std::atomic<uint64_t> peakAllocatedBytes{0};
+    std::atomic<uint64_t> allocationCount{0};
+
+   public:
+    TrackingMemoryPool(MemoryPool& _parent, uint64_t _limit) : parent(_parent), limit(_limit) {
+      // PASS
+    }
+
+    char* malloc(uint64_t size) override;
+    void free(char* p) override;
+    char* mallocAligned(uint64_t size, uint64_t alignment) override;
+    void freeAligned(char* p) override;
+    bool getStats(MemoryPoolStats& stats) const override;
+
+   private:
+    // count the bytes of an allocation against the limit
+    void reserveBytes(uint64_t size);
+  };
+
+  void TrackingMemoryPool::reserveBytes(uint64_t size) {
+    uint64_t allocated = allocatedBytes.fetch_add(size) + size;
+    if (allocated > limit || allocated < size) {
+      allocatedBytes.fetch_sub(size);
+      std::ostringstream msg;
+      msg << "Allocating " << size << " bytes would exceed the memory limit of " << limit
+          << " bytes";
+      throw MemoryLimitExceeded(msg.str());
+    }
+    updatePeak(peakAllocatedBytes, allocated);
+    allocationCount.fetch_add(1);
+  }
+
+  char* TrackingMemoryPool::malloc(uint64_t size) {
+    reserveBytes(size);
+    try {
+      return allocateWithSize(parent, size);
+    } catch (...) {
+      allocatedBytes.fetch_sub(size);
+      throw;
+    }
+  }
+
+  void TrackingMemoryPool::free(char* p) {
+    if (p != nullptr) {
+      allocatedBytes.fetch_sub(getAllocatedSize(p));
+      parent.free(p - HEADER_SIZE);
+    }
+  }
+
+  // The aligned memory is preceded by a header of at least HEADER_SIZE bytes
+  // that ends with its own length and the size of the allocation.
+  char* TrackingMemoryPool::mallocAligned(uint64_t size, uint64_t alignment) {
+    uint64_t headerSize = std::max(alignment, HEADER_SIZE);
+    reserveBytes(size);
+    char* block = parent.mallocAligned(size + headerSize, alignment);
+    if (block == nullptr) {
+      allocatedBytes.fetch_sub(size);
+      throw std::bad_alloc();
+    }
+    char* result = block + headerSize;
+    reinterpret_cast<uint64_t*>(result)[-2] = size;
+    reinterpret_cast<uint64_t*>(result)[-1] = headerSize;
+    return result;
+  }
+
+  void TrackingMemoryPool::freeAligned(char* p) {
+    if (p != nullptr) {
+      allocatedBytes.fetch_sub(reinterpret_cast<uint64_t*>(p)[-2]);
+      parent.freeAligned(p - reinterpret_cast<uint64_t*>(p)[-1]);
+    }
+  }
+
+  bool TrackingMemoryPool::getStats(MemoryPoolStats& stats) const {
+    stats.allocatedBytes = allocatedBytes.load();
+    stats.peakAllocatedBytes = peakAllocatedBytes.load();
+    stats.allocationCount = allocationCount.load();
+    stats.reusedAllocationCount = 0;
+    return true;
+  }
+
+  std::unique_ptr<MemoryPool> createTrackingMemoryPool(MemoryPool& parent, uint64_t limit) {
+    return std::make_unique<TrackingMemoryPool>(parent, limit);
+  }
+
+  class SizeClassMemoryPool : public MemoryPool {
+   public:
+    // the sizes of the smallest and the largest size classes
+    static const uint64_t MIN_CLASS_SIZE = 64;
+    // the blocks are aligned to it and preceded by a header of that size,
+    // which ends with the size of the block and the offset of the memory
+    // that mallocAligned returns into it
+    static const uint64_t BLOCK_ALIGNMENT = MIN_CLASS_SIZE;
+    static const uint64_t MAX_CLASS_SIZE = 4 * 1024 * 1024;
+    static const size_t SHARD_COUNT = 16;
+
+   private:
+    struct Shard {
+      std::mutex mutex;
+      // the cached allocations of each size class
+      std::vector<std::vector<char*>> freeBlocks;
+      uint64_t cachedBytes = 0;
+    };
+
+    MemoryPool& parent;
+    const uint64_t shardCapacity;
+    std::unique_ptr<Shard[]> shards;
+    // the bytes that are in use or cached
+    std::atomic<uint64_t> allocatedBytes{0};
+    std::atomic<uint64_t> peakAllocatedBytes{0};
+    std::atomic<uint64_t> allocationCount{0};
+    std::atomic<uint64_t> reusedAllocationCount{0};
+
+    // the shard of the calling thread
+    Shard& getShard() {
+      return shards[std::hash<std::thread::id>()(std::this_thread::get_id()) % SHARD_COUNT];
+    }
+
+    static size_t getSizeClass(uint64_t size) {
+      size_t sizeClass = 0;
+      for (uint64_t classSize = MIN_CLASS_SIZE; classSize < size; classSize <<= 1) {
+        ++sizeClass;
+      }
+      return sizeClass;
+    }
+
+    char* allocateBlock(uint64_t size) {
+      char* block = parent.mallocAligned(size + BLOCK_ALIGNMENT, BLOCK_ALIGNMENT);
+      if (block == nullptr) {
+        throw std::bad_alloc();
+      }
+      char* result = block + BLOCK_ALIGNMENT;
+      reinterpret_cast<uint64_t*>(result)[-2] = size;
+      reinterpret_cast<uint64_t*>(result)[-1] = 0;
+      return result;
+    }
+
+    void freeBlock(char* p) {
+      parent.freeAligned(p - BLOCK_ALIGNMENT);
+    }
+
+   public:
+    SizeClassMemoryPool(MemoryPool& _parent, uint64_t cacheCapacity)
+        : parent(_parent),
+          shardCapacity(cacheCapacity / SHARD_COUNT),
+          shards(new Shard[SHARD_COUNT]) {
+      for (size_t i = 0; i < SHARD_COUNT; ++i) {
+        shards[i].freeBlocks.resize(getSizeClass(MAX_CLASS_SIZE) + 1);
+      }
+    }
+
+    ~SizeClassMemoryPool() override;
+
+    char* malloc(uint64_t size) override;
+    void free(char* p) override;
+    char* mallocAligned(uint64_t size, uint64_t alignment) override;
+    void freeAligned(char* p) override;
+    bool getStats(MemoryPoolStats& stats) const override;
+  };
+
+  SizeClassMemoryPool::~SizeClassMemoryPool() {
+    for (size_t i = 0; i < SHARD_COUNT; ++i) {
+      for (auto& blocks : shards[i].freeBlocks) {
+        for (char* block : blocks) {
+          freeBlock(block);
+        }
+      }
+    }
+  }
+
+  char* SizeClassMemoryPool::malloc(uint64_t size) {
+    allocationCount.fetch_add(1);
+    if (size <= MAX_CLASS_SIZE) {
+      size_t sizeClass = getSizeClass(size);
+      size = MIN_CLASS_SIZE << sizeClass;
+      Shard& shard = getShard();
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      std::vector<char*>& blocks = shard.freeBlocks[sizeClass];
+      if (!blocks.empty()) {
+        char* result = blocks.back();
+        blocks.pop_back();
+        shard.cachedBytes -= size;
+        reusedAllocationCount.fetch_add(1);
+        return result;
+      }
+    }
+    char* result = allocateBlock(size);
+    updatePeak(peakAllocatedBytes, allocatedBytes.fetch_add(size) + size);
+    return result;
+  }
+
+  void SizeClassMemoryPool::free(char* p) {
+    if (p == nullptr) {
+      return;
+    }
+    uint64_t size = getAllocatedSize(p);
+    if (size <= MAX_CLASS_SIZE) {
+      Shard& shard = getShard();
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      if (shard.cachedBytes + size <= shardCapacity) {
+        shard.freeBlocks[getSizeClass(size)].push_back(p);
+        shard.cachedBytes += size;
+        return;
+      }
+    }
+    allocatedBytes.fetch_sub(size);
+    freeBlock(p);
+  }
+
+  // The blocks are aligned to BLOCK_ALIGNMENT, so only a larger alignment
+  // takes more memory than the size class of the allocation.
+  char* SizeClassMemoryPool::mallocAligned(uint64_t size, uint64_t alignment) {
+    if (alignment <= BLOCK_ALIGNMENT) {
+      return malloc(size);
+    }
+    char* block = malloc(size + alignment - BLOCK_ALIGNMENT);
+    uint64_t offset = (alignment - reinterpret_cast<uintptr_t>(block) % alignment) % alignment;
+    char* result = block + offset;
+    if (offset != 0) {
+      // the offset is at least BLOCK_ALIGNMENT, so the header is within the block
+      reinterpret_cast<uint64_t*>(result)[-1] = offset;
+    }
+    return result;
+  }
+
+  void SizeClassMemoryPool::freeAligned(char* p) {
+    if (p != nullptr) {
+      free(p - reinterpret_cast<uint64_t*>(p)[-1]);
+    }
+  }
+
+  bool SizeClassMemoryPool::getStats(MemoryPoolStats& stats) const {
+    stats.allocatedBytes = allocatedBytes.load();
+    stats.peakAllocatedBytes = peakAllocatedBytes.load();
+    stats.allocationCount = allocationCount.load();
+    stats.reusedAllocationCount = reusedAllocationCount.load();
+    return true;
+  }
+
+  std::unique_ptr<MemoryPool> createSizeClassMemoryPool(MemoryPool& parent,
+                                                        uint64_t cacheCapacity) {
+    return std::make_unique<SizeClassMemoryPool>(parent, cacheCapacity);
+  }
+
+  // the memory of a DataBuffer is aligned for the SIMD kernels that decode into it
+  template <class T>
+  static T* allocateElements(MemoryPool& pool, uint64_t count) {
+    return reinterpret_cast<T*>(pool.mallocAligned(sizeof(T) * count, DATA_BUFFER_ALIGNMENT));
+  }
+
   template <class T>
   DataBuffer<T>::DataBuffer(MemoryPool& pool, uint64_t newSize)
       : memoryPool(pool), buf(nullptr), currentSize(0), currentCapacity(0) {
@@ -74,7 +462,7 @@ namespace orc {
       (buf + i - 1)->~T();
     }
     if (buf) {
-      memoryPool.free(reinterpret_cast<char*>(buf));
+      memoryPool.freeAligned(reinterpret_cast<char*>(buf));
     }
   }
 
@@ -98,22 +486,51 @@ namespace orc {
     if (newCapacity > currentCapacity || !buf) {
       if (buf) {
         T* buf_old = buf;
-        buf = reinterpret_cast<T*>(memoryPool.malloc(sizeof(T) * newCapacity));
+        buf = allocateElements<T>(memoryPool, newCapacity);
         memcpy(buf, buf_old, sizeof(T) * currentSize);
-        memoryPool.free(reinterpret_cast<char*>(buf_old));
+        memoryPool.freeAligned(reinterpret_cast<char*>(buf_old));
       } else {
-        buf = reinterpret_cast<T*>(memoryPool.malloc(sizeof(T) * newCapacity));
+        buf = allocateElements<T>(memoryPool, newCapacity);
       }
       currentCapacity = newCapacity;
     }
   }
 
+  template <class T>
+  void DataBuffer<T>::resizeUninitialized(uint64_t newSize) {
+    if (newSize > currentCapacity) {
+      reserve(std::max(newSize, 2 * currentCapacity));
+    }
+    if constexpr (std::is_trivially_default_constructible<T>::value &&
+                  std::is_trivially_destructible<T>::value) {
+      currentSize = newSize;
+    } else {
+      resize(newSize);
+    }
+  }
+
+  template <class T>
+  bool DataBuffer<T>::shrinkToFit() {
+    if (!buf || currentSize >= currentCapacity / 4) {
+      return false;
+    }
+    uint64_t newCapacity = 2 * currentSize;
+    T* buf_old = buf;
+    buf = newCapacity == 0 ? nullptr : allocateElements<T>(memoryPool, newCapacity);
+    if (currentSize > 0) {
+      memcpy(buf, buf_old, sizeof(T) * currentSize);
+    }
+    memoryPool.freeAligned(reinterpret_cast<char*>(buf_old));
+    currentCapacity = newCapacity;
+    return true;
+  }
+
   // Specializations for char
 
   template <>
   DataBuffer<char>::~DataBuffer() {
     if (buf) {
-      memoryPool.free(reinterpret_cast<char*>(buf));
+      memoryPool.freeAligned(reinterpret_cast<char*>(buf));
     }
   }
 
@@ -131,7 +548,7 @@ namespace orc {
   template <>
   DataBuffer<char*>::~DataBuffer() {
     if (buf) {
-      memoryPool.free(reinterpret_cast<char*>(buf));
+      memoryPool.freeAligned(reinterpret_cast<char*>(buf));
     }
   }
 
@@ -149,7 +566,7 @@ namespace orc {
   template <>
   DataBuffer<double>::~DataBuffer() {
     if (buf) {
-      memoryPool.free(reinterpret_cast<char*>(buf));
+      memoryPool.freeAligned(reinterpret_cast<char*>(buf));
     }
   }
 
@@ -167,7 +584,7 @@ namespace orc {
   template <>
   DataBuffer<float>::~DataBuffer() {
     if (buf) {
-      memoryPool.free(reinterpret_cast<char*>(buf));
+      memoryPool.freeAligned(reinterpret_cast<char*>(buf));
     }
   }
 
@@ -185,7 +602,7 @@ namespace orc {
   template <>
   DataBuffer<int64_t>::~DataBuffer() {
     if (buf) {
-      memoryPool.free(reinterpret_cast<char*>(buf));
+      memoryPool.freeAligned(reinterpret_cast<char*>(buf));
     }
   }
 
@@ -203,7 +620,7 @@ namespace orc {
   template <>
   DataBuffer<int32_t>::~DataBuffer() {
     if (buf) {
-      memoryPool.free(reinterpret_cast<char*>(buf));
+      memoryPool.freeAligned(reinterpret_cast<char*>(buf));
     }
   }
 
@@ -221,7 +638,7 @@ namespace orc {
   template <>
   DataBuffer<int16_t>::~DataBuffer() {
     if (buf) {
-      memoryPool.free(reinterpret_cast<char*>(buf));
+      memoryPool.freeAligned(reinterpret_cast<char*>(buf));
     }
   }
 
@@ -239,7 +656,7 @@ namespace orc {
   template <>
   DataBuffer<int8_t>::~DataBuffer() {
     if (buf) {
-      memoryPool.free(reinterpret_cast<char*>(buf));
+      memoryPool.freeAligned(reinterpret_cast<char*>(buf));
     }
   }
 
@@ -257,7 +674,7 @@ namespace orc {
   template <>
   DataBuffer<uint64_t>::~DataBuffer() {
     if (buf) {
-      memoryPool.free(reinterpret_cast<char*>(buf));
+      memoryPool.freeAligned(reinterpret_cast<char*>(buf));
     }
   }
 
@@ -275,7 +692,7 @@ namespace orc {
   template <>
   DataBuffer<unsigned char>::~DataBuffer() {
     if (buf) {
-      memoryPool.free(reinterpret_cast<char*>(buf));
+      memoryPool.freeAligned(reinterpret_cast<char*>(buf));
     }
   }
 
@@ -43,6 +43,7 @@ namespace orc {
     MemoryPool* memoryPool;
     std::string serializedTail;
     ReaderMetrics* metrics;
+    std::string cacheKey;
 
     ReaderOptionsPrivate() {
       tailLocation = std::numeric_limits<uint64_t>::max();
@@ -104,6 +105,15 @@ namespace orc {
     return privateBits->tailLocation;
   }
 
+  ReaderOptions& ReaderOptions::setCacheKey(const std::string& key) {
+    privateBits->cacheKey = key;
+    return *this;
+  }
+
+  const std::string& ReaderOptions::getCacheKey() const {
+    return privateBits->cacheKey;
+  }
+
   ReaderOptions& ReaderOptions::setSerializedFileTail(const std::string& value) {
     privateBits->serializedTail = value;
     return *this;
@@ -141,6 +151,16 @@ namespace orc {
     bool useTightNumericVector;
     std::shared_ptr<Type> readType;
     bool throwOnSchemaEvolutionOverflow;
+    uint32_t prefetchStripeCount;
+    uint64_t prefetchMemoryBudget;
+    bool coalesceReads;
+    uint64_t coalesceMaxGap;
+    uint32_t columnDecodeThreadCount;
+    std::list<std::string> rowFilterColumns;
+    RowFilter rowFilter;
+    uint64_t rowLimit;
+    uint64_t readBufferMemoryLimit;
+    bool useStripeArena;
 
     RowReaderOptionsPrivate() {
       selection = ColumnSelection_NONE;
@@ -152,6 +172,14 @@ namespace orc {
       readerTimezone = "GMT";
       useTightNumericVector = false;
       throwOnSchemaEvolutionOverflow = false;
+      prefetchStripeCount = 0;
+      prefetchMemoryBudget = 256 * 1024 * 1024;
+      coalesceReads = false;
+      coalesceMaxGap = 1024 * 1024;
+      columnDecodeThreadCount = 0;
+      rowLimit = std::numeric_limits<uint64_t>::max();
+      readBufferMemoryLimit = std::numeric_limits<uint64_t>::max();
+      useStripeArena = false;
     }
   };
 
@@ -326,6 +354,93 @@ namespace orc {
   std::shared_ptr<Type>& RowReaderOptions::getReadType() const {
     return privateBits->readType;
   }
+
+  RowReaderOptions& RowReaderOptions::setPrefetchStripeCount(uint32_t count) {
+    privateBits->prefetchStripeCount = count;
+    return *this;
+  }
+
+  uint32_t RowReaderOptions::getPrefetchStripeCount() const {
+    return privateBits->prefetchStripeCount;
+  }
+
+  RowReaderOptions& RowReaderOptions::setPrefetchMemoryBudget(uint64_t bytes) {
+    privateBits->prefetchMemoryBudget = bytes;
+    return *this;
+  }
+
+  uint64_t RowReaderOptions::getPrefetchMemoryBudget() const {
+    return privateBits->prefetchMemoryBudget;
+  }
+
+  RowReaderOptions& RowReaderOptions::setCoalesceReads(bool coalesce) {
+    privateBits->coalesceReads = coalesce;
+    return *this;
+  }
+
+  bool RowReaderOptions::getCoalesceReads() const {
+    return privateBits->coalesceReads;
+  }
+
+  RowReaderOptions& RowReaderOptions::setCoalesceMaxGap(uint64_t bytes) {
+    privateBits->coalesceMaxGap = bytes;
+    return *this;
+  }
+
+  uint64_t RowReaderOptions::getCoalesceMaxGap() const {
+    return privateBits->coalesceMaxGap;
+  }
+
+  RowReaderOptions& RowReaderOptions::setColumnDecodeThreadCount(uint32_t count) {
+    privateBits->columnDecodeThreadCount = count;
+    return *this;
+  }
+
+  uint32_t RowReaderOptions::getColumnDecodeThreadCount() const {
+    return privateBits->columnDecodeThreadCount;
+  }
+
+  RowReaderOptions& RowReaderOptions::setRowFilter(const std::list<std::string>& columns,
+                                                   RowFilter filter) {
+    privateBits->rowFilterColumns = columns;
+    privateBits->rowFilter = std::move(filter);
+    return *this;
+  }
+
+  const std::list<std::string>& RowReaderOptions::getRowFilterColumns() const {
+    return privateBits->rowFilterColumns;
+  }
+
+  const RowFilter& RowReaderOptions::getRowFilter() const {
+    return privateBits->rowFilter;
+  }
+
+  RowReaderOptions& RowReaderOptions::limit(uint64_t rows) {
+    privateBits->rowLimit = rows;
+    return *this;
+  }
+
+  uint64_t RowReaderOptions::getLimit() const {
+    return privateBits->rowLimit;
+  }
+
+  RowReaderOptions& RowReaderOptions::setReadBufferMemoryLimit(uint64_t bytes) {
+    privateBits->readBufferMemoryLimit = bytes;
+    return *this;
+  }
+
+  uint64_t RowReaderOptions::getReadBufferMemoryLimit() const {
+    return privateBits->readBufferMemoryLimit;
+  }
+
+  RowReaderOptions& RowReaderOptions::setUseStripeArena(bool useStripeArena) {
+    privateBits->useStripeArena = useStripeArena;
+    return *this;
+  }
+
+  bool RowReaderOptions::getUseStripeArena() const {
+    return privateBits->useStripeArena;
+  }
 }  // namespace orc
 
 #endif
@@ -23,9 +23,12 @@
 
 #include <errno.h>
 #include <fcntl.h>
+#include <limits.h>
 #include <stdio.h>
 #include <string.h>
 #include <sys/stat.h>
+#include <algorithm>
+#include <numeric>
 
 #ifdef _MSC_VER
 #include <io.h>
@@ -35,10 +38,18 @@
 #define fstat _fstat64
 #define fsync _commit
 #else
+#include <sys/mman.h>
 #include <unistd.h>
 #define O_BINARY 0
 #endif
 
+#ifdef HAS_PREADV
+#include <sys/uio.h>
+#ifndef IOV_MAX
+#define IOV_MAX 1024
+#endif
+#endif
+
 namespace orc {
 
   DIAGNOSTIC_PUSH
@@ -93,6 +104,46 @@ namespace orc {
       }
     }
 
+#ifdef HAS_PREADV
+    void readv(const std::vector<ReadRange>& ranges, const std::vector<void*>& buffers) override {
+      SCOPED_STOPWATCH(metrics, IOBlockingLatencyUs, IOCount);
+      if (ranges.size() != buffers.size()) {
+        throw std::logic_error("The number of ranges and buffers differ");
+      }
+      std::vector<size_t> order(ranges.size());
+      std::iota(order.begin(), order.end(), 0);
+      std::sort(order.begin(), order.end(),
+                [&ranges](size_t a, size_t b) { return ranges[a].offset < ranges[b].offset; });
+
+      // read each run of adjacent ranges with a single call
+      std::vector<struct iovec> iov;
+      size_t next = 0;
+      while (next < order.size()) {
+        uint64_t start = ranges[order[next]].offset;
+        uint64_t end = start;
+        iov.clear();
+        while (next < order.size() && ranges[order[next]].offset == end &&
+               iov.size() < static_cast<size_t>(IOV_MAX)) {
+          const ReadRange& range = ranges[order[next]];
+          if (!buffers[order[next]]) {
+            throw ParseError("Buffer is null");
+          }
+          iov.push_back({buffers[order[next]], static_cast<size_t>(range.length)});
+          end += range.length;
+          ++next;
+        }
+        ssize_t bytesRead =
+            preadv(file, iov.data(), static_cast<int>(iov.size()), static_cast<off_t>(start));
+        if (bytesRead == -1) {
+          throw ParseError("Bad read of " + filename);
+        }
+        if (static_cast<uint64_t>(bytesRead) != end - start) {
+          throw ParseError("Short read of " + filename);
+        }
+      }
+    }
+#endif
+
     const std::string& getName() const override {
       return filename;
     }
@@ -102,6 +153,101 @@ namespace orc {
     close(file);
   }
 
+#ifndef _MSC_VER
+  class MappedFileInputStream : public InputStream {
+   private:
+    std::string filename;
+    const char* data;
+    uint64_t totalLength;
+    ReaderMetrics* metrics;
+
+   public:
+    MappedFileInputStream(std::string _filename, ReaderMetrics* _metrics)
+        : filename(_filename), data(nullptr), metrics(_metrics) {
+      int file = open(filename.c_str(), O_BINARY | O_RDONLY);
+      if (file == -1) {
+        throw ParseError("Can't open " + filename);
+      }
+      struct stat fileStat;
+      if (fstat(file, &fileStat) == -1) {
+        close(file);
+        throw ParseError("Can't stat " + filename);
+      }
+      totalLength = static_cast<uint64_t>(fileStat.st_size);
+      if (totalLength > 0) {
+        void* mapping = mmap(nullptr, totalLength, PROT_READ, MAP_SHARED, file, 0);
+        if (mapping == MAP_FAILED) {
+          close(file);
+          throw ParseError("Can't map " + filename);
+        }
+        data = static_cast<const char*>(mapping);
+      }
+      // the mapping stays valid after the file is closed
+      close(file);
+    }
+
+    ~MappedFileInputStream() override;
+
+    uint64_t getLength() const override {
+      return totalLength;
+    }
+
+    uint64_t getNaturalReadSize() const override {
+      return 128 * 1024;
+    }
+
+    void read(void* buf, uint64_t length, uint64_t offset) override {
+      SCOPED_STOPWATCH(metrics, IOBlockingLatencyUs, IOCount);
+      if (!buf) {
+        throw ParseError("Buffer is null");
+      }
+      if (offset > totalLength || length > totalLength - offset) {
+        throw ParseError("Short read of " + filename);
+      }
+      if (length > 0) {
+        memcpy(buf, data + offset, length);
+      }
+    }
+
+    const char* getMappedRange(uint64_t offset, uint64_t length) const override {
+      if (offset > totalLength || length > totalLength - offset) {
+        return nullptr;
+      }
+      return data + offset;
+    }
+
+    const std::string& getName() const override {
+      return filename;
+    }
+  };
+
+  MappedFileInputStream::~MappedFileInputStream() {
+    if (data != nullptr) {
+      munmap(const_cast<char*>(data), totalLength);
+    }
+  }
+#endif
+
+  const char* InputStream::getMappedRange(uint64_t, uint64_t) const {
+    return nullptr;
+  }
+
+  void InputStream::readv(const std::vector<ReadRange>& ranges,
+                          const std::vector<void*>& buffers) {
+    if (ranges.size() != buffers.size()) {
+      throw std::logic_error("The number of ranges and buffers differ");
+    }
+    for (size_t i = 0; i < ranges.size(); ++i) {
+      read(buffers[i], ranges[i].length, ranges[i].offset);
+    }
+  }
+
+  std::future<void> InputStream::readAsync(const std::vector<ReadRange>& ranges,
+                                           const std::vector<void*>& buffers) {
+    return std::async(std::launch::async,
+                      [this, ranges, buffers]() { this->readv(ranges, buffers); });
+  }
+
   std::unique_ptr<InputStream> readFile(const std::string& path, ReaderMetrics* metrics) {
 #ifdef BUILD_LIBHDFSPP
     if (strncmp(path.c_str(), "hdfs://", 7) == 0) {
@@ -120,6 +266,17 @@ namespace orc {
     return std::make_unique<FileInputStream>(path, metrics);
   }
 
+  std::unique_ptr<InputStream> readMappedLocalFile(const std::string& path,
+                                                   ReaderMetrics* metrics) {
+#ifdef _MSC_VER
+    (void)path;
+    (void)metrics;
+    throw NotImplementedYet("Memory mapped files are not supported on this platform");
+#else
+    return std::make_unique<MappedFileInputStream>(path, metrics);
+#endif
+  }
+
   OutputStream::~OutputStream(){
       // PASS
   };
@@ -0,0 +1,177 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ParallelRowReader.hh"
+#include "BufferPool.hh"
+#include "Reader.hh"
+#include "ThreadPool.hh"
+
+#include <algorithm>
+#include <limits>
+
+namespace orc {
+
+  ParallelRowReader::~ParallelRowReader() {
+    // PASS
+  }
+
+  // Cut the batch to its first rows and its children to the values of these rows.
+  static void trimBatch(ColumnVectorBatch& batch, uint64_t rows) {
+    if (rows >= batch.numElements) {
+      return;
+    }
+    batch.numElements = rows;
+    if (auto structBatch = dynamic_cast<StructVectorBatch*>(&batch)) {
+      for (ColumnVectorBatch* field : structBatch->fields) {
+        trimBatch(*field, rows);
+      }
+    } else if (auto listBatch = dynamic_cast<ListVectorBatch*>(&batch)) {
+      trimBatch(*listBatch->elements, static_cast<uint64_t>(listBatch->offsets[rows]));
+    } else if (auto mapBatch = dynamic_cast<MapVectorBatch*>(&batch)) {
+      uint64_t values = static_cast<uint64_t>(mapBatch->offsets[rows]);
+      if (mapBatch->keys) {
+        trimBatch(*mapBatch->keys, values);
+      }
+      if (mapBatch->elements) {
+        trimBatch(*mapBatch->elements, values);
+      }
+    } else if (auto unionBatch = dynamic_cast<UnionVectorBatch*>(&batch)) {
+      std::vector<uint64_t> values(unionBatch->children.size(), 0);
+      for (uint64_t i = 0; i < rows; ++i) {
+        if (!unionBatch->hasNulls || unionBatch->notNull[i]) {
+          ++values[unionBatch->tags[i]];
+        }
+      }
+      for (size_t i = 0; i < values.size(); ++i) {
+        trimBatch(*unionBatch->children[i], values[i]);
+      }
+    }
+  }
+
+  ParallelRowReaderImpl::ParallelRowReaderImpl(std::shared_ptr<FileContents> _contents,
+                                               const RowReaderOptions& _options,
+                                               uint64_t _batchSize, uint32_t _threadCount)
+      : contents(std::move(_contents)),
+        options(_options),
+        batchSize(_batchSize),
+        threadCount(std::max(_threadCount, 1u)),
+        nextStripe(0),
+        scheduledRows(0),
+        returnedRows(0),
+        currentBatch(0),
+        rowNumber((std::numeric_limits<uint64_t>::max)()),
+        cancelled(std::make_shared<std::atomic<bool>>(false)) {
+    if (batchSize == 0) {
+      throw std::logic_error("The batch size of a ParallelRowReader must be positive");
+    }
+    bufferPool = std::make_shared<BufferPool>(*contents->pool, options.getReadBufferMemoryLimit());
+    if (options.getColumnDecodeThreadCount() > 1) {
+      decodePool = std::make_shared<ThreadPool>(options.getColumnDecodeThreadCount());
+    }
+    rowReader = std::make_unique<RowReaderImpl>(contents, options, bufferPool, decodePool);
+    for (int i = 0; i < contents->footer->stripes_size(); ++i) {
+      uint64_t offset = contents->footer->stripes(i).offset();
+      if (offset >= options.getOffset() && offset < options.getOffset() + options.getLength()) {
+        stripeOffsets.push_back(offset);
+        stripeRows.push_back(contents->footer->stripes(i).number_of_rows());
+      }
+    }
+    schedule();
+  }
+
+  ParallelRowReaderImpl::~ParallelRowReaderImpl() {
+    cancelled->store(true);
+    // the futures wait for the decoding threads when they are destroyed
+    pending.clear();
+  }
+
+  std::unique_ptr<ParallelRowReaderImpl::DecodedStripe> ParallelRowReaderImpl::decodeStripe(
+      std::shared_ptr<FileContents> contents, const RowReaderOptions& options,
+      std::shared_ptr<BufferPool> bufferPool, std::shared_ptr<ThreadPool> decodePool,
+      uint64_t stripeOffset, uint64_t limit, uint64_t batchSize,
+      std::shared_ptr<std::atomic<bool>> cancelled) {
+    RowReaderOptions stripeOptions(options);
+    stripeOptions.range(stripeOffset, 1).limit(limit).setPrefetchStripeCount(0);
+    RowReaderImpl stripeReader(contents, stripeOptions, std::move(bufferPool),
+                               std::move(decodePool));
+    auto stripe = std::make_unique<DecodedStripe>();
+    while (!cancelled->load()) {
+      std::unique_ptr<ColumnVectorBatch> batch = stripeReader.createRowBatch(batchSize);
+      if (!stripeReader.next(*batch)) {
+        break;
+      }
+      stripe->batches.push_back(std::move(batch));
+      stripe->rowNumbers.push_back(stripeReader.getRowNumber());
+    }
+    return stripe;
+  }
+
+  void ParallelRowReaderImpl::schedule() {
+    // without a search argument or a row filter every row of a stripe is returned
+    bool isInOrder = !options.getSearchArgument() && !options.getRowFilter();
+    while (pending.size() < threadCount && nextStripe < stripeOffsets.size() &&
+           !(isInOrder && scheduledRows >= options.getLimit())) {
+      // the rows of the stripes before it count against the limit, unless
+      // they are filtered
+      uint64_t limit = isInOrder ? options.getLimit() - scheduledRows : options.getLimit();
+      scheduledRows += stripeRows[nextStripe];
+      pending.push_back(std::async(std::launch::async, &ParallelRowReaderImpl::decodeStripe,
+                                   contents, std::cref(options), bufferPool, decodePool,
+                                   stripeOffsets[nextStripe], limit, batchSize, cancelled));
+      ++nextStripe;
+    }
+  }
+
+  const Type& ParallelRowReaderImpl::getSelectedType() const {
+    return rowReader->getSelectedType();
+  }
+
+  const std::vector<bool> ParallelRowReaderImpl::getSelectedColumns() const {
+    return rowReader->getSelectedColumns();
+  }
+
+  std::unique_ptr<ColumnVectorBatch> ParallelRowReaderImpl::next() {
+    if (returnedRows >= options.getLimit()) {
+      currentStripe.reset();
+      return nullptr;
+    }
+    while (currentStripe == nullptr || currentBatch == currentStripe->batches.size()) {
+      if (pending.empty()) {
+        currentStripe.reset();
+        return nullptr;
+      }
+      // rethrows the errors of the decoding thread
+      currentStripe = pending.front().get();
+      pending.pop_front();
+      currentBatch = 0;
+      schedule();
+    }
+    rowNumber = currentStripe->rowNumbers[currentBatch];
+    std::unique_ptr<ColumnVectorBatch> batch = std::move(currentStripe->batches[currentBatch++]);
+    // the filtered stripes are limited on their own, so the last batch may
+    // hold too many rows
+    trimBatch(*batch, options.getLimit() - returnedRows);
+    returnedRows += batch->numElements;
+    return batch;
+  }
+
+  uint64_t ParallelRowReaderImpl::getRowNumber() const {
+    return rowNumber;
+  }
+
+}  // namespace orc
@@ -0,0 +1,99 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ORC_PARALLEL_ROW_READER_HH
+#define ORC_PARALLEL_ROW_READER_HH
+
+#include "orc/Reader.hh"
+
+#include <atomic>
+#include <deque>
+#include <future>
+#include <memory>
+#include <vector>
+
+namespace orc {
+
+  class BufferPool;
+  struct FileContents;
+  class RowReaderImpl;
+  class ThreadPool;
+
+  class ParallelRowReaderImpl : public ParallelRowReader {
+   private:
+    // the batches of a stripe and the row numbers of their first rows
+    struct DecodedStripe {
+      std::vector<std::unique_ptr<ColumnVectorBatch>> batches;
+      std::vector<uint64_t> rowNumbers;
+    };
+
+    const std::shared_ptr<FileContents> contents;
+    const RowReaderOptions options;
+    const uint64_t batchSize;
+    const uint32_t threadCount;
+    // shared by the readers of the stripes, so that the read buffers of all
+    // stripes are bounded together and the threads are started once
+    std::shared_ptr<BufferPool> bufferPool;
+    std::shared_ptr<ThreadPool> decodePool;
+    // provides the selected type and columns
+    std::unique_ptr<RowReaderImpl> rowReader;
+    // the offsets and the row counts of the stripes in the range, in file order
+    std::vector<uint64_t> stripeOffsets;
+    std::vector<uint64_t> stripeRows;
+    size_t nextStripe;
+    // the rows in the scheduled stripes and the rows returned, bounded by the limit
+    uint64_t scheduledRows;
+    uint64_t returnedRows;
+    std::deque<std::future<std::unique_ptr<DecodedStripe>>> pending;
+    std::unique_ptr<DecodedStripe> currentStripe;
+    size_t currentBatch;
+    uint64_t rowNumber;
+    // tells the decoding threads to stop when the reader is destroyed
+    std::shared_ptr<std::atomic<bool>> cancelled;
+
+    static std::unique_ptr<DecodedStripe> decodeStripe(
+        std::shared_ptr<FileContents> contents, const RowReaderOptions& options,
+        std::shared_ptr<BufferPool> bufferPool, std::shared_ptr<ThreadPool> decodePool,
+        uint64_t stripeOffset, uint64_t limit, uint64_t batchSize,
+        std::shared_ptr<std::atomic<bool>> cancelled);
+
+    void schedule();
+
+   public:
+    /**
+     * @param contents of the file
+     * @param options options for reading
+     * @param batchSize the number of rows in each batch
+     * @param threadCount the number of stripes to decode concurrently
+     */
+    ParallelRowReaderImpl(std::shared_ptr<FileContents> contents, const RowReaderOptions& options,
+                          uint64_t batchSize, uint32_t threadCount);
+    ~ParallelRowReaderImpl() override;
+
+    const Type& getSelectedType() const override;
+
+    const std::vector<bool> getSelectedColumns() const override;
+
+    std::unique_ptr<ColumnVectorBatch> next() override;
+
+    uint64_t getRowNumber() const override;
+  };
+
+}  // namespace orc
+
+#endif
@@ -168,8 +168,16 @@ namespace orc {
 
   void RleDecoderV1::skipLongs(uint64_t numValues) {
     while (numValues > 0) {
-      if (readByte() >= 0) {
-        --numValues;
+      if (bufferStart == bufferEnd) {
+        // load the next buffer and put its first byte back
+        readByte();
+        --bufferStart;
+      }
+      // each value ends with the first byte that has the high bit clear
+      while (numValues > 0 && bufferStart != bufferEnd) {
+        if (static_cast<signed char>(*(bufferStart++)) >= 0) {
+          --numValues;
+        }
       }
     }
   }
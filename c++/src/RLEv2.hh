@@ -237,6 +237,14 @@ namespace orc {
     int64_t readVslong();
     uint64_t readVulong();
     void readLongs(int64_t* data, uint64_t offset, uint64_t len, uint64_t fbs);
+    void skipBytes(uint64_t numBytes);
+
+    /**
+     * Pass over the run that starts with firstByte using only its header,
+     * if the run has at most the given number of values.
+     * @return the length of the run or 0 if the run was not passed over
+     */
+    uint64_t skipRun(uint64_t numValues);
 
     template <typename T>
     uint64_t nextShortRepeats(T* data, uint64_t offset, uint64_t numValues, const char* notNull);
@@ -19,7 +19,9 @@
 #include "Reader.hh"
 #include "Adaptor.hh"
 #include "BloomFilter.hh"
+#include "FileTailCache.hh"
 #include "Options.hh"
+#include "ParallelRowReader.hh"
 #include "Statistics.hh"
 #include "StripeStream.hh"
 #include "Utils.hh"
@@ -247,13 +249,16 @@ namespace orc {
   }
 
   RowReaderImpl::RowReaderImpl(std::shared_ptr<FileContents> _contents,
-                               const RowReaderOptions& opts)
+                               const RowReaderOptions& opts,
+                               std::shared_ptr<BufferPool> _bufferPool,
+                               std::shared_ptr<ThreadPool> _decodePool)
       : localTimezone(getLocalTimezone()),
         contents(_contents),
         throwOnHive11DecimalOverflow(opts.getThrowOnHive11DecimalOverflow()),
         forcedScaleOnHive11Decimal(opts.getForcedScaleOnHive11Decimal()),
         footer(contents->footer.get()),
         firstRowOfStripe(*contents->pool, 0),
+        readerWriterTimezone(nullptr),
         enableEncodedBlock(opts.getEnableLazyDecoding()),
         readerTimezone(getTimezoneByName(opts.getTimezoneName())),
         schemaEvolution(opts.getReadType(), contents->schema.get()) {
@@ -266,6 +271,10 @@ namespace orc {
     numRowGroupsInStripeRange = 0;
     useTightNumericVector = opts.getUseTightNumericVector();
     throwOnSchemaEvolutionOverflow = opts.getThrowOnSchemaEvolutionOverflow();
+    coalesceReads = opts.getCoalesceReads();
+    coalesceMaxGap = opts.getCoalesceMaxGap();
+    rowLimit = opts.getLimit();
+    returnedRows = 0;
     uint64_t rowTotal = 0;
 
     firstRowOfStripe.resize(numberOfStripes);
@@ -312,6 +321,43 @@ namespace orc {
     }
 
     skipBloomFilters = hasBadBloomFilters();
+
+    if (opts.getPrefetchStripeCount() > 0) {
+      prefetcher = std::make_unique<StripePrefetcher>(
+          contents, selectedColumns, sargsApplier != nullptr, coalesceReads ? coalesceMaxGap : 0,
+          opts.getPrefetchStripeCount(), opts.getPrefetchMemoryBudget());
+    }
+
+    if (opts.getRowFilter()) {
+      if (enableEncodedBlock) {
+        throw ParseError("Row filters do not support lazy decoding");
+      }
+      rowFilter = opts.getRowFilter();
+      const Type& type = getSelectedType();
+      rowFilterFields.assign(type.getSubtypeCount(), false);
+      for (const auto& column : opts.getRowFilterColumns()) {
+        uint64_t field = 0;
+        while (field < type.getSubtypeCount() && type.getFieldName(field) != column) {
+          ++field;
+        }
+        if (field == type.getSubtypeCount()) {
+          throw ParseError("Row filter column " + column + " is not selected");
+        }
+        rowFilterFields[field] = true;
+      }
+    }
+
+    bufferPool = std::move(_bufferPool);
+    if (!bufferPool) {
+      bufferPool = std::make_shared<BufferPool>(*contents->pool, opts.getReadBufferMemoryLimit());
+    }
+    if (opts.getUseStripeArena()) {
+      stripeArena = std::make_unique<MemoryArena>(*contents->pool);
+    }
+    decodePool = std::move(_decodePool);
+    if (!decodePool && opts.getColumnDecodeThreadCount() > 1) {
+      decodePool = std::make_shared<ThreadPool>(opts.getColumnDecodeThreadCount());
+    }
   }
 
   // Check if the file has inconsistent bloom filters.
@@ -441,27 +487,36 @@ namespace orc {
     rowIndexes.clear();
     bloomFilterIndex.clear();
 
+    if (coalesceReads) {
+      loadStripeBuffers(/*includeIndexStreams=*/true, /*includeDataStreams=*/false);
+    }
+
     // obtain row indexes for selected columns
-    uint64_t offset = currentStripeInfo.offset();
-    for (int i = 0; i < currentStripeFooter.streams_size(); ++i) {
-      const proto::Stream& pbStream = currentStripeFooter.streams(i);
-      uint64_t colId = pbStream.column();
-      if (selectedColumns[colId] && pbStream.has_kind() &&
-          (pbStream.kind() == proto::Stream_Kind_ROW_INDEX ||
-           pbStream.kind() == proto::Stream_Kind_BLOOM_FILTER_UTF8)) {
+    for (uint64_t colId = 0; colId < selectedColumns.size(); ++colId) {
+      if (!selectedColumns[colId]) {
+        continue;
+      }
+      for (auto kind : {proto::Stream_Kind_ROW_INDEX, proto::Stream_Kind_BLOOM_FILTER_UTF8}) {
+        const StreamDirectory::Entry* stream = currentStripeStreams.find(colId, kind);
+        if (stream == nullptr ||
+            (kind == proto::Stream_Kind_BLOOM_FILTER_UTF8 && skipBloomFilters)) {
+          continue;
+        }
+        DecompressedChunkKey cacheKey = getChunkCacheKey(*contents, stream->offset);
         std::unique_ptr<SeekableInputStream> inStream = createDecompressor(
             getCompression(),
-            std::unique_ptr<SeekableInputStream>(new SeekableFileInputStream(
-                contents->stream.get(), offset, pbStream.length(), *contents->pool)),
-            getCompressionSize(), *contents->pool, contents->readerMetrics);
+            createStripeInputStream(stripeBuffers.get(), contents->stream.get(), stream->offset,
+                                    stream->length, *contents->pool, 0, bufferPool.get()),
+            getCompressionSize(), *contents->pool, contents->readerMetrics, &cacheKey,
+            bufferPool.get());
 
-        if (pbStream.kind() == proto::Stream_Kind_ROW_INDEX) {
+        if (kind == proto::Stream_Kind_ROW_INDEX) {
           proto::RowIndex rowIndex;
           if (!rowIndex.ParseFromZeroCopyStream(inStream.get())) {
             throw ParseError("Failed to parse the row index");
           }
           rowIndexes[colId] = rowIndex;
-        } else if (!skipBloomFilters) {  // Stream_Kind_BLOOM_FILTER_UTF8
+        } else {  // Stream_Kind_BLOOM_FILTER_UTF8
           proto::BloomFilterIndex pbBFIndex;
           if (!pbBFIndex.ParseFromZeroCopyStream(inStream.get())) {
             throw ParseError("Failed to parse bloom filter index");
@@ -469,17 +524,82 @@ namespace orc {
           BloomFilterIndex bfIndex;
           for (int j = 0; j < pbBFIndex.bloom_filter_size(); j++) {
             bfIndex.entries.push_back(BloomFilterUTF8Utils::deserialize(
-                pbStream.kind(), currentStripeFooter.columns(static_cast<int>(pbStream.column())),
+                kind, currentStripeFooter.columns(static_cast<int>(colId)),
                 pbBFIndex.bloom_filter(j)));
           }
           // add bloom filters to result for one column
-          bloomFilterIndex[pbStream.column()] = bfIndex;
+          bloomFilterIndex[colId] = bfIndex;
         }
       }
-      offset += pbStream.length();
     }
   }
 
+  void RowReaderImpl::loadStripeBuffers(bool includeIndexStreams, bool includeDataStreams) {
+    std::vector<ReadRange> planned;
+    std::vector<bool> selectedRowGroups;
+    if (!includeIndexStreams && includeDataStreams && pickRowGroupsToRead(selectedRowGroups)) {
+      // only read the parts of the streams that the selected row groups need
+      uint64_t blockSize = getCompression() == CompressionKind_NONE ? 0 : getCompressionSize();
+      planned = planRowGroupReads(currentStripeStreams, currentStripeFooter, *contents->schema,
+                                  selectedColumns, rowIndexes, selectedRowGroups, blockSize,
+                                  coalesceMaxGap);
+    } else {
+      planned = planStripeReads(currentStripeStreams, selectedColumns,
+                                includeIndexStreams, includeDataStreams, coalesceMaxGap);
+    }
+    if (!stripeBuffers) {
+      stripeBuffers = std::make_shared<StripeBuffers>();
+    }
+    // the ranges that were prefetched or read with the footer are skipped
+    stripeBuffers->load(*contents->stream, *contents->pool, planned);
+  }
+
+  bool RowReaderImpl::pickRowGroupsToRead(std::vector<bool>& selectedRowGroups) {
+    if (sargsApplier) {
+      if (!sargsApplier->hasSkipped()) {
+        return false;
+      }
+      for (uint64_t nextSkippedRow : sargsApplier->getNextSkippedRows()) {
+        selectedRowGroups.push_back(nextSkippedRow != 0);
+      }
+      return true;
+    }
+    uint64_t rowIndexStride = footer->row_index_stride();
+    uint64_t remainingRows = rowLimit - returnedRows;
+    if (!isLimitedInOrder() || rowIndexStride == 0 ||
+        remainingRows >= rowsInCurrentStripe - currentRowInStripe) {
+      return false;
+    }
+    // the limit ends within the stripe, so the row groups after it are not read
+    if (rowIndexes.empty()) {
+      loadStripeIndex();
+    }
+    selectedRowGroups.assign((rowsInCurrentStripe + rowIndexStride - 1) / rowIndexStride, false);
+    uint64_t endRow = currentRowInStripe + remainingRows;
+    for (uint64_t rowGroup = currentRowInStripe / rowIndexStride;
+         rowGroup * rowIndexStride < endRow; ++rowGroup) {
+      selectedRowGroups[rowGroup] = true;
+    }
+    return true;
+  }
+
+  bool RowReaderImpl::isLimitedInOrder() const {
+    return rowLimit != std::numeric_limits<uint64_t>::max() && !sargsApplier && !rowFilter;
+  }
+
+  uint64_t RowReaderImpl::getLimitedLastStripe() const {
+    if (!isLimitedInOrder()) {
+      return lastStripe;
+    }
+    uint64_t endRow = firstRowOfStripe[currentStripe] + currentRowInStripe;
+    endRow += std::min(rowLimit - returnedRows, footer->number_of_rows() - endRow);
+    uint64_t stripe = currentStripe + 1;
+    while (stripe < lastStripe && firstRowOfStripe[stripe] < endRow) {
+      ++stripe;
+    }
+    return stripe;
+  }
+
   void RowReaderImpl::seekToRowGroup(uint32_t rowGroupEntryId) {
     // store positions for selected columns
     std::list<std::list<uint64_t>> positions;
@@ -519,14 +639,19 @@ namespace orc {
     return forcedScaleOnHive11Decimal;
   }
 
+  DecompressedChunkKey getChunkCacheKey(const FileContents& contents, uint64_t streamOffset) {
+    return {contents.cacheKey, contents.stream->getLength(), streamOffset, 0};
+  }
+
   proto::StripeFooter getStripeFooter(const proto::StripeInformation& info,
-                                      const FileContents& contents) {
+                                      const FileContents& contents,
+                                      const StripeBuffers* buffers) {
     uint64_t stripeFooterStart = info.offset() + info.index_length() + info.data_length();
     uint64_t stripeFooterLength = info.footer_length();
     std::unique_ptr<SeekableInputStream> pbStream = createDecompressor(
         contents.compression,
-        std::make_unique<SeekableFileInputStream>(contents.stream.get(), stripeFooterStart,
-                                                  stripeFooterLength, *contents.pool),
+        createStripeInputStream(buffers, contents.stream.get(), stripeFooterStart,
+                                stripeFooterLength, *contents.pool),
         contents.blockSize, *contents.pool, contents.readerMetrics);
     proto::StripeFooter result;
     if (!result.ParseFromZeroCopyStream(pbStream.get())) {
@@ -549,7 +674,8 @@ namespace orc {
         fileLength(_fileLength),
         postscriptLength(_postscriptLength),
         footer(contents->footer.get()) {
-    isMetadataLoaded = false;
+    // the metadata may come with a cached tail
+    isMetadataLoaded = contents->metadata != nullptr;
     checkOrcVersion();
     numberOfStripes = static_cast<uint64_t>(footer->stripes_size());
     contents->schema = convertType(footer->types(0), *footer);
@@ -808,10 +934,15 @@ namespace orc {
           std::make_unique<SeekableFileInputStream>(contents->stream.get(), metadataStart,
                                                     metadataSize, *contents->pool),
           contents->blockSize, *contents->pool, contents->readerMetrics);
-      contents->metadata.reset(new proto::Metadata());
-      if (!contents->metadata->ParseFromZeroCopyStream(pbStream.get())) {
+      auto metadata = std::make_shared<proto::Metadata>();
+      if (!metadata->ParseFromZeroCopyStream(pbStream.get())) {
         throw ParseError("Failed to parse the metadata");
       }
+      contents->metadata = metadata;
+      FileTailCacheImpl& tailCache = getFileTailCacheImpl();
+      if (tailCache.isEnabled() && !contents->cacheKey.empty()) {
+        tailCache.putMetadata({contents->cacheKey, fileLength}, contents->metadata);
+      }
     }
     isMetadataLoaded = true;
   }
@@ -842,6 +973,15 @@ namespace orc {
     return std::make_unique<RowReaderImpl>(contents, opts);
   }
 
+  std::unique_ptr<ParallelRowReader> ReaderImpl::createParallelRowReader(
+      const RowReaderOptions& opts, uint64_t batchSize, uint32_t threadCount) const {
+    if (opts.getSearchArgument() && !isMetadataLoaded) {
+      // load stripe statistics for PPD
+      readMetadata();
+    }
+    return std::make_unique<ParallelRowReaderImpl>(contents, opts, batchSize, threadCount);
+  }
+
   uint64_t maxStreamsForType(const proto::Type& type) {
     switch (static_cast<int64_t>(type.kind())) {
       case proto::Type_Kind_STRUCT:
@@ -1023,8 +1163,36 @@ namespace orc {
     }
   }
 
+  std::vector<int> RowReaderImpl::getSelectedEncodings() const {
+    std::vector<int> encodings(selectedColumns.size(), -1);
+    for (uint64_t column = 0; column < selectedColumns.size(); ++column) {
+      if (selectedColumns[column]) {
+        if (column >= static_cast<uint64_t>(currentStripeFooter.columns_size())) {
+          return {};
+        }
+        encodings[column] = currentStripeFooter.columns(static_cast<int>(column)).kind();
+      }
+    }
+    return encodings;
+  }
+
+  void RowReaderImpl::resetStripeArena() {
+    if (stripeArena) {
+      MemoryPoolStats stats;
+      stripeArena->getStats(stats);
+      ReaderMetrics* metrics = contents->readerMetrics;
+      if (metrics != nullptr && stats.peakAllocatedBytes > metrics->StripeArenaPeakBytes.load()) {
+        metrics->StripeArenaPeakBytes.store(stats.peakAllocatedBytes);
+      }
+      stripeArena->reset();
+    }
+  }
+
   void RowReaderImpl::startNextStripe() {
-    reader.reset();  // ColumnReaders use lots of memory; free old memory first
+    // The column readers are kept to be moved to the next stripe if its
+    // encodings are the same. Their streams refer to the buffers of the
+    // previous stripe, which are released here, and are not read again.
+    stripeBuffers.reset();
     rowIndexes.clear();
     bloomFilterIndex.clear();
 
@@ -1050,7 +1218,29 @@ namespace orc {
             << ", footerLength=" << currentStripeInfo.footer_length() << ")";
         throw ParseError(msg.str());
       }
-      currentStripeFooter = getStripeFooter(currentStripeInfo, *contents.get());
+      std::shared_ptr<PrefetchedStripe> prefetchedStripe;
+      if (prefetcher) {
+        prefetchedStripe = prefetcher->take(currentStripe);
+        // keep reading ahead while the current stripe is decoded
+        prefetcher->schedule(currentStripe + 1, getLimitedLastStripe());
+      }
+      if (prefetchedStripe) {
+        currentStripeFooter = prefetchedStripe->getFooter();
+        currentStripeStreams = prefetchedStripe->getStreams();
+        stripeBuffers = prefetchedStripe->getBuffers();
+      } else {
+        stripeBuffers.reset();
+        if (coalesceReads) {
+          // read the sections of a small stripe with its footer
+          stripeBuffers = std::make_shared<StripeBuffers>();
+          stripeBuffers->load(
+              *contents->stream, *contents->pool,
+              planStripeFooterReads(currentStripeInfo, sargsApplier != nullptr, coalesceMaxGap));
+        }
+        currentStripeFooter =
+            getStripeFooter(currentStripeInfo, *contents.get(), stripeBuffers.get());
+        currentStripeStreams = StreamDirectory(currentStripeInfo, currentStripeFooter);
+      }
       rowsInCurrentStripe = currentStripeInfo.number_of_rows();
       processingStripe = currentStripe;
 
@@ -1092,11 +1282,25 @@ namespace orc {
           currentStripeFooter.has_writer_timezone()
               ? getTimezoneByName(currentStripeFooter.writer_timezone())
               : localTimezone;
+      if (coalesceReads) {
+        loadStripeBuffers(/*includeIndexStreams=*/false, /*includeDataStreams=*/true);
+      }
       StripeStreamsImpl stripeStreams(*this, currentStripe, currentStripeInfo, currentStripeFooter,
-                                      currentStripeInfo.offset(), *contents->stream, writerTimezone,
+                                      currentStripeStreams, *contents->stream, writerTimezone,
                                       readerTimezone);
-      reader = buildReader(*contents->schema, stripeStreams, useTightNumericVector,
-                           throwOnSchemaEvolutionOverflow, /*convertToReadType=*/true);
+      std::vector<int> encodings = getSelectedEncodings();
+      if (reader && !stripeArena && !encodings.empty() && encodings == readerEncodings &&
+          &writerTimezone == readerWriterTimezone) {
+        // reuse the column readers and their buffers
+        reader->rebind(stripeStreams);
+      } else {
+        reader.reset();  // ColumnReaders use lots of memory; free old memory first
+        resetStripeArena();
+        reader = buildReader(*contents->schema, stripeStreams, useTightNumericVector,
+                             throwOnSchemaEvolutionOverflow, /*convertToReadType=*/true);
+        readerEncodings = std::move(encodings);
+        readerWriterTimezone = &writerTimezone;
+      }
 
       if (sargsApplier) {
         // move to the 1st selected row group when PPD is enabled.
@@ -1110,59 +1314,70 @@ namespace orc {
       }
     } else {
       // All remaining stripes are skipped.
+      reader.reset();
+      resetStripeArena();
       markEndOfFile();
     }
   }
 
   bool RowReaderImpl::next(ColumnVectorBatch& data) {
     SCOPED_STOPWATCH(contents->readerMetrics, ReaderInclusiveLatencyUs, ReaderCall);
-    if (currentStripe >= lastStripe) {
-      data.numElements = 0;
-      markEndOfFile();
-      return false;
-    }
-    if (currentRowInStripe == 0) {
-      startNextStripe();
-    }
-    uint64_t rowsToRead =
-        std::min(static_cast<uint64_t>(data.capacity), rowsInCurrentStripe - currentRowInStripe);
-    if (sargsApplier && rowsToRead > 0) {
-      rowsToRead = computeBatchSize(rowsToRead, currentRowInStripe, rowsInCurrentStripe,
-                                    footer->row_index_stride(), sargsApplier->getNextSkippedRows());
-    }
-    data.numElements = rowsToRead;
-    if (rowsToRead == 0) {
-      markEndOfFile();
-      return false;
-    }
-    if (enableEncodedBlock) {
-      reader->nextEncoded(data, rowsToRead, nullptr);
-    } else {
-      reader->next(data, rowsToRead, nullptr);
-    }
-    // update row number
-    previousRow = firstRowOfStripe[currentStripe] + currentRowInStripe;
-    currentRowInStripe += rowsToRead;
+    // a filter may drop all the rows of a batch, which are not returned
+    do {
+      if (currentStripe >= lastStripe || returnedRows >= rowLimit) {
+        data.numElements = 0;
+        markEndOfFile();
+        return false;
+      }
+      if (currentRowInStripe == 0) {
+        startNextStripe();
+      }
+      uint64_t rowsToRead =
+          std::min(static_cast<uint64_t>(data.capacity), rowsInCurrentStripe - currentRowInStripe);
+      rowsToRead = std::min(rowsToRead, rowLimit - returnedRows);
+      if (sargsApplier && rowsToRead > 0) {
+        rowsToRead =
+            computeBatchSize(rowsToRead, currentRowInStripe, rowsInCurrentStripe,
+                             footer->row_index_stride(), sargsApplier->getNextSkippedRows());
+      }
+      data.numElements = rowsToRead;
+      if (rowsToRead == 0) {
+        markEndOfFile();
+        return false;
+      }
+      if (rowFilter) {
+        data.numElements = nextFiltered(*reader, data, rowsToRead, rowFilterFields, rowFilter);
+      } else if (enableEncodedBlock) {
+        reader->nextEncoded(data, rowsToRead, nullptr);
+      } else {
+        reader->next(data, rowsToRead, nullptr);
+      }
+      // update row number
+      previousRow = firstRowOfStripe[currentStripe] + currentRowInStripe;
+      currentRowInStripe += rowsToRead;
 
-    // check if we need to advance to next selected row group
-    if (sargsApplier) {
-      uint64_t nextRowToRead =
-          advanceToNextRowGroup(currentRowInStripe, rowsInCurrentStripe, footer->row_index_stride(),
-                                sargsApplier->getNextSkippedRows());
-      if (currentRowInStripe != nextRowToRead) {
-        // it is guaranteed to be at start of a row group
-        currentRowInStripe = nextRowToRead;
-        if (currentRowInStripe < rowsInCurrentStripe) {
-          seekToRowGroup(static_cast<uint32_t>(currentRowInStripe / footer->row_index_stride()));
+      // check if we need to advance to next selected row group
+      if (sargsApplier) {
+        uint64_t nextRowToRead =
+            advanceToNextRowGroup(currentRowInStripe, rowsInCurrentStripe,
+                                  footer->row_index_stride(), sargsApplier->getNextSkippedRows());
+        if (currentRowInStripe != nextRowToRead) {
+          // it is guaranteed to be at start of a row group
+          currentRowInStripe = nextRowToRead;
+          if (currentRowInStripe < rowsInCurrentStripe) {
+            seekToRowGroup(static_cast<uint32_t>(currentRowInStripe / footer->row_index_stride()));
+          }
         }
       }
-    }
 
-    if (currentRowInStripe >= rowsInCurrentStripe) {
-      currentStripe += 1;
-      currentRowInStripe = 0;
-    }
-    return rowsToRead != 0;
+      if (currentRowInStripe >= rowsInCurrentStripe) {
+        currentStripe += 1;
+        currentRowInStripe = 0;
+      }
+    } while (data.numElements == 0);
+    returnedRows += data.numElements;
+    updateMemoryPoolMetrics(*contents->pool, contents->readerMetrics);
+    return true;
   }
 
   uint64_t RowReaderImpl::computeBatchSize(uint64_t requestedSize, uint64_t currentRowInStripe,
@@ -1355,12 +1570,50 @@ namespace orc {
     return footer;
   }
 
+  /**
+   * Read and parse the postscript and the footer at the end of the file.
+   * @return the length of the postscript
+   */
+  static uint64_t readFileTail(InputStream* stream, FileContents& contents, uint64_t fileLength) {
+    // read last bytes into buffer to get PostScript
+    uint64_t readSize = std::min(fileLength, DIRECTORY_SIZE_GUESS);
+    if (readSize < 4) {
+      throw ParseError("File size too small");
+    }
+    auto buffer = std::make_unique<DataBuffer<char>>(*contents.pool, readSize);
+    stream->read(buffer->data(), readSize, fileLength - readSize);
+
+    uint64_t postscriptLength = buffer->data()[readSize - 1] & 0xff;
+    contents.postscript = readPostscript(stream, buffer.get(), postscriptLength);
+    uint64_t footerSize = contents.postscript->footer_length();
+    uint64_t tailSize = 1 + postscriptLength + footerSize;
+    if (tailSize >= fileLength) {
+      std::stringstream msg;
+      msg << "Invalid ORC tailSize=" << tailSize << ", fileLength=" << fileLength;
+      throw ParseError(msg.str());
+    }
+    uint64_t footerOffset;
+
+    if (tailSize > readSize) {
+      buffer->resize(footerSize);
+      stream->read(buffer->data(), footerSize, fileLength - tailSize);
+      footerOffset = 0;
+    } else {
+      footerOffset = readSize - tailSize;
+    }
+
+    contents.footer = readFooter(stream, buffer.get(), footerOffset, *contents.postscript,
+                                 *contents.pool, contents.readerMetrics);
+    return postscriptLength;
+  }
+
   std::unique_ptr<Reader> createReader(std::unique_ptr<InputStream> stream,
                                        const ReaderOptions& options) {
     auto contents = std::make_shared<FileContents>();
     contents->pool = options.getMemoryPool();
     contents->errorStream = options.getErrorStream();
     contents->readerMetrics = options.getReaderMetrics();
+    contents->cacheKey = options.getCacheKey();
     std::string serializedFooter = options.getSerializedFileTail();
     uint64_t fileLength;
     uint64_t postscriptLength;
@@ -1377,36 +1630,27 @@ namespace orc {
     } else {
       // figure out the size of the file using the option or filesystem
       fileLength = std::min(options.getTailLocation(), static_cast<uint64_t>(stream->getLength()));
-
-      // read last bytes into buffer to get PostScript
-      uint64_t readSize = std::min(fileLength, DIRECTORY_SIZE_GUESS);
-      if (readSize < 4) {
-        throw ParseError("File size too small");
+      FileTailCacheImpl& tailCache = getFileTailCacheImpl();
+      FileTailCacheImpl::Key tailKey{contents->cacheKey, fileLength};
+      // the name of the stream does not identify the file, so only the
+      // readers with a cache key use the cache
+      bool useTailCache = tailCache.isEnabled() && !contents->cacheKey.empty();
+      std::shared_ptr<const CachedFileTail> cachedTail;
+      if (useTailCache) {
+        cachedTail = tailCache.get(tailKey, contents->readerMetrics);
       }
-      auto buffer = std::make_unique<DataBuffer<char>>(*contents->pool, readSize);
-      stream->read(buffer->data(), readSize, fileLength - readSize);
-
-      postscriptLength = buffer->data()[readSize - 1] & 0xff;
-      contents->postscript = readPostscript(stream.get(), buffer.get(), postscriptLength);
-      uint64_t footerSize = contents->postscript->footer_length();
-      uint64_t tailSize = 1 + postscriptLength + footerSize;
-      if (tailSize >= fileLength) {
-        std::stringstream msg;
-        msg << "Invalid ORC tailSize=" << tailSize << ", fileLength=" << fileLength;
-        throw ParseError(msg.str());
-      }
-      uint64_t footerOffset;
-
-      if (tailSize > readSize) {
-        buffer->resize(footerSize);
-        stream->read(buffer->data(), footerSize, fileLength - tailSize);
-        footerOffset = 0;
+      if (cachedTail != nullptr) {
+        contents->postscript = cachedTail->postscript;
+        contents->footer = cachedTail->footer;
+        contents->metadata = cachedTail->metadata;
+        postscriptLength = cachedTail->postscriptLength;
       } else {
-        footerOffset = readSize - tailSize;
+        postscriptLength = readFileTail(stream.get(), *contents, fileLength);
+        if (useTailCache) {
+          tailCache.put(tailKey,
+                        {contents->postscript, contents->footer, nullptr, postscriptLength});
+        }
       }
-
-      contents->footer = readFooter(stream.get(), buffer.get(), footerOffset, *contents->postscript,
-                                    *contents->pool, contents->readerMetrics);
     }
     contents->isDecimalAsLong = false;
     if (contents->postscript->version_size() == 2) {
@@ -1479,6 +1723,11 @@ namespace orc {
     // PASS
   }
 
+  std::unique_ptr<ParallelRowReader> Reader::createParallelRowReader(const RowReaderOptions&,
+                                                                     uint64_t, uint32_t) const {
+    throw NotImplementedYet("createParallelRowReader is not supported by this reader");
+  }
+
   InputStream::~InputStream(){
       // PASS
   };
@@ -24,9 +24,14 @@
 #include "orc/OrcFile.hh"
 #include "orc/Reader.hh"
 
+#include "BufferPool.hh"
 #include "ColumnReader.hh"
+#include "DecompressedChunkCache.hh"
+#include "MemoryArena.hh"
 #include "RLE.hh"
 #include "SchemaEvolution.hh"
+#include "StripePrefetcher.hh"
+#include "ThreadPool.hh"
 #include "TypeImpl.hh"
 #include "sargs/SargsApplier.hh"
 
@@ -58,8 +63,8 @@ namespace orc {
    */
   struct FileContents {
     std::unique_ptr<InputStream> stream;
-    std::unique_ptr<proto::PostScript> postscript;
-    std::unique_ptr<proto::Footer> footer;
+    std::shared_ptr<const proto::PostScript> postscript;
+    std::shared_ptr<const proto::Footer> footer;
     std::unique_ptr<Type> schema;
     uint64_t blockSize;
     CompressionKind compression;
@@ -68,12 +73,29 @@ namespace orc {
     /// Decimal64 in ORCv2 uses RLE to store values. This flag indicates whether
     /// this new encoding is used.
     bool isDecimalAsLong;
-    std::unique_ptr<proto::Metadata> metadata;
+    std::shared_ptr<const proto::Metadata> metadata;
     ReaderMetrics* readerMetrics;
+    // the key of the file in the caches given by ReaderOptions::setCacheKey()
+    std::string cacheKey;
   };
 
+  /**
+   * Read and check the footer of a stripe.
+   * @param info the stripe
+   * @param contents of the file
+   * @param buffers the loaded bytes of the stripe, which the footer is served
+   *        from when they hold it; may be nullptr
+   */
   proto::StripeFooter getStripeFooter(const proto::StripeInformation& info,
-                                      const FileContents& contents);
+                                      const FileContents& contents,
+                                      const StripeBuffers* buffers = nullptr);
+
+  /**
+   * Get the key of a stream of the file in the decompressed chunk cache.
+   * @param contents of the file
+   * @param streamOffset the offset of the stream in the file
+   */
+  DecompressedChunkKey getChunkCacheKey(const FileContents& contents, uint64_t streamOffset);
 
   class ReaderImpl;
   class Timezone;
@@ -138,7 +160,7 @@ namespace orc {
     std::vector<bool> selectedColumns;
 
     // footer
-    proto::Footer* footer;
+    const proto::Footer* footer;
     DataBuffer<uint64_t> firstRowOfStripe;
     mutable std::unique_ptr<Type> selectedSchema;
     bool skipBloomFilters;
@@ -155,15 +177,45 @@ namespace orc {
     uint64_t numRowGroupsInStripeRange;
     proto::StripeInformation currentStripeInfo;
     proto::StripeFooter currentStripeFooter;
+    // the streams of the current stripe by column and kind
+    StreamDirectory currentStripeStreams;
+    // reads the following stripes ahead of time if prefetching is enabled
+    std::unique_ptr<StripePrefetcher> prefetcher;
+    // the loaded bytes of the current stripe, which the column readers may refer to
+    std::shared_ptr<StripeBuffers> stripeBuffers;
+    // holds the memory of the column readers of a stripe if enabled, outlives them
+    std::unique_ptr<MemoryArena> stripeArena;
+    // lends the read and decompression buffers of the streams, outlives the column readers
+    std::shared_ptr<BufferPool> bufferPool;
+    // decodes the columns of a batch concurrently if enabled, outlives the column readers
+    std::shared_ptr<ThreadPool> decodePool;
     std::unique_ptr<ColumnReader> reader;
+    // the encodings of the selected columns and the writer timezone that the
+    // column readers were built for, so that they can move to the next stripe
+    std::vector<int> readerEncodings;
+    const Timezone* readerWriterTimezone;
 
     bool enableEncodedBlock;
     bool useTightNumericVector;
     bool throwOnSchemaEvolutionOverflow;
+    bool coalesceReads;
+    uint64_t coalesceMaxGap;
+    // selects the rows to return and whether each selected field is read by it
+    RowFilter rowFilter;
+    std::vector<bool> rowFilterFields;
+    // the largest number of rows to return and the number returned so far
+    uint64_t rowLimit;
+    uint64_t returnedRows;
     // internal methods
     void startNextStripe();
+    // free the memory of the dropped column readers if they use an arena
+    void resetStripeArena();
     inline void markEndOfFile();
 
+    // Get the encodings of the selected columns in the current stripe, or
+    // nothing if the stripe footer lacks some of them.
+    std::vector<int> getSelectedEncodings() const;
+
     // row index of current stripe with column id as the key
     std::unordered_map<uint64_t, proto::RowIndex> rowIndexes;
     std::map<uint32_t, BloomFilterIndex> bloomFilterIndex;
@@ -179,6 +231,22 @@ namespace orc {
     // load stripe index if not done so
     void loadStripeIndex();
 
+    // read the planned ranges of the selected streams of the current stripe
+    // into stripeBuffers with a few large requests; when PPD has skipped row
+    // groups only the parts of the data streams of the others are read
+    void loadStripeBuffers(bool includeIndexStreams, bool includeDataStreams);
+
+    // Pick the row groups of the current stripe that are read, when PPD skips
+    // some of them or the limit ends within the stripe.
+    // @return false if all row groups from the current row on are read
+    bool pickRowGroupsToRead(std::vector<bool>& selectedRowGroups);
+
+    // whether the rows are returned in order, so that the limit bounds the reads
+    bool isLimitedInOrder() const;
+
+    // the stripe after the last one that the remaining rows of the limit need
+    uint64_t getLimitedLastStripe() const;
+
     // In case of PPD, batch size should be aware of row group boundaries.
     // If only a subset of row groups are selected then the next read should
     // stop at the end of selected range.
@@ -217,8 +285,14 @@ namespace orc {
      * Constructor that lets the user specify additional options.
      * @param contents of the file
      * @param options options for reading
+     * @param bufferPool the pool to borrow the read buffers from, which other
+     *        readers may share; nullptr creates one of the read buffer memory limit
+     * @param decodePool the threads to decode the columns on, which other
+     *        readers may share; nullptr creates them if the options ask for them
      */
-    RowReaderImpl(std::shared_ptr<FileContents> contents, const RowReaderOptions& options);
+    RowReaderImpl(std::shared_ptr<FileContents> contents, const RowReaderOptions& options,
+                  std::shared_ptr<BufferPool> bufferPool = nullptr,
+                  std::shared_ptr<ThreadPool> decodePool = nullptr);
 
     // Select the columns from the options object
     const std::vector<bool> getSelectedColumns() const override;
@@ -245,6 +319,23 @@ namespace orc {
     const SchemaEvolution* getSchemaEvolution() const {
       return &schemaEvolution;
     }
+
+    const StripeBuffers* getStripeBuffers() const {
+      return stripeBuffers.get();
+    }
+
+    ThreadPool* getDecodePool() const {
+      return decodePool.get();
+    }
+
+    BufferPool* getBufferPool() const {
+      return bufferPool.get();
+    }
+
+    // the pool that the column readers allocate from
+    MemoryPool& getColumnMemoryPool() const {
+      return stripeArena ? *stripeArena : *contents->pool;
+    }
   };
 
   class ReaderImpl : public Reader {
@@ -258,7 +349,7 @@ namespace orc {
     const uint64_t postscriptLength;
 
     // footer
-    proto::Footer* footer;
+    const proto::Footer* footer;
     uint64_t numberOfStripes;
     uint64_t getMemoryUse(int stripeIx, std::vector<bool>& selectedColumns);
 
@@ -324,6 +415,10 @@ namespace orc {
 
     std::unique_ptr<RowReader> createRowReader(const RowReaderOptions& options) const override;
 
+    std::unique_ptr<ParallelRowReader> createParallelRowReader(const RowReaderOptions& options,
+                                                               uint64_t batchSize,
+                                                               uint32_t threadCount) const override;
+
     uint64_t getContentLength() const override;
     uint64_t getStripeStatisticsLength() const override;
     uint64_t getFileFooterLength() const override;
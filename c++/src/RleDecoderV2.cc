@@ -17,6 +17,7 @@
  */
 
 #include "Adaptor.hh"
+#include "BpackingAvx2.hh"
 #include "BpackingDefault.hh"
 #if defined(ORC_HAVE_RUNTIME_AVX512)
 #include "BpackingAvx512.hh"
@@ -25,6 +26,11 @@
 #include "Dispatch.hh"
 #include "RLEV2Util.hh"
 #include "RLEv2.hh"
+#include "RleV2Avx2.hh"
+#if defined(ORC_HAVE_RUNTIME_AVX512)
+#include "RleV2Avx512.hh"
+#endif
+#include "RleV2Default.hh"
 #include "Utils.hh"
 
 namespace orc {
@@ -75,12 +81,14 @@ namespace orc {
     using FunctionType = decltype(&BitUnpack::readLongs);
 
     static std::vector<std::pair<DispatchLevel, FunctionType>> implementations() {
-#if defined(ORC_HAVE_RUNTIME_AVX512)
       return {{DispatchLevel::NONE, BitUnpackDefault::readLongs},
-              {DispatchLevel::AVX512, BitUnpackAVX512::readLongs}};
-#else
-      return {{DispatchLevel::NONE, BitUnpackDefault::readLongs}};
+#if defined(ORC_HAVE_RUNTIME_AVX2)
+              {DispatchLevel::AVX2, BitUnpackAVX2::readLongs},
+#endif
+#if defined(ORC_HAVE_RUNTIME_AVX512)
+              {DispatchLevel::AVX512, BitUnpackAVX512::readLongs},
 #endif
+      };
     }
   };
 
@@ -89,6 +97,65 @@ namespace orc {
     return dispatch.func(this, data, offset, len, fbs);
   }
 
+  struct PrefixSumDynamicFunction {
+    using FunctionType = decltype(&RleV2Default::prefixSum);
+
+    static std::vector<std::pair<DispatchLevel, FunctionType>> implementations() {
+      return {{DispatchLevel::NONE, RleV2Default::prefixSum},
+#if defined(ORC_HAVE_RUNTIME_AVX2)
+              {DispatchLevel::AVX2, RleV2AVX2::prefixSum},
+#endif
+#if defined(ORC_HAVE_RUNTIME_AVX512)
+              {DispatchLevel::AVX512, RleV2AVX512::prefixSum},
+#endif
+      };
+    }
+  };
+
+  static void prefixSum(int64_t* data, uint64_t numValues, int64_t previous, bool decreasing) {
+    static DynamicDispatch<PrefixSumDynamicFunction> dispatch;
+    dispatch.func(data, numValues, previous, decreasing);
+  }
+
+  struct UnZigZagDynamicFunction {
+    using FunctionType = decltype(&RleV2Default::unZigZag);
+
+    static std::vector<std::pair<DispatchLevel, FunctionType>> implementations() {
+      return {{DispatchLevel::NONE, RleV2Default::unZigZag},
+#if defined(ORC_HAVE_RUNTIME_AVX2)
+              {DispatchLevel::AVX2, RleV2AVX2::unZigZag},
+#endif
+#if defined(ORC_HAVE_RUNTIME_AVX512)
+              {DispatchLevel::AVX512, RleV2AVX512::unZigZag},
+#endif
+      };
+    }
+  };
+
+  static void unZigZagLongs(int64_t* data, uint64_t numValues) {
+    static DynamicDispatch<UnZigZagDynamicFunction> dispatch;
+    dispatch.func(data, numValues);
+  }
+
+  struct ApplyPatchesDynamicFunction {
+    using FunctionType = decltype(&RleV2Default::applyPatches);
+
+    static std::vector<std::pair<DispatchLevel, FunctionType>> implementations() {
+#if defined(ORC_HAVE_RUNTIME_AVX512)
+      return {{DispatchLevel::NONE, RleV2Default::applyPatches},
+              {DispatchLevel::AVX512, RleV2AVX512::applyPatches}};
+#else
+      return {{DispatchLevel::NONE, RleV2Default::applyPatches}};
+#endif
+    }
+  };
+
+  static void applyPatches(int64_t* data, const int64_t* positions, const int64_t* patches,
+                           uint64_t numPatches, uint32_t shift) {
+    static DynamicDispatch<ApplyPatchesDynamicFunction> dispatch;
+    dispatch.func(data, positions, patches, numPatches, shift);
+  }
+
   RleDecoderV2::RleDecoderV2(std::unique_ptr<SeekableInputStream> input, bool _isSigned,
                              MemoryPool& pool, ReaderMetrics* _metrics)
       : RleDecoder(_metrics),
@@ -117,18 +184,109 @@ namespace orc {
   }
 
   void RleDecoderV2::skip(uint64_t numValues) {
-    // simple for now, until perf tests indicate something encoding specific is
-    // needed
-    const uint64_t N = 64;
-    int64_t dummy[N];
-
-    while (numValues) {
-      uint64_t nRead = std::min(N, numValues);
-      next(dummy, nRead, nullptr);
-      numValues -= nRead;
+    SCOPED_STOPWATCH(metrics, DecodingLatencyUs, DecodingCall);
+    while (numValues > 0) {
+      if (runRead == runLength) {
+        resetRun();
+        firstByte = readByte();
+        uint64_t skipped = skipRun(numValues);
+        if (skipped > 0) {
+          numValues -= skipped;
+          continue;
+        }
+        // decode the run that the skip ends in
+        EncodingType enc = static_cast<EncodingType>((firstByte >> 6) & 0x03);
+        switch (static_cast<int64_t>(enc)) {
+          case SHORT_REPEAT:
+            nextShortRepeats<int64_t>(nullptr, 0, 0, nullptr);
+            break;
+          case DIRECT:
+            nextDirect<int64_t>(nullptr, 0, 0, nullptr);
+            break;
+          case PATCHED_BASE:
+            nextPatched<int64_t>(nullptr, 0, 0, nullptr);
+            break;
+          case DELTA:
+            nextDelta<int64_t>(nullptr, 0, 0, nullptr);
+            break;
+          default:
+            throw ParseError("unknown encoding");
+        }
+      }
+      uint64_t count = std::min(numValues, runLength - runRead);
+      runRead += count;
+      numValues -= count;
+    }
+  }
+
+  void RleDecoderV2::skipBytes(uint64_t numBytes) {
+    while (numBytes > 0) {
+      if (bufferStart == bufferEnd) {
+        // load the next buffer and put its first byte back
+        readByte();
+        --bufferStart;
+      }
+      uint64_t count = std::min(numBytes, static_cast<uint64_t>(bufferEnd - bufferStart));
+      bufferStart += count;
+      numBytes -= count;
     }
   }
 
+  uint64_t RleDecoderV2::skipRun(uint64_t numValues) {
+    EncodingType enc = static_cast<EncodingType>((firstByte >> 6) & 0x03);
+    if (enc == SHORT_REPEAT) {
+      uint64_t length = (firstByte & 0x07) + MIN_REPEAT;
+      if (length > numValues) {
+        return 0;
+      }
+      skipBytes(((firstByte >> 3) & 0x07) + 1);
+      return length;
+    }
+
+    // the other encodings keep the low bits of the run length in the second byte
+    uint64_t length = (static_cast<uint64_t>(firstByte & 0x01) << 8 | readByte()) + 1;
+    if (length > numValues) {
+      // put the byte back for the decoder
+      --bufferStart;
+      return 0;
+    }
+    unsigned char fbo = (firstByte >> 1) & 0x1f;
+    uint64_t bitSize = decodeBitWidth(fbo);
+    if (enc == DIRECT) {
+      skipBytes((length * bitSize + 7) / 8);
+    } else if (enc == PATCHED_BASE) {
+      unsigned char thirdByte = readByte();
+      unsigned char fourthByte = readByte();
+      uint64_t byteSize = ((thirdByte >> 5) & 0x07) + 1;
+      uint32_t patchBitSize = decodeBitWidth(thirdByte & 0x1f);
+      uint32_t pgw = ((fourthByte >> 5) & 0x07) + 1;
+      uint64_t pl = fourthByte & 0x1f;
+      if (pl == 0) {
+        throw ParseError("Corrupt PATCHED_BASE encoded data (pl==0)!");
+      }
+      if ((patchBitSize + pgw) > 64) {
+        throw ParseError(
+            "Corrupt PATCHED_BASE encoded data "
+            "(patchBitSize + pgw > 64)!");
+      }
+      skipBytes(byteSize + (length * bitSize + 7) / 8 +
+                (pl * getClosestFixedBits(patchBitSize + pgw) + 7) / 8);
+    } else {
+      // the first value and the delta base are varints
+      readVulong();
+      readVulong();
+      if (fbo != 0) {
+        if (length < 2) {
+          std::stringstream ss;
+          ss << "Illegal run length for delta encoding: " << length;
+          throw ParseError(ss.str());
+        }
+        skipBytes(((length - 2) * bitSize + 7) / 8);
+      }
+    }
+    return length;
+  }
+
   template <typename T>
   void RleDecoderV2::next(T* const data, const uint64_t numValues, const char* const notNull) {
     SCOPED_STOPWATCH(metrics, DecodingLatencyUs, DecodingCall);
@@ -238,9 +396,8 @@ namespace orc {
 
       readLongs(literals.data(), 0, runLength, bitSize);
       if (isSigned) {
-        for (uint64_t i = 0; i < runLength; ++i) {
-          literals[i] = unZigZag(static_cast<uint64_t>(literals[i]));
-        }
+        // decode the values while they are still in the cache
+        unZigZagLongs(literals.data(), runLength);
       }
     }
 
@@ -337,32 +494,30 @@ namespace orc {
       // apply the patch directly when decoding the packed data
       int64_t patchMask = ((static_cast<int64_t>(1) << patchBitSize) - 1);
 
-      int64_t gap = 0;
-      int64_t patch = 0;
+      // collect the positions of the patches, each gap is relative to the
+      // previous patch; a patch that does not move forward ends the list
+      int64_t patchPositions[32];
+      int64_t patches[32];
+      uint64_t numPatches = 0;
+      int64_t position = 0;
       uint64_t patchIdx = 0;
-      adjustGapAndPatch(patchBitSize, patchMask, &gap, &patch, &patchIdx);
+      while (patchIdx < unpackedPatch.size()) {
+        int64_t gap = 0;
+        int64_t patch = 0;
+        adjustGapAndPatch(patchBitSize, patchMask, &gap, &patch, &patchIdx);
+        position += gap;
+        if ((numPatches > 0 && gap == 0) || position >= static_cast<int64_t>(runLength)) {
+          break;
+        }
+        patchPositions[numPatches] = position;
+        patches[numPatches++] = patch;
+        ++patchIdx;
+      }
 
+      // set the high bits of the patched values and add base to all values
+      applyPatches(literals.data(), patchPositions, patches, numPatches, bitSize);
       for (uint64_t i = 0; i < runLength; ++i) {
-        if (static_cast<int64_t>(i) != gap) {
-          // no patching required. add base to unpacked value to get final value
-          literals[i] += base;
-        } else {
-          // extract the patch value
-          int64_t patchedVal = literals[i] | (patch << bitSize);
-
-          // add base to patched value
-          literals[i] = base + patchedVal;
-
-          // increment the patch to point to next entry in patch list
-          ++patchIdx;
-
-          if (patchIdx < unpackedPatch.size()) {
-            adjustGapAndPatch(patchBitSize, patchMask, &gap, &patch, &patchIdx);
-
-            // next gap is relative to the current gap
-            gap += i;
-          }
-        }
+        literals[i] += base;
       }
     }
 
@@ -419,15 +574,7 @@ namespace orc {
         // is a decreasing sequence else an increasing sequence.
         // read deltas using the literals buffer.
         readLongs(literals.data(), 2, runLength - 2, bitSize);
-        if (deltaBase < 0) {
-          for (uint64_t i = 2; i < runLength; ++i) {
-            prevValue = literals[i] = prevValue - literals[i];
-          }
-        } else {
-          for (uint64_t i = 2; i < runLength; ++i) {
-            prevValue = literals[i] = prevValue + literals[i];
-          }
-        }
+        prefixSum(literals.data() + 2, runLength - 2, prevValue, deltaBase < 0);
       }
     }
 
@@ -19,13 +19,101 @@
 
 #include "Adaptor.hh"
 #include "Compression.hh"
+#include "Dispatch.hh"
 #include "RLEV2Util.hh"
 #include "RLEv2.hh"
+#include "RleV2Avx2.hh"
+#if defined(ORC_HAVE_RUNTIME_AVX512)
+#include "RleV2Avx512.hh"
+#endif
+#include "RleV2Default.hh"
+
+#include <algorithm>
 
 #define MAX_SHORT_REPEAT_LENGTH 10
 
 namespace orc {
 
+  struct AnalyzeLiteralsDynamicFunction {
+    using FunctionType = decltype(&RleV2Default::analyzeLiterals);
+
+    static std::vector<std::pair<DispatchLevel, FunctionType>> implementations() {
+      return {{DispatchLevel::NONE, RleV2Default::analyzeLiterals},
+#if defined(ORC_HAVE_RUNTIME_AVX2)
+              {DispatchLevel::AVX2, RleV2AVX2::analyzeLiterals},
+#endif
+#if defined(ORC_HAVE_RUNTIME_AVX512)
+              {DispatchLevel::AVX512, RleV2AVX512::analyzeLiterals},
+#endif
+      };
+    }
+  };
+
+  static void analyzeLiterals(const int64_t* literals, uint64_t numLiterals, int64_t* adjDeltas,
+                              LiteralStats& stats) {
+    static DynamicDispatch<AnalyzeLiteralsDynamicFunction> dispatch;
+    dispatch.func(literals, numLiterals, adjDeltas, stats);
+  }
+
+  struct ZigZagDynamicFunction {
+    using FunctionType = decltype(&RleV2Default::zigZag);
+
+    static std::vector<std::pair<DispatchLevel, FunctionType>> implementations() {
+      return {{DispatchLevel::NONE, RleV2Default::zigZag},
+#if defined(ORC_HAVE_RUNTIME_AVX2)
+              {DispatchLevel::AVX2, RleV2AVX2::zigZag},
+#endif
+#if defined(ORC_HAVE_RUNTIME_AVX512)
+              {DispatchLevel::AVX512, RleV2AVX512::zigZag},
+#endif
+      };
+    }
+  };
+
+  static void zigZagLongs(const int64_t* input, int64_t* output, uint64_t numValues) {
+    static DynamicDispatch<ZigZagDynamicFunction> dispatch;
+    dispatch.func(input, output, numValues);
+  }
+
+  struct BitWidthHistogramDynamicFunction {
+    using FunctionType = decltype(&RleV2Default::bitWidthHistogram);
+
+    static std::vector<std::pair<DispatchLevel, FunctionType>> implementations() {
+#if defined(ORC_HAVE_RUNTIME_AVX512)
+      return {{DispatchLevel::NONE, RleV2Default::bitWidthHistogram},
+              {DispatchLevel::AVX512, RleV2AVX512::bitWidthHistogram}};
+#else
+      return {{DispatchLevel::NONE, RleV2Default::bitWidthHistogram}};
+#endif
+    }
+  };
+
+  static void bitWidthHistogram(const int64_t* data, uint64_t numValues, int32_t* histogram) {
+    static DynamicDispatch<BitWidthHistogramDynamicFunction> dispatch;
+    dispatch.func(data, numValues, histogram);
+  }
+
+  struct PackBitsDynamicFunction {
+    using FunctionType = decltype(&RleV2Default::packBits);
+
+    static std::vector<std::pair<DispatchLevel, FunctionType>> implementations() {
+      return {{DispatchLevel::NONE, RleV2Default::packBits},
+#if defined(ORC_HAVE_RUNTIME_AVX2)
+              {DispatchLevel::AVX2, RleV2AVX2::packBits},
+#endif
+#if defined(ORC_HAVE_RUNTIME_AVX512)
+              {DispatchLevel::AVX512, RleV2AVX512::packBits},
+#endif
+      };
+    }
+  };
+
+  static uint64_t packBits(const int64_t* input, uint64_t numValues, uint32_t bitSize,
+                           char* output) {
+    static DynamicDispatch<PackBitsDynamicFunction> dispatch;
+    return dispatch.func(input, numValues, bitSize, output);
+  }
+
   /**
    * Compute the bits required to represent pth percentile value
    * @param data - array
@@ -43,10 +131,7 @@ namespace orc {
       // maximum number of bits that can encoded is 32 (refer FixedBitSizes)
       memset(histgram, 0, FixedBitSizes::SIZE * sizeof(int32_t));
       // compute the histogram
-      for (size_t i = offset; i < (offset + length); i++) {
-        uint32_t idx = encodeBitWidth(findClosestNumBits(data[i]));
-        histgram[idx] += 1;
-      }
+      bitWidthHistogram(data + offset, length, histgram);
     }
 
     int32_t perLen = static_cast<int32_t>(static_cast<double>(length) * (1.0 - p));
@@ -171,9 +256,8 @@ namespace orc {
 
   void RleEncoderV2::computeZigZagLiterals(EncodingOption& option) {
     assert(isSigned);
-    for (size_t i = 0; i < numLiterals; i++) {
-      zigzagLiterals[option.zigzagLiteralsCount++] = zigZag(literals[i]);
-    }
+    zigZagLongs(literals, zigzagLiterals + option.zigzagLiteralsCount, numLiterals);
+    option.zigzagLiteralsCount += static_cast<int64_t>(numLiterals);
   }
 
   void RleEncoderV2::preparePatchedBlob(EncodingOption& option) {
@@ -308,34 +392,18 @@ namespace orc {
 
     // DELTA encoding check
 
-    // for identifying monotonic sequences
-    bool isIncreasing = true;
-    bool isDecreasing = true;
-    option.isFixedDelta = true;
-
-    option.min = literals[0];
-    int64_t max = literals[0];
-    int64_t initialDelta = literals[1] - literals[0];
-    int64_t currDelta = 0;
-    int64_t deltaMax = 0;
-    adjDeltas[option.adjDeltasCount++] = initialDelta;
-
-    for (size_t i = 1; i < numLiterals; i++) {
-      const int64_t l1 = literals[i];
-      const int64_t l0 = literals[i - 1];
-      currDelta = l1 - l0;
-      option.min = std::min(option.min, l1);
-      max = std::max(max, l1);
-
-      isIncreasing &= (l0 <= l1);
-      isDecreasing &= (l0 >= l1);
-
-      option.isFixedDelta &= (currDelta == initialDelta);
-      if (i > 1) {
-        adjDeltas[option.adjDeltasCount++] = std::abs(currDelta);
-        deltaMax = std::max(deltaMax, adjDeltas[i - 1]);
-      }
-    }
+    // for identifying monotonic sequences and the bit width of the deltas
+    LiteralStats stats;
+    analyzeLiterals(literals, numLiterals, adjDeltas, stats);
+    option.adjDeltasCount = static_cast<int64_t>(numLiterals - 1);
+    option.isFixedDelta = stats.isFixedDelta;
+    option.min = stats.min;
+    const int64_t max = stats.max;
+    const int64_t initialDelta = adjDeltas[0];
+    const int64_t currDelta = stats.lastDelta;
+    const int64_t deltaMax = stats.deltaMax;
+    const bool isIncreasing = stats.isIncreasing;
+    const bool isDecreasing = stats.isDecreasing;
 
     // it's faster to exit under delta overflow condition without checking for
     // PATCHED_BASE condition as encoding using DIRECT is faster and has less
@@ -702,75 +770,13 @@ namespace orc {
       return;
     }
 
-    if (getClosestAlignedFixedBits(bitSize) == bitSize) {
-      uint32_t numBytes;
-      uint32_t endOffSet = static_cast<uint32_t>(offset + len);
-      if (bitSize < 8) {
-        char bitMask = static_cast<char>((1 << bitSize) - 1);
-        uint32_t numHops = 8 / bitSize;
-        uint32_t remainder = static_cast<uint32_t>(len % numHops);
-        uint32_t endUnroll = endOffSet - remainder;
-        for (uint32_t i = offset; i < endUnroll; i += numHops) {
-          char toWrite = 0;
-          for (uint32_t j = 0; j < numHops; ++j) {
-            toWrite |= static_cast<char>((input[i + j] & bitMask) << (8 - (j + 1) * bitSize));
-          }
-          writeByte(toWrite);
-        }
-
-        if (remainder > 0) {
-          uint32_t startShift = 8 - bitSize;
-          char toWrite = 0;
-          for (uint32_t i = endUnroll; i < endOffSet; ++i) {
-            toWrite |= static_cast<char>((input[i] & bitMask) << startShift);
-            startShift -= bitSize;
-          }
-          writeByte(toWrite);
-        }
-
-      } else {
-        numBytes = bitSize / 8;
-
-        for (uint32_t i = offset; i < endOffSet; ++i) {
-          for (uint32_t j = 0; j < numBytes; ++j) {
-            char toWrite = static_cast<char>((input[i] >> (8 * (numBytes - j - 1))) & 255);
-            writeByte(toWrite);
-          }
-        }
-      }
-
-      return;
-    }
-
-    // write for unaligned bit size
-    uint32_t bitsLeft = 8;
-    char current = 0;
-    for (uint32_t i = offset; i < (offset + len); i++) {
-      int64_t value = input[i];
-      uint32_t bitsToWrite = bitSize;
-      while (bitsToWrite > bitsLeft) {
-        // add the bits to the bottom of the current word
-        current |= static_cast<char>(value >> (bitsToWrite - bitsLeft));
-        // subtract out the bits we just added
-        bitsToWrite -= bitsLeft;
-        // zero out the bits above bitsToWrite
-        value &= (static_cast<uint64_t>(1) << bitsToWrite) - 1;
-        writeByte(current);
-        current = 0;
-        bitsLeft = 8;
-      }
-      bitsLeft -= bitsToWrite;
-      current |= static_cast<char>(value << bitsLeft);
-      if (bitsLeft == 0) {
-        writeByte(current);
-        current = 0;
-        bitsLeft = 8;
-      }
-    }
-
-    // flush
-    if (bitsLeft != 8) {
-      writeByte(current);
+    // the literal buffers hold at most MAX_LITERAL_SIZE values, whose bits
+    // always fill whole bytes
+    char packed[MAX_LITERAL_SIZE * sizeof(int64_t) + RleV2Default::PACKING_PADDING];
+    for (size_t i = 0; i < len; i += MAX_LITERAL_SIZE) {
+      uint64_t count = std::min(len - i, static_cast<size_t>(MAX_LITERAL_SIZE));
+      uint64_t numBytes = packBits(input + offset + i, count, bitSize, packed);
+      writeBytes(packed, numBytes);
     }
   }
 
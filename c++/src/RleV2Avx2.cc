@@ -0,0 +1,195 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "RleV2Avx2.hh"
+#include "Dispatch.hh"
+#include "RleV2Default.hh"
+
+#if defined(ORC_HAVE_RUNTIME_AVX2)
+
+#include <immintrin.h>
+
+namespace orc {
+
+  namespace {
+    const uint64_t VALUES_PER_VECTOR = 4;
+  }  // namespace
+
+  ORC_TARGET_AVX2 void RleV2AVX2::prefixSum(int64_t* data, uint64_t numValues, int64_t previous,
+                                            bool decreasing) {
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i carry = _mm256_set1_epi64x(previous);
+    uint64_t i = 0;
+    for (; numValues - i >= VALUES_PER_VECTOR; i += VALUES_PER_VECTOR) {
+      auto* target = reinterpret_cast<__m256i*>(data + i);
+      __m256i values = _mm256_loadu_si256(target);
+      if (decreasing) {
+        values = _mm256_sub_epi64(zero, values);
+      }
+      // add the lane before, then the lanes two before
+      __m256i shifted = _mm256_permute4x64_epi64(values, _MM_SHUFFLE(2, 1, 0, 0));
+      values = _mm256_add_epi64(values, _mm256_blend_epi32(shifted, zero, 0x03));
+      shifted = _mm256_permute4x64_epi64(values, _MM_SHUFFLE(1, 0, 0, 0));
+      values = _mm256_add_epi64(values, _mm256_blend_epi32(shifted, zero, 0x0F));
+      values = _mm256_add_epi64(values, carry);
+      _mm256_storeu_si256(target, values);
+      carry = _mm256_permute4x64_epi64(values, _MM_SHUFFLE(3, 3, 3, 3));
+    }
+    RleV2Default::prefixSum(data + i, numValues - i, i == 0 ? previous : data[i - 1],
+                            decreasing);
+  }
+
+  ORC_TARGET_AVX2 void RleV2AVX2::unZigZag(int64_t* data, uint64_t numValues) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i one = _mm256_set1_epi64x(1);
+    uint64_t i = 0;
+    for (; numValues - i >= VALUES_PER_VECTOR; i += VALUES_PER_VECTOR) {
+      auto* target = reinterpret_cast<__m256i*>(data + i);
+      __m256i values = _mm256_loadu_si256(target);
+      __m256i sign = _mm256_sub_epi64(zero, _mm256_and_si256(values, one));
+      _mm256_storeu_si256(target, _mm256_xor_si256(_mm256_srli_epi64(values, 1), sign));
+    }
+    RleV2Default::unZigZag(data + i, numValues - i);
+  }
+
+  ORC_TARGET_AVX2 void RleV2AVX2::analyzeLiterals(const int64_t* literals, uint64_t numLiterals,
+                                                  int64_t* adjDeltas, LiteralStats& stats) {
+    // the differences wrap around like the ones of the default kernel
+    const int64_t initialDelta = static_cast<int64_t>(static_cast<uint64_t>(literals[1]) -
+                                                      static_cast<uint64_t>(literals[0]));
+    int64_t min = literals[0] < literals[1] ? literals[0] : literals[1];
+    int64_t max = literals[0] < literals[1] ? literals[1] : literals[0];
+    int64_t deltaMax = 0;
+    bool isIncreasing = literals[0] <= literals[1];
+    bool isDecreasing = literals[0] >= literals[1];
+    bool isFixedDelta = true;
+    adjDeltas[0] = initialDelta;
+
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i initial = _mm256_set1_epi64x(initialDelta);
+    __m256i minimums = _mm256_set1_epi64x(min);
+    __m256i maximums = _mm256_set1_epi64x(max);
+    __m256i deltaMaximums = zero;
+    __m256i decreases = zero;
+    __m256i increases = zero;
+    __m256i changes = zero;
+    uint64_t i = 2;
+    for (; numLiterals - i >= VALUES_PER_VECTOR; i += VALUES_PER_VECTOR) {
+      __m256i current = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(literals + i));
+      __m256i previous = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(literals + i - 1));
+      __m256i delta = _mm256_sub_epi64(current, previous);
+      minimums = _mm256_blendv_epi8(minimums, current, _mm256_cmpgt_epi64(minimums, current));
+      maximums = _mm256_blendv_epi8(maximums, current, _mm256_cmpgt_epi64(current, maximums));
+      decreases = _mm256_or_si256(decreases, _mm256_cmpgt_epi64(previous, current));
+      increases = _mm256_or_si256(increases, _mm256_cmpgt_epi64(current, previous));
+      changes = _mm256_or_si256(changes, _mm256_xor_si256(delta, initial));
+      __m256i sign = _mm256_cmpgt_epi64(zero, delta);
+      __m256i absolute = _mm256_sub_epi64(_mm256_xor_si256(delta, sign), sign);
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(adjDeltas + i - 1), absolute);
+      deltaMaximums = _mm256_blendv_epi8(deltaMaximums, absolute,
+                                         _mm256_cmpgt_epi64(absolute, deltaMaximums));
+    }
+    isIncreasing &= _mm256_testz_si256(decreases, decreases) != 0;
+    isDecreasing &= _mm256_testz_si256(increases, increases) != 0;
+    isFixedDelta &= _mm256_testz_si256(changes, changes) != 0;
+
+    alignas(32) int64_t lanes[3][VALUES_PER_VECTOR];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes[0]), minimums);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes[1]), maximums);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes[2]), deltaMaximums);
+    for (uint64_t lane = 0; lane < VALUES_PER_VECTOR; ++lane) {
+      min = lanes[0][lane] < min ? lanes[0][lane] : min;
+      max = lanes[1][lane] > max ? lanes[1][lane] : max;
+      deltaMax = lanes[2][lane] > deltaMax ? lanes[2][lane] : deltaMax;
+    }
+
+    for (; i < numLiterals; ++i) {
+      const int64_t l1 = literals[i];
+      const int64_t l0 = literals[i - 1];
+      const uint64_t delta = static_cast<uint64_t>(l1) - static_cast<uint64_t>(l0);
+      min = l1 < min ? l1 : min;
+      max = l1 > max ? l1 : max;
+      isIncreasing &= (l0 <= l1);
+      isDecreasing &= (l0 >= l1);
+      isFixedDelta &= (static_cast<int64_t>(delta) == initialDelta);
+      adjDeltas[i - 1] =
+          static_cast<int64_t>(static_cast<int64_t>(delta) < 0 ? 0 - delta : delta);
+      deltaMax = adjDeltas[i - 1] > deltaMax ? adjDeltas[i - 1] : deltaMax;
+    }
+
+    stats.min = min;
+    stats.max = max;
+    stats.lastDelta = static_cast<int64_t>(static_cast<uint64_t>(literals[numLiterals - 1]) -
+                                           static_cast<uint64_t>(literals[numLiterals - 2]));
+    stats.deltaMax = deltaMax;
+    stats.isIncreasing = isIncreasing;
+    stats.isDecreasing = isDecreasing;
+    stats.isFixedDelta = isFixedDelta;
+  }
+
+  ORC_TARGET_AVX2 void RleV2AVX2::zigZag(const int64_t* input, int64_t* output,
+                                         uint64_t numValues) {
+    const __m256i zero = _mm256_setzero_si256();
+    uint64_t i = 0;
+    for (; numValues - i >= VALUES_PER_VECTOR; i += VALUES_PER_VECTOR) {
+      __m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + i));
+      __m256i sign = _mm256_cmpgt_epi64(zero, values);
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + i),
+                          _mm256_xor_si256(_mm256_slli_epi64(values, 1), sign));
+    }
+    RleV2Default::zigZag(input + i, output + i, numValues - i);
+  }
+
+  ORC_TARGET_AVX2 uint64_t RleV2AVX2::packBits(const int64_t* input, uint64_t numValues,
+                                               uint32_t bitSize, char* output) {
+    if (bitSize % 8 != 0) {
+      return RleV2Default::packBits(input, numValues, bitSize, output);
+    }
+    // each 128 bit lane holds two values, whose low bytes are moved to the
+    // front of the lane in big endian order
+    const uint32_t bytesPerValue = bitSize / 8;
+    const uint32_t bytesPerLane = 2 * bytesPerValue;
+    alignas(32) char control[32];
+    for (uint32_t j = 0; j < 16; ++j) {
+      char source = -1;
+      if (j < bytesPerLane) {
+        source = static_cast<char>((j / bytesPerValue) * 8 + bytesPerValue - 1 - j % bytesPerValue);
+      }
+      control[j] = control[16 + j] = source;
+    }
+    const __m256i shuffle = _mm256_load_si256(reinterpret_cast<const __m256i*>(control));
+
+    char* out = output;
+    uint64_t i = 0;
+    for (; numValues - i >= VALUES_PER_VECTOR; i += VALUES_PER_VECTOR) {
+      __m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + i));
+      values = _mm256_shuffle_epi8(values, shuffle);
+      // the second store overwrites the unused end of the first one
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm256_castsi256_si128(values));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(out + bytesPerLane),
+                       _mm256_extracti128_si256(values, 1));
+      out += 2 * bytesPerLane;
+    }
+    out += RleV2Default::packBits(input + i, numValues - i, bitSize, out);
+    return static_cast<uint64_t>(out - output);
+  }
+
+}  // namespace orc
+
+#endif
@@ -0,0 +1,202 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "RleV2Avx512.hh"
+#include "RLEV2Util.hh"
+#include "RleV2Default.hh"
+
+#include <immintrin.h>
+#include <algorithm>
+
+namespace orc {
+
+  namespace {
+    const uint64_t VALUES_PER_VECTOR = 8;
+  }  // namespace
+
+  void RleV2AVX512::prefixSum(int64_t* data, uint64_t numValues, int64_t previous,
+                              bool decreasing) {
+    const __m512i zero = _mm512_setzero_si512();
+    const __m512i last = _mm512_set1_epi64(VALUES_PER_VECTOR - 1);
+    __m512i carry = _mm512_set1_epi64(previous);
+    uint64_t i = 0;
+    for (; numValues - i >= VALUES_PER_VECTOR; i += VALUES_PER_VECTOR) {
+      __m512i values = _mm512_loadu_si512(data + i);
+      if (decreasing) {
+        values = _mm512_sub_epi64(zero, values);
+      }
+      // add the lanes one, two and four before
+      values = _mm512_add_epi64(values, _mm512_alignr_epi64(values, zero, 7));
+      values = _mm512_add_epi64(values, _mm512_alignr_epi64(values, zero, 6));
+      values = _mm512_add_epi64(values, _mm512_alignr_epi64(values, zero, 4));
+      values = _mm512_add_epi64(values, carry);
+      _mm512_storeu_si512(data + i, values);
+      carry = _mm512_permutexvar_epi64(last, values);
+    }
+    RleV2Default::prefixSum(data + i, numValues - i, i == 0 ? previous : data[i - 1],
+                            decreasing);
+  }
+
+  void RleV2AVX512::unZigZag(int64_t* data, uint64_t numValues) {
+    const __m512i zero = _mm512_setzero_si512();
+    const __m512i one = _mm512_set1_epi64(1);
+    uint64_t i = 0;
+    for (; numValues - i >= VALUES_PER_VECTOR; i += VALUES_PER_VECTOR) {
+      __m512i values = _mm512_loadu_si512(data + i);
+      __m512i sign = _mm512_sub_epi64(zero, _mm512_and_si512(values, one));
+      _mm512_storeu_si512(data + i, _mm512_xor_si512(_mm512_srli_epi64(values, 1), sign));
+    }
+    RleV2Default::unZigZag(data + i, numValues - i);
+  }
+
+  void RleV2AVX512::applyPatches(int64_t* data, const int64_t* positions,
+                                 const int64_t* patches, uint64_t numPatches, uint32_t shift) {
+    for (uint64_t i = 0; i < numPatches; i += VALUES_PER_VECTOR) {
+      uint64_t count = numPatches - i < VALUES_PER_VECTOR ? numPatches - i : VALUES_PER_VECTOR;
+      __mmask8 lanes = static_cast<__mmask8>((1U << count) - 1);
+      __m512i indexes = _mm512_maskz_loadu_epi64(lanes, positions + i);
+      __m512i high = _mm512_sll_epi64(_mm512_maskz_loadu_epi64(lanes, patches + i),
+                                      _mm_cvtsi32_si128(static_cast<int>(shift)));
+      __m512i values = _mm512_mask_i64gather_epi64(_mm512_setzero_si512(), lanes, indexes, data, 8);
+      _mm512_mask_i64scatter_epi64(data, lanes, indexes, _mm512_or_si512(values, high), 8);
+    }
+  }
+
+  void RleV2AVX512::analyzeLiterals(const int64_t* literals, uint64_t numLiterals,
+                                    int64_t* adjDeltas, LiteralStats& stats) {
+    // the differences wrap around like the ones of the default kernel
+    const int64_t initialDelta = static_cast<int64_t>(static_cast<uint64_t>(literals[1]) -
+                                                      static_cast<uint64_t>(literals[0]));
+    const __m512i initial = _mm512_set1_epi64(initialDelta);
+    __m512i minimums = _mm512_set1_epi64(std::min(literals[0], literals[1]));
+    __m512i maximums = _mm512_set1_epi64(std::max(literals[0], literals[1]));
+    __m512i deltaMaximums = _mm512_setzero_si512();
+    __mmask8 decreases = literals[0] > literals[1] ? 1 : 0;
+    __mmask8 increases = literals[0] < literals[1] ? 1 : 0;
+    __mmask8 changes = 0;
+    adjDeltas[0] = initialDelta;
+
+    for (uint64_t i = 2; i < numLiterals; i += VALUES_PER_VECTOR) {
+      uint64_t count = std::min(numLiterals - i, VALUES_PER_VECTOR);
+      __mmask8 lanes = static_cast<__mmask8>((1U << count) - 1);
+      __m512i current = _mm512_maskz_loadu_epi64(lanes, literals + i);
+      __m512i previous = _mm512_maskz_loadu_epi64(lanes, literals + i - 1);
+      __m512i delta = _mm512_sub_epi64(current, previous);
+      minimums = _mm512_mask_min_epi64(minimums, lanes, minimums, current);
+      maximums = _mm512_mask_max_epi64(maximums, lanes, maximums, current);
+      decreases |= _mm512_mask_cmpgt_epi64_mask(lanes, previous, current);
+      increases |= _mm512_mask_cmpgt_epi64_mask(lanes, current, previous);
+      changes |= _mm512_mask_cmpneq_epi64_mask(lanes, delta, initial);
+      __m512i absolute = _mm512_abs_epi64(delta);
+      _mm512_mask_storeu_epi64(adjDeltas + i - 1, lanes, absolute);
+      deltaMaximums = _mm512_mask_max_epi64(deltaMaximums, lanes, deltaMaximums, absolute);
+    }
+
+    alignas(64) int64_t lanes[3][VALUES_PER_VECTOR];
+    _mm512_store_si512(lanes[0], minimums);
+    _mm512_store_si512(lanes[1], maximums);
+    _mm512_store_si512(lanes[2], deltaMaximums);
+    stats.min = *std::min_element(lanes[0], lanes[0] + VALUES_PER_VECTOR);
+    stats.max = *std::max_element(lanes[1], lanes[1] + VALUES_PER_VECTOR);
+    stats.deltaMax = *std::max_element(lanes[2], lanes[2] + VALUES_PER_VECTOR);
+    stats.lastDelta = static_cast<int64_t>(static_cast<uint64_t>(literals[numLiterals - 1]) -
+                                           static_cast<uint64_t>(literals[numLiterals - 2]));
+    stats.isIncreasing = decreases == 0;
+    stats.isDecreasing = increases == 0;
+    stats.isFixedDelta = changes == 0;
+  }
+
+  void RleV2AVX512::zigZag(const int64_t* input, int64_t* output, uint64_t numValues) {
+    uint64_t i = 0;
+    for (; numValues - i >= VALUES_PER_VECTOR; i += VALUES_PER_VECTOR) {
+      __m512i values = _mm512_loadu_si512(input + i);
+      _mm512_storeu_si512(output + i, _mm512_xor_si512(_mm512_slli_epi64(values, 1),
+                                                       _mm512_srai_epi64(values, 63)));
+    }
+    RleV2Default::zigZag(input + i, output + i, numValues - i);
+  }
+
+  void RleV2AVX512::bitWidthHistogram(const int64_t* data, uint64_t numValues,
+                                      int32_t* histogram) {
+    const __m512i maxBits = _mm512_set1_epi64(64);
+    alignas(64) int64_t bits[VALUES_PER_VECTOR];
+    uint64_t i = 0;
+    for (; numValues - i >= VALUES_PER_VECTOR; i += VALUES_PER_VECTOR) {
+      // negative values need all 64 bits like in findClosestNumBits
+      __m512i values = _mm512_loadu_si512(data + i);
+      _mm512_store_si512(bits, _mm512_sub_epi64(maxBits, _mm512_lzcnt_epi64(values)));
+      for (uint64_t lane = 0; lane < VALUES_PER_VECTOR; ++lane) {
+        histogram[encodeBitWidth(getClosestFixedBits(static_cast<uint32_t>(bits[lane])))] += 1;
+      }
+    }
+    RleV2Default::bitWidthHistogram(data + i, numValues - i, histogram);
+  }
+
+  uint64_t RleV2AVX512::packBits(const int64_t* input, uint64_t numValues, uint32_t bitSize,
+                                 char* output) {
+    char* out = output;
+    uint64_t i = 0;
+    if (bitSize % 8 == 0) {
+      // each 128 bit lane holds two values, whose low bytes are moved to
+      // the front of the lane in big endian order
+      const uint32_t bytesPerValue = bitSize / 8;
+      const uint32_t bytesPerLane = 2 * bytesPerValue;
+      alignas(64) char control[64];
+      for (uint32_t j = 0; j < 16; ++j) {
+        char source = -1;
+        if (j < bytesPerLane) {
+          source =
+              static_cast<char>((j / bytesPerValue) * 8 + bytesPerValue - 1 - j % bytesPerValue);
+        }
+        control[j] = control[16 + j] = control[32 + j] = control[48 + j] = source;
+      }
+      const __m512i shuffle = _mm512_load_si512(control);
+      for (; numValues - i >= VALUES_PER_VECTOR; i += VALUES_PER_VECTOR) {
+        __m512i values = _mm512_shuffle_epi8(_mm512_loadu_si512(input + i), shuffle);
+        // each store overwrites the unused end of the one before
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm512_castsi512_si128(values));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + bytesPerLane),
+                         _mm512_extracti32x4_epi32(values, 1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2 * bytesPerLane),
+                         _mm512_extracti32x4_epi32(values, 2));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 3 * bytesPerLane),
+                         _mm512_extracti32x4_epi32(values, 3));
+        out += 4 * bytesPerLane;
+      }
+    } else if (bitSize == 1 || bitSize == 2 || bitSize == 4) {
+      // narrow eight values to bytes, put the first one in the high byte
+      // and extract the low bits of each byte into bitSize bytes
+      const uint64_t mask = (1ULL << bitSize) - 1;
+      const uint64_t spread = mask * 0x0101010101010101ULL;
+      const __m512i valueMask = _mm512_set1_epi64(static_cast<int64_t>(mask));
+      const __m128i reverse = _mm_set_epi8(-1, -1, -1, -1, -1, -1, -1, -1, 0, 1, 2, 3, 4, 5, 6, 7);
+      for (; numValues - i >= VALUES_PER_VECTOR; i += VALUES_PER_VECTOR) {
+        __m512i values = _mm512_and_si512(_mm512_loadu_si512(input + i), valueMask);
+        __m128i bytes = _mm_shuffle_epi8(_mm512_cvtepi64_epi8(values), reverse);
+        uint64_t packed = _pext_u64(static_cast<uint64_t>(_mm_cvtsi128_si64(bytes)), spread);
+        for (uint32_t j = bitSize; j-- > 0;) {
+          *out++ = static_cast<char>(packed >> (8 * j));
+        }
+      }
+    }
+    out += RleV2Default::packBits(input + i, numValues - i, bitSize, out);
+    return static_cast<uint64_t>(out - output);
+  }
+
+}  // namespace orc
@@ -0,0 +1,56 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef ORC_RLEV2_AVX512_HH
+#define ORC_RLEV2_AVX512_HH
+
+#include "RleV2Default.hh"
+
+#include <cstdint>
+
+namespace orc {
+
+  /**
+   * The AVX-512 versions of the kernels in RleV2Default, which work on eight
+   * values at a time and gather and scatter the patched values. The byte
+   * aligned widths and the widths 1, 2 and 4 are packed with vectors.
+   */
+  class RleV2AVX512 {
+   public:
+    static void prefixSum(int64_t* data, uint64_t numValues, int64_t previous, bool decreasing);
+
+    static void unZigZag(int64_t* data, uint64_t numValues);
+
+    static void applyPatches(int64_t* data, const int64_t* positions, const int64_t* patches,
+                             uint64_t numPatches, uint32_t shift);
+
+    static void analyzeLiterals(const int64_t* literals, uint64_t numLiterals, int64_t* adjDeltas,
+                                LiteralStats& stats);
+
+    static void zigZag(const int64_t* input, int64_t* output, uint64_t numValues);
+
+    static void bitWidthHistogram(const int64_t* data, uint64_t numValues, int32_t* histogram);
+
+    static uint64_t packBits(const int64_t* input, uint64_t numValues, uint32_t bitSize,
+                             char* output);
+  };
+
+}  // namespace orc
+
+#endif
@@ -0,0 +1,128 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "RleV2Default.hh"
+#include "RLE.hh"
+#include "RLEV2Util.hh"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace orc {
+
+  void RleV2Default::prefixSum(int64_t* data, uint64_t numValues, int64_t previous,
+                               bool decreasing) {
+    if (decreasing) {
+      for (uint64_t i = 0; i < numValues; ++i) {
+        previous = data[i] = previous - data[i];
+      }
+    } else {
+      for (uint64_t i = 0; i < numValues; ++i) {
+        previous = data[i] = previous + data[i];
+      }
+    }
+  }
+
+  void RleV2Default::unZigZag(int64_t* data, uint64_t numValues) {
+    for (uint64_t i = 0; i < numValues; ++i) {
+      data[i] = orc::unZigZag(static_cast<uint64_t>(data[i]));
+    }
+  }
+
+  void RleV2Default::applyPatches(int64_t* data, const int64_t* positions,
+                                  const int64_t* patches, uint64_t numPatches, uint32_t shift) {
+    for (uint64_t i = 0; i < numPatches; ++i) {
+      data[positions[i]] |= patches[i] << shift;
+    }
+  }
+
+  void RleV2Default::analyzeLiterals(const int64_t* literals, uint64_t numLiterals,
+                                     int64_t* adjDeltas, LiteralStats& stats) {
+    const int64_t initialDelta = literals[1] - literals[0];
+    int64_t currDelta = 0;
+    stats.min = literals[0];
+    stats.max = literals[0];
+    stats.deltaMax = 0;
+    stats.isIncreasing = true;
+    stats.isDecreasing = true;
+    stats.isFixedDelta = true;
+    adjDeltas[0] = initialDelta;
+
+    for (uint64_t i = 1; i < numLiterals; i++) {
+      const int64_t l1 = literals[i];
+      const int64_t l0 = literals[i - 1];
+      currDelta = l1 - l0;
+      stats.min = std::min(stats.min, l1);
+      stats.max = std::max(stats.max, l1);
+
+      stats.isIncreasing &= (l0 <= l1);
+      stats.isDecreasing &= (l0 >= l1);
+
+      stats.isFixedDelta &= (currDelta == initialDelta);
+      if (i > 1) {
+        adjDeltas[i - 1] = std::abs(currDelta);
+        stats.deltaMax = std::max(stats.deltaMax, adjDeltas[i - 1]);
+      }
+    }
+    stats.lastDelta = currDelta;
+  }
+
+  void RleV2Default::zigZag(const int64_t* input, int64_t* output, uint64_t numValues) {
+    for (uint64_t i = 0; i < numValues; ++i) {
+      output[i] = orc::zigZag(input[i]);
+    }
+  }
+
+  void RleV2Default::bitWidthHistogram(const int64_t* data, uint64_t numValues,
+                                       int32_t* histogram) {
+    for (uint64_t i = 0; i < numValues; ++i) {
+      histogram[encodeBitWidth(findClosestNumBits(data[i]))] += 1;
+    }
+  }
+
+  uint64_t RleV2Default::packBits(const int64_t* input, uint64_t numValues, uint32_t bitSize,
+                                  char* output) {
+    const uint64_t mask = bitSize == 64 ? ~0ULL : (1ULL << bitSize) - 1;
+    // the low byte of wide values is added on its own, so that the
+    // accumulator never holds more than 64 bits
+    const uint32_t lowBits = bitSize > 56 ? 8 : 0;
+    const uint32_t highBits = bitSize - lowBits;
+    char* out = output;
+    uint64_t accumulator = 0;
+    uint32_t pending = 0;
+    for (uint64_t i = 0; i < numValues; ++i) {
+      const uint64_t value = static_cast<uint64_t>(input[i]) & mask;
+      accumulator = (accumulator << highBits) | (value >> lowBits);
+      pending += highBits;
+      while (pending >= 8) {
+        pending -= 8;
+        *out++ = static_cast<char>(accumulator >> pending);
+      }
+      if (lowBits != 0) {
+        accumulator = (accumulator << 8) | (value & 0xff);
+        *out++ = static_cast<char>(accumulator >> pending);
+      }
+    }
+    if (pending != 0) {
+      *out++ = static_cast<char>(accumulator << (8 - pending));
+    }
+    return static_cast<uint64_t>(out - output);
+  }
+
+}  // namespace orc
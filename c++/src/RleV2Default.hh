@@ -0,0 +1,109 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef ORC_RLEV2_DEFAULT_HH
+#define ORC_RLEV2_DEFAULT_HH
+
+#include <cstdint>
+
+namespace orc {
+
+  /**
+   * What the RLEv2 encoder learns about a run of literals before it picks
+   * the encoding.
+   */
+  struct LiteralStats {
+    int64_t min;
+    int64_t max;
+    // the difference between the last two literals
+    int64_t lastDelta;
+    // the largest absolute difference after the first one
+    int64_t deltaMax;
+    bool isIncreasing;
+    bool isDecreasing;
+    bool isFixedDelta;
+  };
+
+  /**
+   * The kernels that turn the unpacked values of RLEv2 runs into the
+   * decoded values, and the kernels that analyze and pack the literals of
+   * the encoder.
+   */
+  class RleV2Default {
+   public:
+    // the number of bytes that packBits may write past the packed bytes
+    static const uint64_t PACKING_PADDING = 16;
+
+    /**
+     * Replace the deltas of a DELTA run with the values they lead to.
+     * @param data the deltas, which are replaced in place
+     * @param numValues the number of deltas
+     * @param previous the value before the first delta
+     * @param decreasing whether the deltas are subtracted
+     */
+    static void prefixSum(int64_t* data, uint64_t numValues, int64_t previous, bool decreasing);
+
+    /**
+     * Decode zigzag encoded values in place.
+     */
+    static void unZigZag(int64_t* data, uint64_t numValues);
+
+    /**
+     * Set the high bits of the patched values of a PATCHED_BASE run.
+     * @param data the unpacked values
+     * @param positions the distinct indexes of the patched values
+     * @param patches the patches of the values
+     * @param numPatches the number of patches
+     * @param shift the bit width of the unpacked values
+     */
+    static void applyPatches(int64_t* data, const int64_t* positions, const int64_t* patches,
+                             uint64_t numPatches, uint32_t shift);
+
+    /**
+     * Compute the stats of at least two literals. The first difference is
+     * stored in adjDeltas[0] and the absolute values of the later ones in
+     * adjDeltas[1] to adjDeltas[numLiterals - 2].
+     */
+    static void analyzeLiterals(const int64_t* literals, uint64_t numLiterals, int64_t* adjDeltas,
+                                LiteralStats& stats);
+
+    /**
+     * Zigzag encode the values.
+     */
+    static void zigZag(const int64_t* input, int64_t* output, uint64_t numValues);
+
+    /**
+     * Count the values by the index of the fixed bit width they need.
+     * @param histogram the counts, which are incremented
+     */
+    static void bitWidthHistogram(const int64_t* data, uint64_t numValues, int32_t* histogram);
+
+    /**
+     * Pack the low bitSize bits of each value, most significant bit first.
+     * The last byte is padded with zeros.
+     * @param output room for the packed bytes and PACKING_PADDING more
+     * @return the number of packed bytes
+     */
+    static uint64_t packBits(const int64_t* input, uint64_t numValues, uint32_t bitSize,
+                             char* output);
+  };
+
+}  // namespace orc
+
+#endif
@@ -0,0 +1,77 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "StreamDirectory.hh"
+
+namespace orc {
+
+  StreamDirectory::StreamDirectory() : dataEnd(0) {
+    // PASS
+  }
+
+  StreamDirectory::StreamDirectory(const proto::StripeInformation& info,
+                                   const proto::StripeFooter& footer)
+      : dataEnd(info.offset() + info.index_length() + info.data_length()) {
+    streams.reserve(static_cast<size_t>(footer.streams_size()));
+    uint64_t offset = info.offset();
+    for (int i = 0; i < footer.streams_size(); ++i) {
+      const proto::Stream& stream = footer.streams(i);
+      streams.push_back(
+          {i, stream.column(), stream.has_kind(), stream.kind(), offset, stream.length()});
+      offset += stream.length();
+    }
+
+    // group the streams by column with a counting sort
+    uint64_t columnCount = static_cast<uint64_t>(footer.columns_size());
+    auto isIndexed = [columnCount](const Entry& entry) {
+      return entry.hasKind && entry.column < columnCount;
+    };
+    columnStart.assign(columnCount + 1, 0);
+    for (const Entry& entry : streams) {
+      if (isIndexed(entry)) {
+        ++columnStart[entry.column + 1];
+      }
+    }
+    for (size_t column = 0; column < columnCount; ++column) {
+      columnStart[column + 1] += columnStart[column];
+    }
+    columnStreams.resize(columnStart.back());
+    std::vector<uint32_t> next(columnStart.begin(), columnStart.end() - 1);
+    for (const Entry& entry : streams) {
+      if (isIndexed(entry)) {
+        columnStreams[next[entry.column]++] = static_cast<uint32_t>(entry.index);
+      }
+    }
+  }
+
+  const StreamDirectory::Entry* StreamDirectory::find(uint64_t column,
+                                                      proto::Stream_Kind kind) const {
+    if (columnStart.empty() || column >= columnStart.size() - 1) {
+      return nullptr;
+    }
+    for (uint32_t i = columnStart[column]; i < columnStart[column + 1]; ++i) {
+      const Entry& entry = streams[columnStreams[i]];
+      if (entry.kind == kind) {
+        return &entry;
+      }
+    }
+    return nullptr;
+  }
+
+}  // namespace orc
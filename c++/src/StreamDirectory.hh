@@ -0,0 +1,78 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef ORC_STREAM_DIRECTORY_HH
+#define ORC_STREAM_DIRECTORY_HH
+
+#include "wrap/orc-proto-wrapper.hh"
+
+#include <vector>
+
+namespace orc {
+
+  /**
+   * The location of the streams of a stripe. It is built once from the
+   * stripe footer, so that finding the stream of a column does not scan the
+   * footer and sum up the lengths of the streams before it.
+   */
+  class StreamDirectory {
+   public:
+    struct Entry {
+      // the position of the stream in the stripe footer
+      int index;
+      uint64_t column;
+      bool hasKind;
+      proto::Stream_Kind kind;
+      // the position of the stream in the file
+      uint64_t offset;
+      uint64_t length;
+    };
+
+    StreamDirectory();
+    StreamDirectory(const proto::StripeInformation& info, const proto::StripeFooter& footer);
+
+    // the streams in file order, including the ones without a kind
+    const std::vector<Entry>& getStreams() const {
+      return streams;
+    }
+
+    /**
+     * Find the stream of a column. The streams without a kind and the ones of
+     * columns without an encoding in the footer are never found.
+     * @return the stream or nullptr if the column has no stream of the kind
+     */
+    const Entry* find(uint64_t column, proto::Stream_Kind kind) const;
+
+    // the end of the index and data streams in the file
+    uint64_t getDataEnd() const {
+      return dataEnd;
+    }
+
+   private:
+    std::vector<Entry> streams;
+    // the positions in streams of the streams with a kind, grouped by
+    // column; the streams of column c are in [columnStart[c], columnStart[c + 1])
+    std::vector<uint32_t> columnStreams;
+    std::vector<uint32_t> columnStart;
+    uint64_t dataEnd;
+  };
+
+}  // namespace orc
+
+#endif
@@ -0,0 +1,137 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "StripePrefetcher.hh"
+#include "Reader.hh"
+
+#include <algorithm>
+#include <chrono>
+
+namespace orc {
+
+  PrefetchedStripe::PrefetchedStripe(uint64_t _stripeIndex)
+      : stripeIndex(_stripeIndex), loadLatencyUs(0) {
+    // PASS
+  }
+
+  StripePrefetcher::StripePrefetcher(std::shared_ptr<FileContents> _contents,
+                                     const std::vector<bool>& _selectedColumns,
+                                     bool _readIndexStreams, uint64_t _maxGap, uint32_t _depth,
+                                     uint64_t _memoryBudget)
+      : contents(std::move(_contents)),
+        selectedColumns(_selectedColumns),
+        readIndexStreams(_readIndexStreams),
+        maxGap(_maxGap),
+        depth(_depth),
+        memoryBudget(_memoryBudget),
+        reservedBytes(0) {
+    // PASS
+  }
+
+  StripePrefetcher::~StripePrefetcher() {
+    // the futures wait for the pending reads when they are destroyed
+    while (!requests.empty()) {
+      pop();
+    }
+  }
+
+  void StripePrefetcher::pop() {
+    reservedBytes -= requests.front().reservedBytes;
+    requests.pop_front();
+  }
+
+  std::shared_ptr<PrefetchedStripe> StripePrefetcher::load(
+      std::shared_ptr<FileContents> contents, const std::vector<bool>& selectedColumns,
+      bool readIndexStreams, uint64_t maxGap, uint64_t stripeIndex) {
+    auto start = std::chrono::steady_clock::now();
+    const proto::StripeInformation& info = contents->footer->stripes(static_cast<int>(stripeIndex));
+    auto stripe = std::make_shared<PrefetchedStripe>(stripeIndex);
+    stripe->buffers = std::make_shared<StripeBuffers>();
+    stripe->buffers->load(*contents->stream, *contents->pool,
+                          planStripeFooterReads(info, readIndexStreams, maxGap));
+    stripe->footer = getStripeFooter(info, *contents, stripe->buffers.get());
+    stripe->streams = StreamDirectory(info, stripe->footer);
+    stripe->buffers->load(
+        *contents->stream, *contents->pool,
+        planStripeReads(stripe->streams, selectedColumns, readIndexStreams, true, maxGap));
+    stripe->loadLatencyUs = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() -
+                                                              start)
+            .count());
+    return stripe;
+  }
+
+  void StripePrefetcher::schedule(uint64_t nextStripe, uint64_t lastStripe) {
+    uint64_t stripeIndex = nextStripe;
+    if (!requests.empty()) {
+      stripeIndex = std::max(stripeIndex, requests.back().stripeIndex + 1);
+    }
+    while (requests.size() < depth && stripeIndex < lastStripe) {
+      const proto::StripeInformation& info =
+          contents->footer->stripes(static_cast<int>(stripeIndex));
+      uint64_t stripeBytes = info.index_length() + info.data_length() + info.footer_length();
+      if (reservedBytes + stripeBytes > memoryBudget) {
+        break;
+      }
+      reservedBytes += stripeBytes;
+      requests.push_back({stripeIndex, stripeBytes,
+                          std::async(std::launch::async, &StripePrefetcher::load, contents,
+                                     std::cref(selectedColumns), readIndexStreams, maxGap,
+                                     stripeIndex)});
+      ++stripeIndex;
+    }
+  }
+
+  std::shared_ptr<PrefetchedStripe> StripePrefetcher::take(uint64_t stripeIndex) {
+    while (!requests.empty() && requests.front().stripeIndex < stripeIndex) {
+      pop();
+    }
+    if (requests.empty() || requests.front().stripeIndex != stripeIndex) {
+      // the stripe was not requested, e.g. after a seek, so the pending ones are stale
+      while (!requests.empty()) {
+        pop();
+      }
+      return nullptr;
+    }
+
+    std::shared_ptr<PrefetchedStripe> stripe;
+    auto start = std::chrono::steady_clock::now();
+    try {
+      stripe = requests.front().result.get();
+    } catch (std::exception&) {
+      // let the synchronous read path report the failure
+      stripe = nullptr;
+    }
+    uint64_t waitUs = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() -
+                                                              start)
+            .count());
+    pop();
+
+    ReaderMetrics* metrics = contents->readerMetrics;
+    if (stripe && metrics != nullptr) {
+      metrics->PrefetchStripeCount.fetch_add(1);
+      metrics->PrefetchBlockingLatencyUs.fetch_add(waitUs);
+      if (stripe->loadLatencyUs > waitUs) {
+        metrics->PrefetchHiddenLatencyUs.fetch_add(stripe->loadLatencyUs - waitUs);
+      }
+    }
+    return stripe;
+  }
+
+}  // namespace orc
@@ -0,0 +1,130 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ORC_STRIPE_PREFETCHER_HH
+#define ORC_STRIPE_PREFETCHER_HH
+
+#include "StripeReadPlanner.hh"
+
+#include <deque>
+#include <future>
+#include <memory>
+#include <vector>
+
+namespace orc {
+
+  struct FileContents;
+
+  /**
+   * The footer and the selected streams of a stripe that were read ahead of
+   * time.
+   */
+  class PrefetchedStripe {
+   private:
+    const uint64_t stripeIndex;
+    proto::StripeFooter footer;
+    StreamDirectory streams;
+    std::shared_ptr<StripeBuffers> buffers;
+    uint64_t loadLatencyUs;
+
+    friend class StripePrefetcher;
+
+   public:
+    PrefetchedStripe(uint64_t stripeIndex);
+
+    uint64_t getStripeIndex() const {
+      return stripeIndex;
+    }
+
+    const proto::StripeFooter& getFooter() const {
+      return footer;
+    }
+
+    const StreamDirectory& getStreams() const {
+      return streams;
+    }
+
+    const std::shared_ptr<StripeBuffers>& getBuffers() const {
+      return buffers;
+    }
+  };
+
+  /**
+   * Reads the stripes that follow the current one on background threads, so
+   * that the I/O of the next stripe overlaps with decoding the current one.
+   *
+   * All methods must be called from the thread that owns the RowReader.
+   */
+  class StripePrefetcher {
+   private:
+    struct Request {
+      uint64_t stripeIndex;
+      uint64_t reservedBytes;
+      std::future<std::shared_ptr<PrefetchedStripe>> result;
+    };
+
+    const std::shared_ptr<FileContents> contents;
+    const std::vector<bool> selectedColumns;
+    const bool readIndexStreams;
+    const uint64_t maxGap;
+    const uint32_t depth;
+    const uint64_t memoryBudget;
+    std::deque<Request> requests;
+    uint64_t reservedBytes;
+
+    static std::shared_ptr<PrefetchedStripe> load(std::shared_ptr<FileContents> contents,
+                                                  const std::vector<bool>& selectedColumns,
+                                                  bool readIndexStreams, uint64_t maxGap,
+                                                  uint64_t stripeIndex);
+
+    void pop();
+
+   public:
+    /**
+     * @param contents of the file
+     * @param selectedColumns the columns whose streams are prefetched
+     * @param readIndexStreams whether to prefetch the row index and bloom filter streams
+     * @param maxGap the largest gap between two streams that are read together
+     * @param depth the maximum number of stripes to read ahead
+     * @param memoryBudget the maximum number of bytes of the stripes read ahead
+     */
+    StripePrefetcher(std::shared_ptr<FileContents> contents,
+                     const std::vector<bool>& selectedColumns, bool readIndexStreams,
+                     uint64_t maxGap, uint32_t depth, uint64_t memoryBudget);
+
+    ~StripePrefetcher();
+
+    /**
+     * Start reading the stripes after the last requested one, up to the
+     * configured depth and memory budget.
+     * @param nextStripe the first stripe that may be prefetched
+     * @param lastStripe the stripe AFTER the last one to prefetch
+     */
+    void schedule(uint64_t nextStripe, uint64_t lastStripe);
+
+    /**
+     * Get a prefetched stripe, waiting for it if it is still being read.
+     * Requests for the stripes before it are discarded.
+     * @return the stripe or nullptr if it was not prefetched
+     */
+    std::shared_ptr<PrefetchedStripe> take(uint64_t stripeIndex);
+  };
+
+}  // namespace orc
+
+#endif
@@ -0,0 +1,388 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "StripeReadPlanner.hh"
+
+#include <algorithm>
+#include <limits>
+#include <sstream>
+
+namespace orc {
+
+  static bool isIndexStream(proto::Stream_Kind kind) {
+    return kind == proto::Stream_Kind_ROW_INDEX || kind == proto::Stream_Kind_BLOOM_FILTER ||
+           kind == proto::Stream_Kind_BLOOM_FILTER_UTF8;
+  }
+
+  // Add a range after the given ones, merging it with the last one when they
+  // are separated by at most maxGap bytes.
+  static void addRange(std::vector<ReadRange>& ranges, uint64_t offset, uint64_t length,
+                       uint64_t maxGap) {
+    if (!ranges.empty()) {
+      ReadRange& last = ranges.back();
+      uint64_t lastEnd = last.offset + last.length;
+      if (offset <= lastEnd + maxGap) {
+        last.length = std::max(lastEnd, offset + length) - last.offset;
+        return;
+      }
+    }
+    ranges.push_back({offset, length});
+  }
+
+  std::vector<ReadRange> planStripeReads(const StreamDirectory& streams,
+                                         const std::vector<bool>& selectedColumns,
+                                         bool includeIndexStreams, bool includeDataStreams,
+                                         uint64_t maxGap) {
+    std::vector<ReadRange> ranges;
+    for (const auto& stream : streams.getStreams()) {
+      bool isSelected = stream.hasKind && stream.column < selectedColumns.size() &&
+                        selectedColumns[stream.column] &&
+                        (isIndexStream(stream.kind) ? includeIndexStreams : includeDataStreams);
+      // malformed streams are left to the regular read path to report
+      if (isSelected && stream.length > 0 &&
+          stream.offset + stream.length <= streams.getDataEnd()) {
+        addRange(ranges, stream.offset, stream.length, maxGap);
+      }
+    }
+    return ranges;
+  }
+
+  std::vector<ReadRange> planStripeFooterReads(const proto::StripeInformation& info,
+                                               bool includeIndexStreams, uint64_t maxGap) {
+    uint64_t dataStart = info.offset() + info.index_length();
+    uint64_t footerStart = dataStart + info.data_length();
+    std::vector<ReadRange> ranges;
+    if (includeIndexStreams && info.index_length() > 0 && info.index_length() <= maxGap) {
+      addRange(ranges, info.offset(), info.index_length(), maxGap);
+    }
+    if (info.data_length() > 0 && info.data_length() <= maxGap) {
+      addRange(ranges, dataStart, info.data_length(), maxGap);
+    }
+    addRange(ranges, footerStart, info.footer_length(), maxGap);
+    return ranges;
+  }
+
+  // the positions that a bit, a byte and an integer stream record in the
+  // row index, besides the position of the compression chunk
+  static const int BIT_STREAM_POSITIONS = 3;
+  static const int BYTE_STREAM_POSITIONS = 1;
+  static const int RLE_STREAM_POSITIONS = 2;
+
+  // the bytes that a run of integers may take at most without compression
+  static const uint64_t MAX_UNCOMPRESSED_RUN = 2 + 8 * 512;
+
+  /**
+   * Get the index of the first position of a stream in the row index entries
+   * of its column. The column readers seek the present stream first, then the
+   * data stream and then the length or secondary stream.
+   * @return the index or -1 if the stream has no positions
+   */
+  static int getPositionIndex(const Type& type, const proto::ColumnEncoding& encoding,
+                              proto::Stream_Kind kind, bool isCompressed, bool hasPresent) {
+    if (kind == proto::Stream_Kind_PRESENT) {
+      return 0;
+    }
+    int chunk = isCompressed ? 1 : 0;
+    int base = hasPresent ? BIT_STREAM_POSITIONS + chunk : 0;
+    switch (static_cast<int64_t>(type.getKind())) {
+      case STRING:
+      case VARCHAR:
+      case CHAR:
+      case BINARY:
+        if (encoding.kind() == proto::ColumnEncoding_Kind_DICTIONARY ||
+            encoding.kind() == proto::ColumnEncoding_Kind_DICTIONARY_V2) {
+          // the lengths and the bytes of the dictionary have no positions
+          return kind == proto::Stream_Kind_DATA ? base : -1;
+        }
+        if (kind == proto::Stream_Kind_LENGTH) {
+          return base + BYTE_STREAM_POSITIONS + chunk;
+        }
+        break;
+      case DECIMAL:
+        if (kind == proto::Stream_Kind_SECONDARY) {
+          return base + BYTE_STREAM_POSITIONS + chunk;
+        }
+        break;
+      case TIMESTAMP:
+      case TIMESTAMP_INSTANT:
+        if (kind == proto::Stream_Kind_SECONDARY) {
+          return base + RLE_STREAM_POSITIONS + chunk;
+        }
+        break;
+      default:
+        break;
+    }
+    return kind == proto::Stream_Kind_DATA || kind == proto::Stream_Kind_LENGTH ? base : -1;
+  }
+
+  std::vector<ReadRange> planRowGroupReads(
+      const StreamDirectory& streams, const proto::StripeFooter& footer, const Type& schema,
+      const std::vector<bool>& selectedColumns,
+      const std::unordered_map<uint64_t, proto::RowIndex>& rowIndexes,
+      const std::vector<bool>& selectedRowGroups, uint64_t compressionBlockSize, uint64_t maxGap) {
+    bool isCompressed = compressionBlockSize > 0;
+    // a row group may end in the chunk or the run after the start of the next one
+    uint64_t slop = isCompressed ? 2 * (compressionBlockSize + 3) : MAX_UNCOMPRESSED_RUN;
+
+    std::vector<ReadRange> ranges;
+    for (const auto& stream : streams.getStreams()) {
+      uint64_t offset = stream.offset;
+      uint64_t length = stream.length;
+      uint64_t column = stream.column;
+      bool isSelected = stream.hasKind && column < selectedColumns.size() &&
+                        selectedColumns[column] && !isIndexStream(stream.kind);
+      // malformed streams are left to the regular read path to report
+      if (isSelected && length > 0 && offset + length <= streams.getDataEnd()) {
+        auto rowIndex = rowIndexes.find(column);
+        const Type* type = schema.getTypeByColumnId(column);
+        int position = -1;
+        if (rowIndex != rowIndexes.end() && type != nullptr &&
+            column < static_cast<uint64_t>(footer.columns_size())) {
+          bool hasPresent = streams.find(column, proto::Stream_Kind_PRESENT) != nullptr;
+          position = getPositionIndex(*type, footer.columns(static_cast<int>(column)),
+                                      stream.kind, isCompressed, hasPresent);
+        }
+        auto getStart = [&](size_t rowGroup) -> uint64_t {
+          const proto::RowIndexEntry& entry = rowIndex->second.entry(static_cast<int>(rowGroup));
+          return std::min(length, entry.positions(position));
+        };
+        bool hasPositions = position >= 0;
+        for (int j = 0; hasPositions && j < rowIndex->second.entry_size(); ++j) {
+          hasPositions = rowIndex->second.entry(j).positions_size() > position;
+        }
+        if (!hasPositions) {
+          addRange(ranges, offset, length, maxGap);
+        } else {
+          size_t rowGroupCount = std::min(selectedRowGroups.size(),
+                                          static_cast<size_t>(rowIndex->second.entry_size()));
+          size_t rowGroup = 0;
+          while (rowGroup < rowGroupCount) {
+            if (!selectedRowGroups[rowGroup]) {
+              ++rowGroup;
+              continue;
+            }
+            uint64_t start = getStart(rowGroup);
+            while (rowGroup < rowGroupCount && selectedRowGroups[rowGroup]) {
+              ++rowGroup;
+            }
+            uint64_t end = rowGroup < rowGroupCount ? std::min(length, getStart(rowGroup) + slop)
+                                                    : length;
+            if (end > start) {
+              addRange(ranges, offset + start, end - start, maxGap);
+            }
+          }
+        }
+      }
+    }
+    return ranges;
+  }
+
+  void StripeBuffers::load(InputStream& stream, MemoryPool& pool,
+                           const std::vector<ReadRange>& ranges) {
+    std::vector<ReadRange> unmapped;
+    for (const auto& range : ranges) {
+      // a mapped file is read in place, without copying the ranges
+      if (getRange(range.offset, range.length) == nullptr &&
+          stream.getMappedRange(range.offset, range.length) == nullptr) {
+        unmapped.push_back(range);
+      }
+    }
+    if (unmapped.empty()) {
+      return;
+    }
+    std::vector<Buffer> newBuffers;
+    std::vector<void*> targets;
+    for (const auto& range : unmapped) {
+      auto data = std::make_unique<DataBuffer<char>>(pool, range.length);
+      targets.push_back(data->data());
+      newBuffers.push_back({range.offset, std::move(data)});
+    }
+    // submit all ranges together
+    stream.readv(unmapped, targets);
+    for (auto& buffer : newBuffers) {
+      buffers.push_back(std::move(buffer));
+    }
+  }
+
+  const char* StripeBuffers::getRange(uint64_t offset, uint64_t length) const {
+    for (const auto& buffer : buffers) {
+      if (offset >= buffer.offset && offset + length <= buffer.offset + buffer.data->size()) {
+        return buffer.data->data() + (offset - buffer.offset);
+      }
+    }
+    return nullptr;
+  }
+
+  const char* StripeBuffers::getPrefix(uint64_t offset, uint64_t& available) const {
+    const char* result = nullptr;
+    available = 0;
+    for (const auto& buffer : buffers) {
+      uint64_t end = buffer.offset + buffer.data->size();
+      if (offset >= buffer.offset && offset < end && end - offset > available) {
+        result = buffer.data->data() + (offset - buffer.offset);
+        available = end - offset;
+      }
+    }
+    return result;
+  }
+
+  uint64_t StripeBuffers::getNextOffset(uint64_t offset) const {
+    uint64_t result = std::numeric_limits<uint64_t>::max();
+    for (const auto& buffer : buffers) {
+      if (buffer.offset > offset) {
+        result = std::min(result, buffer.offset);
+      }
+    }
+    return result;
+  }
+
+  uint64_t StripeBuffers::getBufferedBytes() const {
+    uint64_t result = 0;
+    for (const auto& buffer : buffers) {
+      result += buffer.data->size();
+    }
+    return result;
+  }
+
+  /**
+   * A stream over a range of the file that the buffers hold in parts. The
+   * loaded parts are returned in place and the gaps between them are read
+   * from the file.
+   */
+  class SeekablePartialInputStream : public SeekableInputStream {
+   private:
+    const StripeBuffers& buffers;
+    InputStream* const input;
+    const uint64_t start;
+    const uint64_t length;
+    const uint64_t blockSize;
+    // the bytes of the last gap and their position in the stream
+    DataBuffer<char> buffer;
+    uint64_t bufferStart;
+    uint64_t position;
+    // the number of bytes that may be backed up
+    uint64_t lastSize;
+
+   public:
+    SeekablePartialInputStream(const StripeBuffers& _buffers, InputStream* _input,
+                               uint64_t offset, uint64_t byteCount, MemoryPool& pool,
+                               uint64_t _blockSize)
+        : buffers(_buffers),
+          input(_input),
+          start(offset),
+          length(byteCount),
+          blockSize(_blockSize == 0 ? 256 * 1024 : _blockSize),
+          buffer(pool),
+          bufferStart(0),
+          position(0),
+          lastSize(0) {
+      // PASS
+    }
+
+    bool Next(const void** data, int* size) override {
+      if (position >= length) {
+        lastSize = 0;
+        return false;
+      }
+      uint64_t available = 0;
+      const char* result = buffers.getPrefix(start + position, available);
+      if (result == nullptr) {
+        if (position < bufferStart || position >= bufferStart + buffer.size()) {
+          uint64_t gapEnd = std::min(length, buffers.getNextOffset(start + position) - start);
+          buffer.resize(std::min(gapEnd - position, blockSize));
+          input->read(buffer.data(), buffer.size(), start + position);
+          bufferStart = position;
+        }
+        result = buffer.data() + (position - bufferStart);
+        available = bufferStart + buffer.size() - position;
+      }
+      available = std::min({available, length - position,
+                            static_cast<uint64_t>(std::numeric_limits<int>::max())});
+      *data = result;
+      *size = static_cast<int>(available);
+      position += available;
+      lastSize = available;
+      return true;
+    }
+
+    void BackUp(int signedCount) override {
+      if (signedCount < 0) {
+        throw std::logic_error("can't backup negative distances");
+      }
+      uint64_t count = static_cast<uint64_t>(signedCount);
+      if (count > lastSize) {
+        throw std::logic_error("can't backup that far");
+      }
+      position -= count;
+      lastSize = 0;
+    }
+
+    bool Skip(int signedCount) override {
+      if (signedCount < 0) {
+        return false;
+      }
+      position = std::min(position + static_cast<uint64_t>(signedCount), length);
+      lastSize = 0;
+      return position < length;
+    }
+
+    int64_t ByteCount() const override {
+      return static_cast<int64_t>(position);
+    }
+
+    void seek(PositionProvider& location) override {
+      position = location.next();
+      lastSize = 0;
+      if (position > length) {
+        position = length;
+        throw std::logic_error("seek too far");
+      }
+    }
+
+    std::string getName() const override {
+      std::ostringstream result;
+      result << input->getName() << " from " << start << " for " << length;
+      return result.str();
+    }
+  };
+
+  std::unique_ptr<SeekableInputStream> createStripeInputStream(const StripeBuffers* buffers,
+                                                               InputStream* stream,
+                                                               uint64_t offset, uint64_t length,
+                                                               MemoryPool& pool,
+                                                               uint64_t blockSize,
+                                                               BufferPool* bufferPool) {
+    const char* data = buffers ? buffers->getRange(offset, length) : nullptr;
+    if (data != nullptr) {
+      return std::make_unique<SeekableArrayInputStream>(data, length);
+    }
+    data = stream->getMappedRange(offset, length);
+    if (data != nullptr) {
+      return std::make_unique<SeekableMappedInputStream>(stream, data, offset, length);
+    }
+    uint64_t available = 0;
+    if (buffers != nullptr && (buffers->getPrefix(offset, available) != nullptr ||
+                               buffers->getNextOffset(offset) < offset + length)) {
+      return std::make_unique<SeekablePartialInputStream>(*buffers, stream, offset, length, pool,
+                                                          blockSize);
+    }
+    return std::make_unique<SeekableFileInputStream>(stream, offset, length, pool, blockSize,
+                                                     bufferPool);
+  }
+
+}  // namespace orc
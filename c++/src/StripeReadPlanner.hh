@@ -0,0 +1,154 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ORC_STRIPE_READ_PLANNER_HH
+#define ORC_STRIPE_READ_PLANNER_HH
+
+#include "orc/MemoryPool.hh"
+#include "orc/OrcFile.hh"
+#include "orc/Type.hh"
+
+#include "StreamDirectory.hh"
+#include "io/InputStream.hh"
+#include "wrap/orc-proto-wrapper.hh"
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace orc {
+
+  /**
+   * Plan the reads of the streams of a stripe that belong to the selected
+   * columns. Streams that are separated by at most maxGap bytes are merged
+   * into a single range, so a stripe is read with a few large requests
+   * instead of one request per stream.
+   * @param streams the streams of the stripe
+   * @param selectedColumns the columns to read
+   * @param includeIndexStreams whether to read the row index and bloom filter streams
+   * @param includeDataStreams whether to read the other streams
+   * @param maxGap the largest number of unneeded bytes to read between two streams
+   * @return the ranges ordered by offset
+   */
+  std::vector<ReadRange> planStripeReads(const StreamDirectory& streams,
+                                         const std::vector<bool>& selectedColumns,
+                                         bool includeIndexStreams, bool includeDataStreams,
+                                         uint64_t maxGap);
+
+  /**
+   * Plan the read of the footer of a stripe, which the reads of its streams
+   * are planned from. The sections before the footer that take at most
+   * maxGap bytes are read along with it: the data section, and the index
+   * section when the index streams are needed. A small stripe is then read
+   * with a single request, and otherwise its streams are only read by a
+   * second request once the footer tells where they are.
+   * @param info the stripe
+   * @param includeIndexStreams whether to read the row index and bloom filter streams
+   * @param maxGap the largest number of unneeded bytes to read along with the footer
+   * @return the ranges ordered by offset
+   */
+  std::vector<ReadRange> planStripeFooterReads(const proto::StripeInformation& info,
+                                               bool includeIndexStreams, uint64_t maxGap);
+
+  /**
+   * Plan the reads of the data streams of a stripe for the selected row
+   * groups only. The row index positions of a row group give the part of
+   * each stream where the row group starts, and the row group is assumed to
+   * end within a compression chunk after the start of the next one. Streams
+   * without positions, such as dictionaries, are read as a whole.
+   * @param streams the streams of the stripe
+   * @param footer the stripe footer
+   * @param schema the file schema
+   * @param selectedColumns the columns to read
+   * @param rowIndexes the row indexes of the selected columns
+   * @param selectedRowGroups whether each row group of the stripe is read
+   * @param compressionBlockSize the compression block size or 0 if the file
+   *        is not compressed
+   * @param maxGap the largest number of unneeded bytes to read between two ranges
+   * @return the ranges ordered by offset
+   */
+  std::vector<ReadRange> planRowGroupReads(
+      const StreamDirectory& streams, const proto::StripeFooter& footer, const Type& schema,
+      const std::vector<bool>& selectedColumns,
+      const std::unordered_map<uint64_t, proto::RowIndex>& rowIndexes,
+      const std::vector<bool>& selectedRowGroups, uint64_t compressionBlockSize, uint64_t maxGap);
+
+  /**
+   * The bytes of the planned ranges of a stripe. The column readers consume
+   * slices of these buffers instead of reading each stream on its own.
+   */
+  class StripeBuffers {
+   private:
+    struct Buffer {
+      uint64_t offset;
+      std::unique_ptr<DataBuffer<char>> data;
+    };
+
+    std::vector<Buffer> buffers;
+
+   public:
+    /**
+     * Read the given ranges from the stream with a single request. The
+     * ranges that are already loaded or that the stream maps into memory
+     * are skipped.
+     */
+    void load(InputStream& stream, MemoryPool& pool, const std::vector<ReadRange>& ranges);
+
+    /**
+     * Get the loaded bytes of the given file range.
+     * @return a pointer to the bytes or nullptr if the range was not loaded
+     */
+    const char* getRange(uint64_t offset, uint64_t length) const;
+
+    /**
+     * Get the loaded bytes from the given file offset on.
+     * @param available set to the number of loaded bytes after the offset
+     * @return a pointer to the bytes or nullptr if the offset was not loaded
+     */
+    const char* getPrefix(uint64_t offset, uint64_t& available) const;
+
+    // the offset of the first loaded byte after the given offset, if any
+    uint64_t getNextOffset(uint64_t offset) const;
+
+    // the number of bytes held by the buffers
+    uint64_t getBufferedBytes() const;
+  };
+
+  /**
+   * Create a stream over a range of the file, which is served from the
+   * buffers when they hold the range and from the memory of the file when
+   * it is mapped. When the buffers hold parts of the range, the other parts
+   * are read from the file.
+   * @param buffers the loaded bytes of the stripe, may be nullptr
+   * @param stream the file to read from otherwise
+   * @param offset the position of the range in the file
+   * @param length the length of the range
+   * @param pool the memory pool
+   * @param blockSize the size of the reads from the file
+   * @param bufferPool the pool to borrow the read buffer from, may be nullptr
+   */
+  std::unique_ptr<SeekableInputStream> createStripeInputStream(const StripeBuffers* buffers,
+                                                               InputStream* stream,
+                                                               uint64_t offset, uint64_t length,
+                                                               MemoryPool& pool,
+                                                               uint64_t blockSize = 0,
+                                                               BufferPool* bufferPool = nullptr);
+
+}  // namespace orc
+
+#endif
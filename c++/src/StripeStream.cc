@@ -27,14 +27,15 @@ namespace orc {
 
   StripeStreamsImpl::StripeStreamsImpl(const RowReaderImpl& _reader, uint64_t _index,
                                        const proto::StripeInformation& _stripeInfo,
-                                       const proto::StripeFooter& _footer, uint64_t _stripeStart,
-                                       InputStream& _input, const Timezone& _writerTimezone,
+                                       const proto::StripeFooter& _footer,
+                                       const StreamDirectory& _streams, InputStream& _input,
+                                       const Timezone& _writerTimezone,
                                        const Timezone& _readerTimezone)
       : reader(_reader),
         stripeInfo(_stripeInfo),
         footer(_footer),
+        streams(_streams),
         stripeIndex(_index),
-        stripeStart(_stripeStart),
         input(_input),
         writerTimezone(_writerTimezone),
         readerTimezone(_readerTimezone) {
@@ -80,36 +81,37 @@ namespace orc {
   std::unique_ptr<SeekableInputStream> StripeStreamsImpl::getStream(uint64_t columnId,
                                                                     proto::Stream_Kind kind,
                                                                     bool shouldStream) const {
-    uint64_t offset = stripeStart;
-    uint64_t dataEnd = stripeInfo.offset() + stripeInfo.index_length() + stripeInfo.data_length();
-    MemoryPool* pool = reader.getFileContents().pool;
-    for (int i = 0; i < footer.streams_size(); ++i) {
-      const proto::Stream& stream = footer.streams(i);
-      if (stream.has_kind() && stream.kind() == kind &&
-          stream.column() == static_cast<uint64_t>(columnId)) {
-        uint64_t streamLength = stream.length();
-        uint64_t myBlock = shouldStream ? input.getNaturalReadSize() : streamLength;
-        if (offset + streamLength > dataEnd) {
-          std::stringstream msg;
-          msg << "Malformed stream meta at stream index " << i << " in stripe " << stripeIndex
-              << ": streamOffset=" << offset << ", streamLength=" << streamLength
-              << ", stripeOffset=" << stripeInfo.offset()
-              << ", stripeIndexLength=" << stripeInfo.index_length()
-              << ", stripeDataLength=" << stripeInfo.data_length();
-          throw ParseError(msg.str());
-        }
-        return createDecompressor(reader.getCompression(),
-                                  std::make_unique<SeekableFileInputStream>(
-                                      &input, offset, stream.length(), *pool, myBlock),
-                                  reader.getCompressionSize(), *pool,
-                                  reader.getFileContents().readerMetrics);
-      }
-      offset += stream.length();
+    const StreamDirectory::Entry* stream = streams.find(columnId, kind);
+    if (stream == nullptr) {
+      return nullptr;
+    }
+    uint64_t offset = stream->offset;
+    uint64_t streamLength = stream->length;
+    uint64_t myBlock = shouldStream ? input.getNaturalReadSize() : streamLength;
+    if (offset + streamLength > streams.getDataEnd()) {
+      std::stringstream msg;
+      msg << "Malformed stream meta at stream index " << stream->index << " in stripe "
+          << stripeIndex << ": streamOffset=" << offset << ", streamLength=" << streamLength
+          << ", stripeOffset=" << stripeInfo.offset()
+          << ", stripeIndexLength=" << stripeInfo.index_length()
+          << ", stripeDataLength=" << stripeInfo.data_length();
+      throw ParseError(msg.str());
     }
-    return nullptr;
+    MemoryPool* pool = &reader.getColumnMemoryPool();
+    DecompressedChunkKey cacheKey = getChunkCacheKey(reader.getFileContents(), offset);
+    return createDecompressor(
+        reader.getCompression(),
+        createStripeInputStream(reader.getStripeBuffers(), &input, offset, streamLength, *pool,
+                                myBlock, reader.getBufferPool()),
+        reader.getCompressionSize(), *pool, reader.getFileContents().readerMetrics, &cacheKey,
+        reader.getBufferPool());
   }
 
   MemoryPool& StripeStreamsImpl::getMemoryPool() const {
+    return reader.getColumnMemoryPool();
+  }
+
+  MemoryPool& StripeStreamsImpl::getBatchMemoryPool() const {
     return *reader.getFileContents().pool;
   }
 
@@ -133,6 +135,10 @@ namespace orc {
     return reader.getSchemaEvolution();
   }
 
+  ThreadPool* StripeStreamsImpl::getDecodePool() const {
+    return reader.getDecodePool();
+  }
+
   void StripeInformationImpl::ensureStripeFooterLoaded() const {
     if (stripeFooter.get() == nullptr) {
       std::unique_ptr<SeekableInputStream> pbStream =
@@ -24,6 +24,7 @@
 #include "orc/Reader.hh"
 
 #include "ColumnReader.hh"
+#include "StreamDirectory.hh"
 #include "Timezone.hh"
 #include "TypeImpl.hh"
 
@@ -40,8 +41,8 @@ namespace orc {
     const RowReaderImpl& reader;
     const proto::StripeInformation& stripeInfo;
     const proto::StripeFooter& footer;
+    const StreamDirectory& streams;
     const uint64_t stripeIndex;
-    const uint64_t stripeStart;
     InputStream& input;
     const Timezone& writerTimezone;
     const Timezone& readerTimezone;
@@ -49,8 +50,8 @@ namespace orc {
    public:
     StripeStreamsImpl(const RowReaderImpl& reader, uint64_t index,
                       const proto::StripeInformation& stripeInfo, const proto::StripeFooter& footer,
-                      uint64_t stripeStart, InputStream& input, const Timezone& writerTimezone,
-                      const Timezone& readerTimezone);
+                      const StreamDirectory& streams, InputStream& input,
+                      const Timezone& writerTimezone, const Timezone& readerTimezone);
 
     virtual ~StripeStreamsImpl() override;
 
@@ -79,6 +80,10 @@ namespace orc {
     int32_t getForcedScaleOnHive11Decimal() const override;
 
     const SchemaEvolution* getSchemaEvolution() const override;
+
+    ThreadPool* getDecodePool() const override;
+
+    MemoryPool& getBatchMemoryPool() const override;
   };
 
   /**
@@ -0,0 +1,136 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ThreadPool.hh"
+
+#include <stdexcept>
+
+namespace orc {
+
+  ThreadPool::ThreadPool(uint32_t threadCount) : nextQueue(0), queuedCount(0), stopping(false) {
+    if (threadCount == 0) {
+      throw std::logic_error("A thread pool needs at least one thread");
+    }
+    for (uint32_t i = 0; i < threadCount; ++i) {
+      queues.push_back(std::make_unique<Queue>());
+    }
+    for (uint32_t i = 0; i < threadCount; ++i) {
+      threads.emplace_back(&ThreadPool::work, this, i);
+    }
+  }
+
+  ThreadPool::~ThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock(sleepMutex);
+      stopping = true;
+    }
+    wakeUp.notify_all();
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
+
+  void ThreadPool::run(const std::vector<std::function<void()>>& functions) {
+    if (functions.empty()) {
+      return;
+    }
+    TaskGroup group;
+    group.remaining = functions.size();
+    // count the tasks first, so the count never drops below zero
+    queuedCount.fetch_add(functions.size());
+    for (const auto& function : functions) {
+      Queue& queue = *queues[nextQueue.fetch_add(1) % queues.size()];
+      std::lock_guard<std::mutex> lock(queue.mutex);
+      queue.tasks.push_back({&function, &group});
+    }
+    {
+      // synchronize with the threads that are about to sleep
+      std::lock_guard<std::mutex> lock(sleepMutex);
+    }
+    wakeUp.notify_all();
+
+    // help with the queued tasks instead of blocking
+    Task task;
+    while (pop(0, task)) {
+      execute(task);
+      std::lock_guard<std::mutex> lock(group.mutex);
+      if (group.remaining == 0) {
+        break;
+      }
+    }
+    std::unique_lock<std::mutex> lock(group.mutex);
+    group.done.wait(lock, [&group] { return group.remaining == 0; });
+    if (group.error) {
+      std::rethrow_exception(group.error);
+    }
+  }
+
+  void ThreadPool::work(size_t queueIndex) {
+    Task task;
+    while (true) {
+      if (pop(queueIndex, task)) {
+        execute(task);
+        continue;
+      }
+      std::unique_lock<std::mutex> lock(sleepMutex);
+      wakeUp.wait(lock, [this] { return stopping || queuedCount.load() > 0; });
+      if (stopping) {
+        return;
+      }
+    }
+  }
+
+  bool ThreadPool::pop(size_t queueIndex, Task& task) {
+    for (size_t i = 0; i < queues.size(); ++i) {
+      Queue& queue = *queues[(queueIndex + i) % queues.size()];
+      std::lock_guard<std::mutex> lock(queue.mutex);
+      if (queue.tasks.empty()) {
+        continue;
+      }
+      // take the oldest task of the own queue and steal the newest of the others
+      if (i == 0) {
+        task = queue.tasks.front();
+        queue.tasks.pop_front();
+      } else {
+        task = queue.tasks.back();
+        queue.tasks.pop_back();
+      }
+      queuedCount.fetch_sub(1);
+      return true;
+    }
+    return false;
+  }
+
+  void ThreadPool::execute(const Task& task) {
+    std::exception_ptr error;
+    try {
+      (*task.function)();
+    } catch (...) {
+      error = std::current_exception();
+    }
+    // the group may be destroyed as soon as the lock is released
+    std::lock_guard<std::mutex> lock(task.group->mutex);
+    if (error && !task.group->error) {
+      task.group->error = error;
+    }
+    if (--task.group->remaining == 0) {
+      task.group->done.notify_all();
+    }
+  }
+
+}  // namespace orc
@@ -0,0 +1,93 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ORC_THREAD_POOL_HH
+#define ORC_THREAD_POOL_HH
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace orc {
+
+  /**
+   * A pool of threads that run groups of short tasks. Every thread has its
+   * own queue and steals from the queues of the others when its own one is
+   * empty. The thread that waits for a group runs queued tasks as well, so
+   * tasks may run groups of their own without deadlocking the pool.
+   */
+  class ThreadPool {
+   public:
+    /**
+     * @param threadCount the number of threads in the pool
+     */
+    explicit ThreadPool(uint32_t threadCount);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    uint32_t getThreadCount() const {
+      return static_cast<uint32_t>(threads.size());
+    }
+
+    /**
+     * Run the tasks and wait until all of them finished.
+     * If tasks throw, the first exception is rethrown.
+     */
+    void run(const std::vector<std::function<void()>>& tasks);
+
+   private:
+    struct TaskGroup {
+      std::mutex mutex;
+      std::condition_variable done;
+      size_t remaining;
+      std::exception_ptr error;
+    };
+
+    struct Task {
+      const std::function<void()>* function;
+      TaskGroup* group;
+    };
+
+    struct Queue {
+      std::mutex mutex;
+      std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> threads;
+    std::atomic<size_t> nextQueue;
+    std::atomic<size_t> queuedCount;
+    std::mutex sleepMutex;
+    std::condition_variable wakeUp;
+    bool stopping;
+
+    void work(size_t queueIndex);
+    bool pop(size_t queueIndex, Task& task);
+    void execute(const Task& task);
+  };
+
+}  // namespace orc
+
+#endif
@@ -24,6 +24,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
+#include <algorithm>
 #include <filesystem>
 #include <map>
 #include <sstream>
@@ -233,6 +234,8 @@ namespace orc {
     virtual ~FutureRuleImpl() override;
     bool isDefined() const override;
     const TimezoneVariant& getVariant(int64_t clk) const override;
+    const TimezoneVariant& getVariantRange(int64_t clk, int64_t& start,
+                                           int64_t& end) const override;
     void print(std::ostream& out) const override;
 
     friend class FutureRuleParser;
@@ -267,6 +270,33 @@ namespace orc {
     }
   }
 
+  const TimezoneVariant& FutureRuleImpl::getVariantRange(int64_t clk, int64_t& start,
+                                                         int64_t& end) const {
+    if (!hasDst) {
+      start = INT64_MIN;
+      end = INT64_MAX;
+      return standard;
+    }
+    int64_t adjusted = clk % SECONDS_PER_400_YEARS;
+    if (adjusted < 0) {
+      adjusted += SECONDS_PER_400_YEARS;
+    }
+    int64_t idx = binarySearch(offsets, adjusted);
+    // the range stops at the end of the 400 year cycle
+    int64_t cycleStart = clk - adjusted;
+    start = cycleStart + offsets[static_cast<size_t>(idx)];
+    if (static_cast<size_t>(idx) + 1 < offsets.size()) {
+      end = cycleStart + offsets[static_cast<size_t>(idx) + 1] - 1;
+    } else {
+      end = cycleStart + SECONDS_PER_400_YEARS - 1;
+    }
+    if (startInStd == (idx % 2 == 0)) {
+      return standard;
+    } else {
+      return dst;
+    }
+  }
+
   void FutureRuleImpl::print(std::ostream& out) const {
     if (isDefined()) {
       out << "  Future rule: " << ruleString << "\n";
@@ -573,6 +603,9 @@ namespace orc {
      */
     const TimezoneVariant& getVariant(int64_t clk) const override;
 
+    const TimezoneVariant& getVariantRange(int64_t clk, int64_t& start,
+                                           int64_t& end) const override;
+
     void print(std::ostream&) const override;
 
     uint64_t getVersion() const override {
@@ -868,6 +901,30 @@ namespace orc {
     }
   }
 
+  const TimezoneVariant& TimezoneImpl::getVariantRange(int64_t clk, int64_t& start,
+                                                       int64_t& end) const {
+    if (clk > lastTransition) {
+      const TimezoneVariant& result = futureRule->getVariantRange(clk, start, end);
+      start = std::max(start, lastTransition + 1);
+      return result;
+    }
+    int64_t transition = binarySearch(transitions, clk);
+    uint64_t idx;
+    if (transition < 0) {
+      start = INT64_MIN;
+      idx = ancientVariant;
+    } else {
+      start = transitions[static_cast<size_t>(transition)];
+      idx = currentVariant[static_cast<size_t>(transition)];
+    }
+    if (static_cast<size_t>(transition + 1) < transitions.size()) {
+      end = transitions[static_cast<size_t>(transition + 1)] - 1;
+    } else {
+      end = lastTransition;
+    }
+    return variants[idx];
+  }
+
   void TimezoneImpl::print(std::ostream& out) const {
     out << "Timezone file: " << filename << "\n";
     out << "  Version: " << version << "\n";
@@ -63,6 +63,16 @@ namespace orc {
      */
     virtual const TimezoneVariant& getVariant(int64_t clk) const = 0;
 
+    /**
+     * Get the variant for the given time (time_t) and the range of times
+     * around it that have the same variant.
+     * @param clk the time
+     * @param start set to the first time of the range
+     * @param end set to the last time of the range
+     */
+    virtual const TimezoneVariant& getVariantRange(int64_t clk, int64_t& start,
+                                                   int64_t& end) const = 0;
+
     /**
      * Get the number of seconds between the ORC epoch in this timezone
      * and Unix epoch.
@@ -127,6 +137,8 @@ namespace orc {
     virtual ~FutureRule();
     virtual bool isDefined() const = 0;
     virtual const TimezoneVariant& getVariant(int64_t clk) const = 0;
+    virtual const TimezoneVariant& getVariantRange(int64_t clk, int64_t& start,
+                                                   int64_t& end) const = 0;
     virtual void print(std::ostream& out) const = 0;
   };
 
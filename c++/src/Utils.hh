@@ -19,6 +19,8 @@
 #ifndef ORC_UTILS_HH
 #define ORC_UTILS_HH
 
+#include "orc/MemoryPool.hh"
+
 #include <atomic>
 #include <chrono>
 
@@ -70,6 +72,19 @@ namespace orc {
 #define SCOPED_MINUS_STOPWATCH(METRICS_PTR, LATENCY_VAR)
 #endif
 
+  // Copy the stats of a memory pool that keeps track of them to the
+  // ReaderMetrics or WriterMetrics.
+  template <typename Metrics>
+  void updateMemoryPoolMetrics(const MemoryPool& pool, Metrics* metrics) {
+    MemoryPoolStats stats;
+    if (metrics != nullptr && pool.getStats(stats)) {
+      metrics->MemoryPoolAllocatedBytes.store(stats.allocatedBytes);
+      metrics->MemoryPoolPeakBytes.store(stats.peakAllocatedBytes);
+      metrics->MemoryPoolAllocationCount.store(stats.allocationCount);
+      metrics->MemoryPoolReusedAllocationCount.store(stats.reusedAllocationCount);
+    }
+  }
+
 }  // namespace orc
 
 #endif
@@ -394,6 +394,7 @@ namespace orc {
     if (columnWriter->getEstimatedSize() >= options.getStripeSize()) {
       writeStripe();
     }
+    updateMemoryPoolMetrics(*options.getMemoryPool(), options.getWriterMetrics());
   }
 
   void WriterImpl::close() {
@@ -404,6 +405,7 @@ namespace orc {
     writeFileFooter();
     writePostscript();
     outStream->close();
+    updateMemoryPoolMetrics(*options.getMemoryPool(), options.getWriterMetrics());
   }
 
   uint64_t WriterImpl::writeIntermediateFooter() {
@@ -19,6 +19,7 @@
 #include "InputStream.hh"
 #include "orc/Exceptions.hh"
 
+#include <limits.h>
 #include <algorithm>
 #include <iomanip>
 
@@ -126,20 +127,44 @@ namespace orc {
     return result.str();
   }
 
+  SeekableMappedInputStream::SeekableMappedInputStream(const InputStream* _input,
+                                                       const char* _data, uint64_t _offset,
+                                                       uint64_t _byteCount, uint64_t _blockSize)
+      // Next() reports the size of a block as an int
+      : SeekableArrayInputStream(_data, _byteCount,
+                                 std::min(_blockSize == 0 ? _byteCount : _blockSize,
+                                          static_cast<uint64_t>(INT_MAX))),
+        input(_input),
+        start(_offset),
+        length(_byteCount) {
+    // PASS
+  }
+
+  SeekableMappedInputStream::~SeekableMappedInputStream() {
+    // PASS
+  }
+
+  std::string SeekableMappedInputStream::getName() const {
+    std::ostringstream result;
+    result << input->getName() << " from " << start << " for " << length;
+    return result.str();
+  }
+
   static uint64_t computeBlock(uint64_t request, uint64_t length) {
     return std::min(length, request == 0 ? 256 * 1024 : request);
   }
 
   SeekableFileInputStream::SeekableFileInputStream(InputStream* stream, uint64_t offset,
                                                    uint64_t byteCount, MemoryPool& _pool,
-                                                   uint64_t _blockSize)
+                                                   uint64_t _blockSize, BufferPool* bufferPool)
       : pool(_pool),
         input(stream),
         start(offset),
         length(byteCount),
-        blockSize(computeBlock(_blockSize, length)) {
+        blockSize(computeBlock(_blockSize, length)),
+        buffer(pool, bufferPool) {
+    bufferLength = 0;
     position = 0;
-    buffer.reset(new DataBuffer<char>(pool));
     pushBack = 0;
   }
 
@@ -150,15 +175,19 @@ namespace orc {
   bool SeekableFileInputStream::Next(const void** data, int* size) {
     uint64_t bytesRead;
     if (pushBack != 0) {
-      *data = buffer->data() + (buffer->size() - pushBack);
+      *data = buffer.data() + (bufferLength - pushBack);
       bytesRead = pushBack;
     } else {
       bytesRead = std::min(length - position, blockSize);
-      buffer->resize(bytesRead);
       if (bytesRead > 0) {
-        input->read(buffer->data(), bytesRead, start + position);
-        *data = static_cast<void*>(buffer->data());
+        buffer.reserve(bytesRead);
+        input->read(buffer.data(), bytesRead, start + position);
+        *data = static_cast<void*>(buffer.data());
+      } else {
+        // the range is exhausted
+        buffer.release();
       }
+      bufferLength = bytesRead;
     }
     position += bytesRead;
     pushBack = 0;
@@ -188,6 +217,9 @@ namespace orc {
     uint64_t count = static_cast<uint64_t>(signedCount);
     position = std::min(position + count, length);
     pushBack = 0;
+    if (position == length) {
+      buffer.release();
+    }
     return position < length;
   }
 
@@ -202,6 +234,9 @@ namespace orc {
       throw std::logic_error("seek too far");
     }
     pushBack = 0;
+    if (position == length) {
+      buffer.release();
+    }
   }
 
   std::string SeekableFileInputStream::getName() const {
@@ -20,6 +20,7 @@
 #define ORC_INPUTSTREAM_HH
 
 #include "Adaptor.hh"
+#include "BufferPool.hh"
 #include "orc/OrcFile.hh"
 #include "wrap/zero-copy-stream-wrapper.h"
 
@@ -77,6 +78,24 @@ namespace orc {
     virtual std::string getName() const override;
   };
 
+  /**
+   * Create a seekable input stream over a range of a file that is mapped
+   * into memory. Next() returns pointers into the mapping, so the bytes are
+   * never copied.
+   */
+  class SeekableMappedInputStream : public SeekableArrayInputStream {
+   private:
+    const InputStream* const input;
+    const uint64_t start;
+    const uint64_t length;
+
+   public:
+    SeekableMappedInputStream(const InputStream* input, const char* data, uint64_t offset,
+                              uint64_t byteCount, uint64_t blockSize = 0);
+    virtual ~SeekableMappedInputStream() override;
+    virtual std::string getName() const override;
+  };
+
   /**
    * Create a seekable input stream based on an input stream.
    */
@@ -87,13 +106,16 @@ namespace orc {
     const uint64_t start;
     const uint64_t length;
     const uint64_t blockSize;
-    std::unique_ptr<DataBuffer<char> > buffer;
+    // the bytes of the last read, which is given back at the end of the range
+    PooledBuffer buffer;
+    uint64_t bufferLength;
     uint64_t position;
     uint64_t pushBack;
 
    public:
     SeekableFileInputStream(InputStream* input, uint64_t offset, uint64_t byteCount,
-                            MemoryPool& pool, uint64_t blockSize = 0);
+                            MemoryPool& pool, uint64_t blockSize = 0,
+                            BufferPool* bufferPool = nullptr);
     virtual ~SeekableFileInputStream() override;
 
     virtual bool Next(const void** data, int* size) override;
@@ -17,10 +17,15 @@
  */
 
 #include "BlockBuffer.hh"
+#include "MemoryArena.hh"
 #include "MemoryOutputStream.hh"
+#include "orc/Exceptions.hh"
+#include "orc/Int128.hh"
 #include "orc/OrcFile.hh"
 #include "wrap/gtest-wrapper.h"
 
+#include <cstring>
+
 namespace orc {
   const int DEFAULT_MEM_STREAM_SIZE = 10 * 1024 * 1024;  // 10M
 
@@ -118,4 +123,168 @@ namespace orc {
     // test block size > natural write size
     writeToOutputStream(4096);
   }
+
+  TEST(TestDataBuffer, resizeUninitialized) {
+    DataBuffer<char> buffer(*getDefaultPool(), 100);
+    memset(buffer.data(), 'a', 100);
+    EXPECT_EQ(100, buffer.capacity());
+
+    // the capacity at least doubles and the content is kept
+    buffer.resizeUninitialized(120);
+    EXPECT_EQ(120, buffer.size());
+    EXPECT_EQ(200, buffer.capacity());
+    EXPECT_EQ('a', buffer[99]);
+    buffer.resizeUninitialized(50);
+    buffer.resizeUninitialized(200);
+    EXPECT_EQ(200, buffer.capacity());
+    buffer.resizeUninitialized(1000);
+    EXPECT_EQ(1000, buffer.capacity());
+
+    DataBuffer<Int128> values(*getDefaultPool());
+    values.resizeUninitialized(3);
+    EXPECT_EQ(0, values[2].toLong());
+  }
+
+  TEST(TestDataBuffer, shrinkToFit) {
+    DataBuffer<int64_t> buffer(*getDefaultPool(), 1000);
+    buffer.resize(300);
+    EXPECT_FALSE(buffer.shrinkToFit());
+    EXPECT_EQ(1000, buffer.capacity());
+
+    buffer.resize(100);
+    buffer[99] = 42;
+    EXPECT_TRUE(buffer.shrinkToFit());
+    EXPECT_EQ(200, buffer.capacity());
+    EXPECT_EQ(100, buffer.size());
+    EXPECT_EQ(42, buffer[99]);
+
+    buffer.resize(0);
+    EXPECT_TRUE(buffer.shrinkToFit());
+    EXPECT_EQ(0, buffer.capacity());
+    buffer.resize(10);
+    EXPECT_EQ(0, buffer[9]);
+  }
+
+  TEST(TestMemoryPool, alignedDataBuffers) {
+    auto tracking = createTrackingMemoryPool(*getDefaultPool());
+    auto sizeClass = createSizeClassMemoryPool(*getDefaultPool());
+    MemoryArena arena(*getDefaultPool());
+    for (MemoryPool* pool : {getDefaultPool(), tracking.get(), sizeClass.get(),
+                             static_cast<MemoryPool*>(&arena)}) {
+      DataBuffer<int64_t> values(*pool, 3);
+      DataBuffer<char> blob(*pool, 1);
+      for (uint64_t size = 10; size < 100000; size *= 3) {
+        values.resize(size);
+        blob.resize(size);
+        EXPECT_EQ(0, reinterpret_cast<uintptr_t>(values.data()) % DATA_BUFFER_ALIGNMENT);
+        EXPECT_EQ(0, reinterpret_cast<uintptr_t>(blob.data()) % DATA_BUFFER_ALIGNMENT);
+      }
+    }
+    MemoryPoolStats stats;
+    tracking->getStats(stats);
+    EXPECT_EQ(0, stats.allocatedBytes);
+  }
+
+  TEST(TestMemoryPool, hugePages) {
+    auto pool = createHugePageMemoryPool();
+    DataBuffer<int64_t> values(*pool, 512 * 1024);
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(values.data()) % DATA_BUFFER_ALIGNMENT);
+    memset(values.data(), 1, values.size() * sizeof(int64_t));
+    char* small = pool->malloc(100);
+    memset(small, 1, 100);
+    pool->free(small);
+  }
+
+  TEST(TestMemoryPool, tracking) {
+    auto pool = createTrackingMemoryPool(*getDefaultPool(), 1000);
+    MemoryPoolStats stats;
+    EXPECT_FALSE(getDefaultPool()->getStats(stats));
+
+    char* first = pool->malloc(600);
+    char* second = pool->malloc(300);
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(first) % 16);
+    memset(first, 1, 600);
+    EXPECT_THROW(pool->malloc(200), MemoryLimitExceeded);
+    pool->free(first);
+    char* third = pool->malloc(200);
+    ASSERT_TRUE(pool->getStats(stats));
+    EXPECT_EQ(500, stats.allocatedBytes);
+    EXPECT_EQ(900, stats.peakAllocatedBytes);
+    EXPECT_EQ(3, stats.allocationCount);
+    pool->free(second);
+    pool->free(third);
+    pool->getStats(stats);
+    EXPECT_EQ(0, stats.allocatedBytes);
+  }
+
+  TEST(TestMemoryPool, sizeClass) {
+    auto tracking = createTrackingMemoryPool(*getDefaultPool());
+    {
+      auto pool = createSizeClassMemoryPool(*tracking, 16 * 1024 * 1024);
+      char* first = pool->malloc(3000);
+      pool->free(first);
+      // the freed memory of the size class is allocated again
+      char* second = pool->malloc(4096);
+      EXPECT_EQ(first, second);
+      char* large = pool->malloc(8 * 1024 * 1024);
+      MemoryPoolStats stats;
+      ASSERT_TRUE(pool->getStats(stats));
+      EXPECT_EQ(4096 + 8 * 1024 * 1024, stats.allocatedBytes);
+      EXPECT_EQ(3, stats.allocationCount);
+      EXPECT_EQ(1, stats.reusedAllocationCount);
+
+      // the allocations beyond the largest size class are not cached
+      pool->free(large);
+      pool->free(second);
+      pool->getStats(stats);
+      EXPECT_EQ(4096, stats.allocatedBytes);
+
+      // aligned memory comes from the size class of its size
+      char* aligned = pool->mallocAligned(64 * 1024, DATA_BUFFER_ALIGNMENT);
+      EXPECT_EQ(0, reinterpret_cast<uintptr_t>(aligned) % DATA_BUFFER_ALIGNMENT);
+      pool->getStats(stats);
+      EXPECT_EQ(4096 + 64 * 1024, stats.allocatedBytes);
+      pool->freeAligned(aligned);
+      EXPECT_EQ(aligned, pool->mallocAligned(64 * 1024, DATA_BUFFER_ALIGNMENT));
+      pool->freeAligned(aligned);
+      char* page = pool->mallocAligned(1000, 4096);
+      EXPECT_EQ(0, reinterpret_cast<uintptr_t>(page) % 4096);
+      memset(page, 1, 1000);
+      pool->freeAligned(page);
+    }
+    MemoryPoolStats stats;
+    tracking->getStats(stats);
+    EXPECT_EQ(0, stats.allocatedBytes);
+  }
+
+  TEST(TestMemoryPool, arena) {
+    auto tracking = createTrackingMemoryPool(*getDefaultPool());
+    MemoryArena arena(*tracking, 1024);
+    char* first = arena.malloc(10);
+    char* second = arena.malloc(100);
+    EXPECT_EQ(first + 16, second);
+    arena.free(first);
+    char* large = arena.malloc(1000);
+    memset(large, 1, 1000);
+    MemoryPoolStats stats;
+    ASSERT_TRUE(arena.getStats(stats));
+    EXPECT_EQ(1024 + 1008, stats.allocatedBytes);
+    EXPECT_EQ(3, stats.allocationCount);
+
+    // aligned memory is cut from the chunk after a little padding
+    char* aligned = arena.mallocAligned(64, DATA_BUFFER_ALIGNMENT);
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(aligned) % DATA_BUFFER_ALIGNMENT);
+    EXPECT_LT(aligned, second + 100 + DATA_BUFFER_ALIGNMENT);
+    EXPECT_EQ(aligned + 64, arena.mallocAligned(10, DATA_BUFFER_ALIGNMENT));
+    arena.freeAligned(aligned);
+    arena.getStats(stats);
+    EXPECT_EQ(1024 + 1008, stats.allocatedBytes);
+
+    arena.reset();
+    arena.getStats(stats);
+    EXPECT_EQ(0, stats.allocatedBytes);
+    EXPECT_EQ(1024 + 1008, stats.peakAllocatedBytes);
+    tracking->getStats(stats);
+    EXPECT_EQ(0, stats.allocatedBytes);
+  }
 }  // namespace orc
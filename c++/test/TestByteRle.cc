@@ -18,13 +18,18 @@
 
 #include "Adaptor.hh"
 #include "ByteRLE.hh"
+#include "ByteRleAvx2.hh"
+#include "ByteRleDefault.hh"
+#include "Dispatch.hh"
 #include "Compression.hh"
 #include "MemoryInputStream.hh"
 #include "MemoryOutputStream.hh"
 #include "OrcTest.hh"
 #include "wrap/gtest-wrapper.h"
 
+#include <bitset>
 #include <iostream>
+#include <random>
 #include <vector>
 
 namespace orc {
@@ -1331,4 +1336,187 @@ namespace orc {
     delete[] data;
     delete[] decodedData;
   }
+
+  TEST(BooleanRle, unpackBooleansMatchesDefault) {
+    std::mt19937 random(42);
+    std::vector<unsigned char> bits(256);
+    for (auto& byte : bits) {
+      byte = static_cast<unsigned char>(random());
+    }
+    for (uint64_t numValues : {0, 1, 7, 63, 64, 65, 130, 1000}) {
+      std::vector<char> notNull(numValues);
+      for (auto& present : notNull) {
+        present = static_cast<char>(random() % 3 != 0);
+      }
+      EXPECT_EQ(ByteRleDefault::countNonZero(notNull.data(), numValues),
+                countNonZero(notNull.data(), numValues));
+      std::vector<char> expectedRun(numValues, 2);
+      std::vector<char> run(numValues, 2);
+      EXPECT_EQ(ByteRleDefault::fillRun(expectedRun.data(), 5, numValues, notNull.data()),
+                fillRun(run.data(), 5, numValues, notNull.data()));
+      EXPECT_EQ(expectedRun, run);
+      std::vector<const char*> masks = {nullptr, notNull.data()};
+      for (uint64_t bitOffset = 0; bitOffset < 8; ++bitOffset) {
+        for (const char* mask : masks) {
+          std::vector<char> expected(numValues, 2);
+          std::vector<char> actual(numValues, 2);
+          uint64_t expectedOnes = ByteRleDefault::unpackBooleans(
+              bits.data(), bitOffset, expected.data(), numValues, mask);
+          uint64_t ones = unpackBooleans(bits.data(), bitOffset, actual.data(), numValues, mask);
+          EXPECT_EQ(expectedOnes, ones);
+          EXPECT_EQ(expected, actual) << numValues << " values from bit " << bitOffset;
+          uint64_t bit = bitOffset;
+          for (uint64_t i = 0; i < numValues; ++i) {
+            char value = 0;
+            if (!mask || mask[i]) {
+              value = static_cast<char>((bits[bit / 8] >> (7 - bit % 8)) & 1);
+              bit += 1;
+            }
+            ASSERT_EQ(value, expected[i]) << "Output wrong at " << i;
+          }
+        }
+      }
+    }
+  }
+
+#if defined(ORC_HAVE_RUNTIME_AVX2)
+  TEST(BooleanRle, avx2KernelsMatchDefault) {
+    if (!CpuInfo::getInstance()->isDetected(CpuInfo::AVX2 | CpuInfo::BMI2)) {
+      GTEST_SKIP() << "AVX2 is not available";
+    }
+    std::mt19937 random(5);
+    std::vector<unsigned char> bits(256);
+    for (auto& byte : bits) {
+      byte = static_cast<unsigned char>(random());
+    }
+    for (uint64_t numValues : {0, 5, 31, 32, 33, 100, 1000}) {
+      std::vector<char> notNull(numValues);
+      for (auto& present : notNull) {
+        present = static_cast<char>(random() % 3 != 0);
+      }
+      EXPECT_EQ(ByteRleDefault::countNonZero(notNull.data(), numValues),
+                ByteRleAVX2::countNonZero(notNull.data(), numValues));
+      std::vector<char> expectedRun(numValues, 2);
+      std::vector<char> run(numValues, 2);
+      EXPECT_EQ(ByteRleDefault::fillRun(expectedRun.data(), 5, numValues, notNull.data()),
+                ByteRleAVX2::fillRun(run.data(), 5, numValues, notNull.data()));
+      EXPECT_EQ(expectedRun, run);
+      std::vector<const char*> masks = {nullptr, notNull.data()};
+      for (uint64_t bitOffset = 0; bitOffset < 8; ++bitOffset) {
+        for (const char* mask : masks) {
+          std::vector<char> expected(numValues, 2);
+          std::vector<char> actual(numValues, 2);
+          EXPECT_EQ(ByteRleDefault::unpackBooleans(bits.data(), bitOffset, expected.data(),
+                                                   numValues, mask),
+                    ByteRleAVX2::unpackBooleans(bits.data(), bitOffset, actual.data(), numValues,
+                                                mask));
+          EXPECT_EQ(expected, actual) << numValues << " values from bit " << bitOffset;
+        }
+      }
+    }
+  }
+#endif
+
+  TEST(BooleanRle, nextAndCount) {
+    MemoryOutputStream memStream(1024 * 1024);
+    auto outStream = std::make_unique<BufferedOutputStream>(*getDefaultPool(), &memStream,
+                                                            500 * 1024, 1024, nullptr);
+    std::unique_ptr<ByteRleEncoder> encoder = createBooleanRleEncoder(std::move(outStream));
+
+    std::mt19937 random(7);
+    uint64_t numValues = 5000;
+    std::vector<char> data(numValues);
+    for (uint64_t i = 0; i < numValues; ++i) {
+      // long runs of the same value mixed with random values
+      data[i] = static_cast<char>((i / 700) % 2 == 0 ? (i / 1400) % 2 : random() % 2);
+    }
+    encoder->add(data.data(), numValues, nullptr);
+    encoder->flush();
+
+    std::unique_ptr<ByteRleDecoder> decoder = createBooleanRleDecoder(
+        std::make_unique<SeekableArrayInputStream>(memStream.getData(), memStream.getLength()),
+        getDefaultReaderMetrics());
+    std::vector<char> notNull(numValues);
+    std::vector<char> result(numValues);
+    uint64_t consumed = 0;
+    // stop while a whole batch is left, so the decoder never runs out of values
+    while (numValues - consumed >= 300) {
+      uint64_t batchSize = 1 + random() % 300;
+      for (uint64_t i = 0; i < batchSize; ++i) {
+        notNull[i] = static_cast<char>(random() % 4 != 0);
+      }
+      uint64_t ones = decoder->nextAndCount(result.data(), batchSize, notNull.data());
+      uint64_t expectedOnes = 0;
+      for (uint64_t i = 0; i < batchSize; ++i) {
+        if (notNull[i]) {
+          ASSERT_EQ(data[consumed], result[i]) << "Output wrong at value " << consumed;
+          expectedOnes += static_cast<uint64_t>(data[consumed]);
+          consumed += 1;
+        } else {
+          ASSERT_EQ(0, result[i]);
+        }
+      }
+      EXPECT_EQ(expectedOnes, ones);
+    }
+  }
+
+  TEST(BooleanRle, skipAndCount) {
+    MemoryOutputStream memStream(1024 * 1024);
+    auto outStream = std::make_unique<BufferedOutputStream>(*getDefaultPool(), &memStream,
+                                                            500 * 1024, 1024, nullptr);
+    std::unique_ptr<ByteRleEncoder> encoder = createBooleanRleEncoder(std::move(outStream));
+
+    std::mt19937 random(9);
+    uint64_t numValues = 20000;
+    std::vector<char> data(numValues);
+    for (uint64_t i = 0; i < numValues; ++i) {
+      // long runs of the same value mixed with random values
+      data[i] = static_cast<char>((i / 900) % 2 == 0 ? (i / 1800) % 2 : random() % 2);
+    }
+    encoder->add(data.data(), numValues, nullptr);
+    encoder->flush();
+
+    std::unique_ptr<ByteRleDecoder> decoder = createBooleanRleDecoder(
+        std::make_unique<SeekableArrayInputStream>(memStream.getData(), memStream.getLength()),
+        getDefaultReaderMetrics());
+    std::vector<char> result(numValues);
+    uint64_t consumed = 0;
+    while (numValues - consumed >= 3000) {
+      // skip a few values or a few runs, then read some
+      uint64_t skipSize = random() % 2 == 0 ? random() % 20 : random() % 2000;
+      uint64_t expectedOnes = 0;
+      for (uint64_t i = 0; i < skipSize; ++i) {
+        expectedOnes += static_cast<uint64_t>(data[consumed + i]);
+      }
+      EXPECT_EQ(expectedOnes, decoder->skipAndCount(skipSize));
+      consumed += skipSize;
+
+      uint64_t batchSize = random() % 30;
+      decoder->next(result.data(), batchSize, nullptr);
+      for (uint64_t i = 0; i < batchSize; ++i) {
+        ASSERT_EQ(data[consumed], result[i]) << "Output wrong at value " << consumed;
+        consumed += 1;
+      }
+    }
+  }
+
+  TEST(BooleanRle, countBitsMatchesDefault) {
+    std::mt19937 random(13);
+    std::vector<unsigned char> bytes(100);
+    for (auto& byte : bytes) {
+      byte = static_cast<unsigned char>(random());
+    }
+    for (uint64_t numBytes = 0; numBytes <= bytes.size(); ++numBytes) {
+      uint64_t expected = 0;
+      for (uint64_t i = 0; i < numBytes; ++i) {
+        expected += std::bitset<8>(bytes[i]).count();
+      }
+      EXPECT_EQ(expected, ByteRleDefault::countBits(bytes.data(), numBytes));
+#if defined(ORC_HAVE_RUNTIME_AVX2)
+      if (CpuInfo::getInstance()->isDetected(CpuInfo::AVX2 | CpuInfo::BMI2)) {
+        EXPECT_EQ(expected, ByteRleAVX2::countBits(bytes.data(), numBytes));
+      }
+#endif
+    }
+  }
 }  // namespace orc
@@ -25,6 +25,7 @@
 #include "wrap/orc-proto-wrapper.hh"
 
 #include <algorithm>
+#include <vector>
 
 namespace orc {
   const int DEFAULT_MEM_STREAM_SIZE = 1024 * 1024 * 2;  // 2M
@@ -369,4 +370,49 @@ namespace orc {
     testSeekDecompressionStream(CompressionKind_LZ4);
     testSeekDecompressionStream(CompressionKind_SNAPPY);
   }
+
+  void testSkipDecompressionStream(CompressionKind kind) {
+    MemoryOutputStream memStream(DEFAULT_MEM_STREAM_SIZE);
+    MemoryPool* pool = getDefaultPool();
+    uint64_t blockSize = 256;
+
+    // random bytes are stored as original chunks, letters are compressed
+    std::vector<char> data(64 * 1024);
+    generateRandomData(data.data(), data.size() / 2, false);
+    generateRandomData(data.data() + data.size() / 2, data.size() / 2, true);
+    compressAndVerify(kind, &memStream, CompressionStrategy_SPEED, DEFAULT_MEM_STREAM_SIZE,
+                      blockSize, *pool, data.data(), data.size());
+
+    for (size_t skip : {1UL, 255UL, 256UL, 1000UL, 4096UL, 33000UL, 40000UL, 65535UL}) {
+      auto inputStream =
+          std::make_unique<SeekableArrayInputStream>(memStream.getData(), memStream.getLength());
+      std::unique_ptr<SeekableInputStream> decompressStream = createDecompressor(
+          kind, std::move(inputStream), blockSize, *pool, getDefaultReaderMetrics());
+
+      // skip twice, with a read in between
+      size_t pos = 0;
+      for (size_t repeat = 0; repeat != 2 && pos + skip < data.size(); ++repeat) {
+        ASSERT_TRUE(decompressStream->Skip(static_cast<int>(skip)));
+        pos += skip;
+        const void* chunk;
+        int size;
+        ASSERT_TRUE(decompressStream->Next(&chunk, &size));
+        ASSERT_GT(size, 0);
+        size_t length = std::min(static_cast<size_t>(size), data.size() - pos);
+        EXPECT_EQ(0, memcmp(data.data() + pos, chunk, length)) << "skip " << skip;
+        pos += static_cast<size_t>(size);
+      }
+    }
+  }
+
+  TEST(Compression, skipDecompressionStream) {
+    testSkipDecompressionStream(CompressionKind_ZSTD);
+    testSkipDecompressionStream(CompressionKind_ZLIB);
+    testSkipDecompressionStream(CompressionKind_LZ4);
+    testSkipDecompressionStream(CompressionKind_NONE);
+  }
+
+  TEST(Compression, skipSnappyDecompressionStream) {
+    testSkipDecompressionStream(CompressionKind_SNAPPY);
+  }
 }  // namespace orc
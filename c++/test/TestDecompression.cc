@@ -277,6 +277,62 @@ namespace orc {
     EXPECT_EQ(true, !stream.Next(&ptr, &len));
   }
 
+  TEST_F(TestDecompression, testFileReadv) {
+    SCOPED_TRACE("testFileReadv");
+    std::unique_ptr<InputStream> file = readLocalFile(simpleFile, getDefaultReaderMetrics());
+    char buf[5][40];
+    // two adjacent ranges given out of order, a gap and a range at the end
+    std::vector<ReadRange> ranges = {{20, 10}, {10, 10}, {50, 40}, {90, 5}, {195, 5}};
+    std::vector<void*> buffers;
+    for (size_t i = 0; i < ranges.size(); ++i) {
+      buffers.push_back(buf[i]);
+    }
+    file->readv(ranges, buffers);
+    for (size_t i = 0; i < ranges.size(); ++i) {
+      checkBytes(buf[i], static_cast<int>(ranges[i].length),
+                 static_cast<unsigned int>(ranges[i].offset));
+    }
+
+    memset(buf, 0, sizeof(buf));
+    file->readAsync(ranges, buffers).get();
+    for (size_t i = 0; i < ranges.size(); ++i) {
+      checkBytes(buf[i], static_cast<int>(ranges[i].length),
+                 static_cast<unsigned int>(ranges[i].offset));
+    }
+
+    std::vector<void*> missing(buffers.begin(), buffers.end() - 1);
+    EXPECT_THROW(file->readv(ranges, missing), std::logic_error);
+    std::vector<ReadRange> pastEnd = {{190, 20}};
+    std::vector<void*> pastEndBuffer = {buf[0]};
+    EXPECT_THROW(file->readv(pastEnd, pastEndBuffer), ParseError);
+  }
+
+  TEST_F(TestDecompression, testMappedFile) {
+    SCOPED_TRACE("testMappedFile");
+    std::unique_ptr<InputStream> file = readMappedLocalFile(simpleFile);
+    const char* mapped = file->getMappedRange(100, 100);
+    ASSERT_NE(nullptr, mapped);
+    SeekableMappedInputStream stream(file.get(), mapped, 100, 100, 30);
+    const void* ptr;
+    int len;
+    ASSERT_EQ(true, stream.Next(&ptr, &len));
+    // the bytes are not copied
+    EXPECT_EQ(mapped, ptr);
+    EXPECT_EQ(30, len);
+    checkBytes(static_cast<const char*>(ptr), len, 100);
+    stream.BackUp(10);
+    ASSERT_EQ(true, stream.Skip(40));
+    ASSERT_EQ(true, stream.Next(&ptr, &len));
+    EXPECT_EQ(30, len);
+    checkBytes(static_cast<const char*>(ptr), len, 160);
+    EXPECT_EQ("simple-file.binary from 100 for 100", stream.getName());
+
+    char buf[20];
+    file->read(buf, 20, 180);
+    checkBytes(buf, 20, 180);
+    EXPECT_THROW(file->read(buf, 20, 190), ParseError);
+  }
+
   TEST_F(TestDecompression, testFileSeek) {
     SCOPED_TRACE("testFileSeek");
     std::unique_ptr<InputStream> file = readLocalFile(simpleFile, getDefaultReaderMetrics());
@@ -18,7 +18,12 @@
 
 #include <cstring>
 
+#include "BufferPool.hh"
+#include "Compression.hh"
 #include "Reader.hh"
+#include "ThreadPool.hh"
+#include "io/InputStream.hh"
+#include "orc/ColumnPrinter.hh"
 #include "orc/Reader.hh"
 
 #include "Adaptor.hh"
@@ -757,4 +762,1301 @@ namespace orc {
       }
     }
   }
+
+  // Small stripes of ZLIB compressed row groups of 1000 rows.
+  WriterOptions multiStripeWriterOptions() {
+    WriterOptions options;
+    options.setStripeSize(1024)
+        .setCompressionBlockSize(1024)
+        .setCompression(CompressionKind_ZLIB)
+        .setMemoryPool(getDefaultPool())
+        .setRowIndexStride(1000);
+    return options;
+  }
+
+  // Write rowCount rows in batches of batchSize. The rows hold their number, the number modulo
+  // 5000 as a string and a multiple of the number that is null for every third row.
+  void writeMultiStripeFile(MemoryOutputStream& memStream, uint64_t rowCount, uint64_t batchSize,
+                            const WriterOptions& options = multiStripeWriterOptions()) {
+    auto type = std::unique_ptr<Type>(
+        Type::buildTypeFromString("struct<col1:bigint,col2:string,col3:bigint>"));
+    auto writer = createWriter(*type, &memStream, options);
+    auto batch = writer->createRowBatch(batchSize);
+    auto& structBatch = dynamic_cast<StructVectorBatch&>(*batch);
+    auto& longBatch = dynamic_cast<LongVectorBatch&>(*structBatch.fields[0]);
+    auto& stringBatch = dynamic_cast<StringVectorBatch&>(*structBatch.fields[1]);
+    auto& nullBatch = dynamic_cast<LongVectorBatch&>(*structBatch.fields[2]);
+    std::vector<std::string> values(batchSize);
+    nullBatch.hasNulls = true;
+    for (uint64_t row = 0; row < rowCount; row += batchSize) {
+      for (uint64_t i = 0; i < batchSize; ++i) {
+        longBatch.data[i] = static_cast<int64_t>(row + i);
+        values[i] = std::to_string((row + i) % 5000);
+        stringBatch.data[i] = const_cast<char*>(values[i].c_str());
+        stringBatch.length[i] = static_cast<int64_t>(values[i].size());
+        nullBatch.notNull[i] = (row + i) % 3 != 0;
+        nullBatch.data[i] = static_cast<int64_t>((row + i) * 7);
+      }
+      structBatch.numElements = longBatch.numElements = stringBatch.numElements =
+          nullBatch.numElements = batchSize;
+      writer->add(*batch);
+    }
+    writer->close();
+  }
+
+  std::unique_ptr<Reader> createMultiStripeMemReader(MemoryOutputStream& memStream,
+                                                     ReaderMetrics* metrics, uint64_t rowCount,
+                                                     uint64_t batchSize) {
+    writeMultiStripeFile(memStream, rowCount, batchSize);
+    auto inStream = std::make_unique<MemoryInputStream>(memStream.getData(), memStream.getLength());
+    ReaderOptions readerOptions;
+    readerOptions.setMemoryPool(*getDefaultPool());
+    readerOptions.setReaderMetrics(metrics);
+    return createReader(std::move(inStream), readerOptions);
+  }
+
+  void verifyMultiStripeRows(RowReader& rowReader, uint64_t firstRow, uint64_t rowCount) {
+    auto batch = rowReader.createRowBatch(1000);
+    uint64_t expected = firstRow;
+    while (rowReader.next(*batch)) {
+      auto& structBatch = dynamic_cast<StructVectorBatch&>(*batch);
+      auto& longBatch = dynamic_cast<LongVectorBatch&>(*structBatch.fields[0]);
+      auto& stringBatch = dynamic_cast<StringVectorBatch&>(*structBatch.fields[1]);
+      auto& nullBatch = dynamic_cast<LongVectorBatch&>(*structBatch.fields[2]);
+      for (uint64_t i = 0; i < batch->numElements; ++i, ++expected) {
+        EXPECT_EQ(static_cast<int64_t>(expected), longBatch.data[i]);
+        EXPECT_EQ(std::to_string(expected % 5000),
+                  std::string(stringBatch.data[i], static_cast<size_t>(stringBatch.length[i])));
+        ASSERT_EQ(expected % 3 != 0, nullBatch.notNull[i] != 0) << expected;
+        if (expected % 3 != 0) {
+          EXPECT_EQ(static_cast<int64_t>(expected * 7), nullBatch.data[i]);
+        }
+      }
+    }
+    EXPECT_EQ(rowCount, expected);
+  }
+
+  TEST(TestRowReader, testPrefetchStripes) {
+    MemoryOutputStream memStream(DEFAULT_MEM_STREAM_SIZE);
+    ReaderMetrics metrics;
+    uint64_t rowCount = 20000;
+    auto reader = createMultiStripeMemReader(memStream, &metrics, rowCount, 2000);
+    EXPECT_GT(reader->getNumberOfStripes(), 2);
+
+    RowReaderOptions options;
+    options.setPrefetchStripeCount(2);
+    EXPECT_EQ(2, options.getPrefetchStripeCount());
+    auto rowReader = reader->createRowReader(options);
+    verifyMultiStripeRows(*rowReader, 0, rowCount);
+    // every stripe but the first one is read ahead
+    EXPECT_EQ(reader->getNumberOfStripes() - 1, metrics.PrefetchStripeCount.load());
+
+    // seeking backwards discards the pending stripes
+    rowReader->seekToRow(5000);
+    verifyMultiStripeRows(*rowReader, 5000, rowCount);
+  }
+
+  TEST(TestRowReader, testPrefetchMemoryBudget) {
+    MemoryOutputStream memStream(DEFAULT_MEM_STREAM_SIZE);
+    ReaderMetrics metrics;
+    uint64_t rowCount = 20000;
+    auto reader = createMultiStripeMemReader(memStream, &metrics, rowCount, 2000);
+
+    RowReaderOptions options;
+    options.setPrefetchStripeCount(4).setPrefetchMemoryBudget(1);
+    EXPECT_EQ(1, options.getPrefetchMemoryBudget());
+    auto rowReader = reader->createRowReader(options);
+    verifyMultiStripeRows(*rowReader, 0, rowCount);
+    // no stripe fits into the budget
+    EXPECT_EQ(0, metrics.PrefetchStripeCount.load());
+  }
+
+  class CountingMemoryInputStream : public MemoryInputStream {
+   public:
+    CountingMemoryInputStream(const char* buffer, size_t size)
+        : MemoryInputStream(buffer, size),
+          readCount(0),
+          readBytes(0),
+          readvCount(0),
+          readvRangeCount(0) {}
+
+    void read(void* buf, uint64_t length, uint64_t offset) override {
+      ++readCount;
+      readBytes += length;
+      MemoryInputStream::read(buf, length, offset);
+    }
+
+    void readv(const std::vector<ReadRange>& ranges, const std::vector<void*>& buffers) override {
+      ++readvCount;
+      readvRangeCount += ranges.size();
+      MemoryInputStream::readv(ranges, buffers);
+    }
+
+    uint64_t getReadCount() const {
+      return readCount;
+    }
+
+    uint64_t getReadBytes() const {
+      return readBytes;
+    }
+
+    uint64_t getReadvCount() const {
+      return readvCount;
+    }
+
+    // the number of reads that are not a range of a readv
+    uint64_t getSingleReadCount() const {
+      return readCount - readvRangeCount;
+    }
+
+   private:
+    // the prefetching threads read concurrently
+    std::atomic<uint64_t> readCount;
+    std::atomic<uint64_t> readBytes;
+    std::atomic<uint64_t> readvCount;
+    std::atomic<uint64_t> readvRangeCount;
+  };
+
+  TEST(TestRowReader, testCoalesceReads) {
+    MemoryOutputStream memStream(DEFAULT_MEM_STREAM_SIZE);
+    uint64_t rowCount = 20000;
+    writeMultiStripeFile(memStream, rowCount, 2000);
+
+    uint64_t readCount[2];
+    for (bool coalesce : {false, true}) {
+      auto inStream =
+          std::make_unique<CountingMemoryInputStream>(memStream.getData(), memStream.getLength());
+      CountingMemoryInputStream* countingStream = inStream.get();
+      auto reader = createReader(std::move(inStream), ReaderOptions());
+      uint64_t tailReadCount = countingStream->getReadCount();
+
+      RowReaderOptions options;
+      options.setCoalesceReads(coalesce);
+      EXPECT_EQ(coalesce, options.getCoalesceReads());
+      auto rowReader = reader->createRowReader(options);
+      verifyMultiStripeRows(*rowReader, 0, rowCount);
+      readCount[coalesce] = countingStream->getReadCount() - tailReadCount;
+      if (coalesce) {
+        // the small stripes are read along with their footers
+        EXPECT_EQ(reader->getNumberOfStripes(), readCount[coalesce]);
+      }
+    }
+    EXPECT_LT(readCount[1], readCount[0]);
+  }
+
+  TEST(TestRowReader, testCoalesceSelectedRowGroups) {
+    uint64_t rowCount = 50000;
+    for (auto compression : {CompressionKind_NONE, CompressionKind_ZLIB}) {
+      for (double dictionaryThreshold : {0.0, 1.0}) {
+        MemoryOutputStream memStream(DEFAULT_MEM_STREAM_SIZE);
+        // a single stripe with many row groups
+        auto writerOptions = multiStripeWriterOptions();
+        writerOptions.setStripeSize(64 * 1024 * 1024)
+            .setCompression(compression)
+            .setDictionaryKeySizeThreshold(dictionaryThreshold);
+        writeMultiStripeFile(memStream, rowCount, rowCount, writerOptions);
+
+        uint64_t readBytes[2];
+        for (bool selectRowGroups : {false, true}) {
+          auto inStream = std::make_unique<CountingMemoryInputStream>(memStream.getData(),
+                                                                      memStream.getLength());
+          CountingMemoryInputStream* countingStream = inStream.get();
+          auto reader = createReader(std::move(inStream), ReaderOptions());
+          ASSERT_EQ(1, reader->getNumberOfStripes());
+          uint64_t tailBytes = countingStream->getReadBytes();
+
+          RowReaderOptions options;
+          // the file is too small for the default gap to separate the row groups
+          options.setCoalesceReads(true).setCoalesceMaxGap(64);
+          // rows [20000, 21000) and [35000, 36000)
+          options.searchArgument(
+              SearchArgumentFactory::newBuilder()
+                  ->startOr()
+                  .between("col1", PredicateDataType::LONG, Literal(static_cast<int64_t>(20100)),
+                           Literal(static_cast<int64_t>(20200)))
+                  .equals("col1", PredicateDataType::LONG, Literal(static_cast<int64_t>(
+                                                               selectRowGroups ? 35500 : -1)))
+                  .end()
+                  .build());
+          auto rowReader = reader->createRowReader(options);
+          auto readBatch = rowReader->createRowBatch(700);
+          std::vector<uint64_t> rows;
+          while (rowReader->next(*readBatch)) {
+            auto& fields = dynamic_cast<StructVectorBatch&>(*readBatch).fields;
+            auto& ids = dynamic_cast<LongVectorBatch&>(*fields[0]);
+            auto& strings = dynamic_cast<StringVectorBatch&>(*fields[1]);
+            auto& nullable = dynamic_cast<LongVectorBatch&>(*fields[2]);
+            for (uint64_t i = 0; i < readBatch->numElements; ++i) {
+              uint64_t row = static_cast<uint64_t>(ids.data[i]);
+              rows.push_back(row);
+              EXPECT_EQ(std::to_string(row % 5000),
+                        std::string(strings.data[i], static_cast<size_t>(strings.length[i])));
+              EXPECT_EQ(row % 3 != 0, nullable.notNull[i] != 0);
+              if (row % 3 != 0) {
+                EXPECT_EQ(static_cast<int64_t>(row * 7), nullable.data[i]);
+              }
+            }
+          }
+          uint64_t expectedRows = selectRowGroups ? 2000 : 1000;
+          ASSERT_EQ(expectedRows, rows.size());
+          for (uint64_t i = 0; i < rows.size(); ++i) {
+            EXPECT_EQ((i < 1000 ? 20000 : 34000) + i, rows[i]);
+          }
+          readBytes[selectRowGroups] = countingStream->getReadBytes() - tailBytes;
+          EXPECT_LT(readBytes[selectRowGroups], memStream.getLength());
+          if (dictionaryThreshold == 0.0) {
+            // with direct encoding only the streams around the selected row
+            // groups are read
+            EXPECT_LT(readBytes[selectRowGroups], memStream.getLength() / 5);
+          }
+        }
+        EXPECT_LT(readBytes[0], readBytes[1]);
+      }
+    }
+  }
+
+  TEST(TestRowReader, testCoalesceStripeFooterWithIndex) {
+    MemoryOutputStream memStream(DEFAULT_MEM_STREAM_SIZE);
+    uint64_t rowCount = 50000;
+    writeMultiStripeFile(memStream, rowCount, rowCount,
+                         multiStripeWriterOptions().setStripeSize(64 * 1024 * 1024));
+    auto inStream =
+        std::make_unique<CountingMemoryInputStream>(memStream.getData(), memStream.getLength());
+    CountingMemoryInputStream* countingStream = inStream.get();
+    auto reader = createReader(std::move(inStream), ReaderOptions());
+    ASSERT_EQ(1, reader->getNumberOfStripes());
+    auto stripe = reader->getStripe(0);
+    ASSERT_LT(stripe->getIndexLength(), stripe->getDataLength());
+
+    // the index section is read with the footer, the data section is not
+    RowReaderOptions options;
+    options.setCoalesceReads(true).setCoalesceMaxGap(stripe->getIndexLength());
+    options.searchArgument(
+        SearchArgumentFactory::newBuilder()
+            ->between("col1", PredicateDataType::LONG, Literal(static_cast<int64_t>(20100)),
+                      Literal(static_cast<int64_t>(20200)))
+            .build());
+    auto rowReader = reader->createRowReader(options);
+    // the stripe statistics are read by now
+    uint64_t tailReadCount = countingStream->getReadCount();
+    auto batch = rowReader->createRowBatch(1000);
+    uint64_t rows = 0;
+    while (rowReader->next(*batch)) {
+      auto& ids =
+          dynamic_cast<LongVectorBatch&>(*dynamic_cast<StructVectorBatch&>(*batch).fields[0]);
+      for (uint64_t i = 0; i < batch->numElements; ++i) {
+        EXPECT_EQ(static_cast<int64_t>(20000 + rows + i), ids.data[i]);
+      }
+      rows += batch->numElements;
+    }
+    EXPECT_EQ(1000, rows);
+    // one request for the footer and the index, one for the selected row group
+    EXPECT_EQ(2, countingStream->getReadvCount());
+    EXPECT_EQ(tailReadCount, countingStream->getSingleReadCount());
+  }
+
+  TEST(TestRowReader, testLimit) {
+    MemoryOutputStream memStream(DEFAULT_MEM_STREAM_SIZE);
+    uint64_t rowCount = 20000;
+    writeMultiStripeFile(memStream, rowCount, 2000);
+    auto openFile = [&memStream](CountingMemoryInputStream*& countingStream) {
+      auto inStream =
+          std::make_unique<CountingMemoryInputStream>(memStream.getData(), memStream.getLength());
+      countingStream = inStream.get();
+      return createReader(std::move(inStream), ReaderOptions());
+    };
+
+    CountingMemoryInputStream* countingStream;
+    auto reader = openFile(countingStream);
+    ASSERT_GT(reader->getNumberOfStripes(), 3);
+    uint64_t stripeRows = reader->getStripe(0)->getNumberOfRows();
+    RowReaderOptions options;
+    EXPECT_EQ(std::numeric_limits<uint64_t>::max(), options.getLimit());
+    options.limit(stripeRows + 500).setPrefetchStripeCount(4);
+    EXPECT_EQ(stripeRows + 500, options.getLimit());
+    uint64_t tailBytes = countingStream->getReadBytes();
+    auto rowReader = reader->createRowReader(options);
+    verifyMultiStripeRows(*rowReader, 0, stripeRows + 500);
+    auto batch = rowReader->createRowBatch(1000);
+    EXPECT_FALSE(rowReader->next(*batch));
+    rowReader.reset();
+    // the stripes after the limit are not prefetched
+    EXPECT_LE(countingStream->getReadBytes() - tailBytes,
+              reader->getStripe(0)->getLength() + reader->getStripe(1)->getLength());
+
+    // the limit counts the rows from the position of a seek on
+    options = RowReaderOptions();
+    rowReader = reader->createRowReader(options.limit(1500));
+    rowReader->seekToRow(5000);
+    verifyMultiStripeRows(*rowReader, 5000, 6500);
+
+    // a coalesced read of the last stripe stops at the row group of the limit
+    MemoryOutputStream rowGroupStream(DEFAULT_MEM_STREAM_SIZE);
+    writeMultiStripeFile(rowGroupStream, 50000, 50000,
+                         multiStripeWriterOptions().setStripeSize(64 * 1024 * 1024));
+    uint64_t readBytes[2];
+    for (uint64_t limit : {1500, 50000}) {
+      auto inStream = std::make_unique<CountingMemoryInputStream>(rowGroupStream.getData(),
+                                                                  rowGroupStream.getLength());
+      countingStream = inStream.get();
+      auto rowGroupReader = createReader(std::move(inStream), ReaderOptions());
+      tailBytes = countingStream->getReadBytes();
+      options = RowReaderOptions();
+      options.limit(limit).setCoalesceReads(true).setCoalesceMaxGap(64);
+      rowReader = rowGroupReader->createRowReader(options);
+      auto rowGroupBatch = rowReader->createRowBatch(1000);
+      uint64_t rows = 0;
+      while (rowReader->next(*rowGroupBatch)) {
+        auto& ids = dynamic_cast<LongVectorBatch&>(
+            *dynamic_cast<StructVectorBatch&>(*rowGroupBatch).fields[0]);
+        for (uint64_t i = 0; i < rowGroupBatch->numElements; ++i, ++rows) {
+          EXPECT_EQ(static_cast<int64_t>(rows), ids.data[i]);
+        }
+      }
+      EXPECT_EQ(limit, rows);
+      readBytes[limit == 50000] = countingStream->getReadBytes() - tailBytes;
+    }
+    EXPECT_LT(readBytes[0], readBytes[1] / 5);
+
+    // the limit bounds the rows of all stripes that are decoded in parallel
+    auto parallelReader = reader->createParallelRowReader(RowReaderOptions().limit(4321), 1000, 3);
+    uint64_t parallelRows = 0;
+    while (auto parallelBatch = parallelReader->next()) {
+      parallelRows += parallelBatch->numElements;
+    }
+    EXPECT_EQ(4321, parallelRows);
+  }
+
+  TEST(TestRowReader, planStripeReads) {
+    proto::StripeInformation info;
+    info.set_offset(100);
+    info.set_index_length(30);
+    info.set_data_length(300);
+    proto::StripeFooter footer;
+    auto addStream = [&footer](proto::Stream_Kind kind, uint32_t column, uint64_t length) {
+      proto::Stream* stream = footer.add_streams();
+      stream->set_kind(kind);
+      stream->set_column(column);
+      stream->set_length(length);
+    };
+    addStream(proto::Stream_Kind_ROW_INDEX, 1, 10);  // [100, 110)
+    addStream(proto::Stream_Kind_ROW_INDEX, 2, 20);  // [110, 130)
+    addStream(proto::Stream_Kind_DATA, 1, 100);      // [130, 230)
+    addStream(proto::Stream_Kind_DATA, 2, 50);       // [230, 280)
+    addStream(proto::Stream_Kind_DATA, 3, 100);      // [280, 380)
+    addStream(proto::Stream_Kind_LENGTH, 3, 50);     // [380, 430)
+    std::vector<bool> selectedColumns = {true, true, false, true};
+
+    auto toPairs = [](const std::vector<ReadRange>& ranges) {
+      std::vector<std::pair<uint64_t, uint64_t>> result;
+      for (const auto& range : ranges) {
+        result.emplace_back(range.offset, range.length);
+      }
+      return result;
+    };
+    using Ranges = std::vector<std::pair<uint64_t, uint64_t>>;
+    StreamDirectory streams(info, footer);
+    EXPECT_EQ((Ranges{{130, 100}, {280, 150}}),
+              toPairs(planStripeReads(streams, selectedColumns, false, true, 0)));
+    EXPECT_EQ((Ranges{{130, 300}}),
+              toPairs(planStripeReads(streams, selectedColumns, false, true, 50)));
+    EXPECT_EQ((Ranges{{100, 10}}),
+              toPairs(planStripeReads(streams, selectedColumns, true, false, 0)));
+    EXPECT_EQ((Ranges{{100, 10}, {130, 100}, {280, 150}}),
+              toPairs(planStripeReads(streams, selectedColumns, true, true, 0)));
+    EXPECT_EQ((Ranges{{100, 130}, {280, 150}}),
+              toPairs(planStripeReads(streams, selectedColumns, true, true, 20)));
+  }
+
+  TEST(TestRowReader, streamDirectory) {
+    proto::StripeInformation info;
+    info.set_offset(100);
+    info.set_index_length(30);
+    info.set_data_length(300);
+    proto::StripeFooter footer;
+    for (int i = 0; i < 4; ++i) {
+      footer.add_columns()->set_kind(proto::ColumnEncoding_Kind_DIRECT);
+    }
+    auto addStream = [&footer](proto::Stream_Kind kind, uint32_t column, uint64_t length) {
+      proto::Stream* stream = footer.add_streams();
+      stream->set_kind(kind);
+      stream->set_column(column);
+      stream->set_length(length);
+    };
+    addStream(proto::Stream_Kind_ROW_INDEX, 3, 10);  // [100, 110)
+    addStream(proto::Stream_Kind_ROW_INDEX, 1, 20);  // [110, 130)
+    addStream(proto::Stream_Kind_DATA, 1, 100);      // [130, 230)
+    footer.add_streams()->set_length(50);            // [230, 280) without a kind
+    addStream(proto::Stream_Kind_DATA, 3, 100);      // [280, 380)
+    addStream(proto::Stream_Kind_LENGTH, 3, 50);     // [380, 430)
+    addStream(proto::Stream_Kind_DATA, 7, 10);       // [430, 440) of an unknown column
+
+    StreamDirectory streams(info, footer);
+    EXPECT_EQ(430, streams.getDataEnd());
+    EXPECT_EQ(7, streams.getStreams().size());
+
+    const StreamDirectory::Entry* stream = streams.find(3, proto::Stream_Kind_LENGTH);
+    ASSERT_NE(nullptr, stream);
+    EXPECT_EQ(5, stream->index);
+    EXPECT_EQ(380, stream->offset);
+    EXPECT_EQ(50, stream->length);
+    stream = streams.find(1, proto::Stream_Kind_DATA);
+    ASSERT_NE(nullptr, stream);
+    EXPECT_EQ(130, stream->offset);
+    stream = streams.find(3, proto::Stream_Kind_ROW_INDEX);
+    ASSERT_NE(nullptr, stream);
+    EXPECT_EQ(100, stream->offset);
+
+    EXPECT_EQ(nullptr, streams.find(0, proto::Stream_Kind_DATA));
+    EXPECT_EQ(nullptr, streams.find(1, proto::Stream_Kind_PRESENT));
+    EXPECT_EQ(nullptr, streams.find(2, proto::Stream_Kind_DATA));
+    EXPECT_EQ(nullptr, streams.find(7, proto::Stream_Kind_DATA));
+    EXPECT_EQ(nullptr, streams.find(1000, proto::Stream_Kind_DATA));
+    EXPECT_EQ(nullptr, StreamDirectory().find(0, proto::Stream_Kind_DATA));
+  }
+
+  TEST(TestRowReader, reuseColumnReadersAcrossStripes) {
+    MemoryOutputStream memStream(DEFAULT_MEM_STREAM_SIZE);
+    uint64_t rowCount = 20000;
+    writeMultiStripeFile(memStream, rowCount, 1000,
+                         multiStripeWriterOptions().setDictionaryKeySizeThreshold(1.0));
+
+    auto inStream = std::make_unique<MemoryInputStream>(memStream.getData(), memStream.getLength());
+    ReaderOptions readerOptions;
+    readerOptions.setMemoryPool(*getDefaultPool());
+    auto reader = createReader(std::move(inStream), readerOptions);
+    ASSERT_GT(reader->getNumberOfStripes(), 3);
+    EXPECT_EQ(ColumnEncodingKind_DICTIONARY_V2, reader->getStripe(1)->getColumnEncoding(2));
+
+    for (bool lazyDecoding : {false, true}) {
+      RowReaderOptions rowReaderOptions;
+      rowReaderOptions.setEnableLazyDecoding(lazyDecoding);
+      auto rowReader = reader->createRowReader(rowReaderOptions);
+      auto readBatch = rowReader->createRowBatch(700);
+      auto checkRows = [&](uint64_t firstRow) {
+        auto& readStruct = dynamic_cast<StructVectorBatch&>(*readBatch);
+        auto& readLong = dynamic_cast<LongVectorBatch&>(*readStruct.fields[0]);
+        auto& readNull = dynamic_cast<LongVectorBatch&>(*readStruct.fields[2]);
+        for (uint64_t i = 0; i < readBatch->numElements; ++i) {
+          uint64_t row = firstRow + i;
+          EXPECT_EQ(static_cast<int64_t>(row), readLong.data[i]);
+          ASSERT_EQ(row % 3 != 0, readNull.notNull[i] != 0) << row;
+          if (row % 3 != 0) {
+            EXPECT_EQ(static_cast<int64_t>(row * 7), readNull.data[i]);
+          }
+          char* value;
+          int64_t length;
+          if (lazyDecoding) {
+            auto& encoded = dynamic_cast<EncodedStringVectorBatch&>(*readStruct.fields[1]);
+            ASSERT_TRUE(encoded.isEncoded);
+            encoded.dictionary->getValueByIndex(encoded.index[i], value, length);
+          } else {
+            auto& strings = dynamic_cast<StringVectorBatch&>(*readStruct.fields[1]);
+            value = strings.data[i];
+            length = strings.length[i];
+          }
+          EXPECT_EQ(std::to_string(row % 5000), std::string(value, static_cast<size_t>(length)));
+        }
+      };
+
+      uint64_t rows = 0;
+      while (rowReader->next(*readBatch)) {
+        checkRows(rows);
+        rows += readBatch->numElements;
+      }
+      EXPECT_EQ(rowCount, rows);
+
+      // move back to a row in the middle of an earlier stripe
+      rowReader->seekToRow(12345);
+      ASSERT_TRUE(rowReader->next(*readBatch));
+      checkRows(12345);
+    }
+  }
+
+  TEST(TestRowReader, readBufferMemoryLimit) {
+    MemoryOutputStream memStream(DEFAULT_MEM_STREAM_SIZE);
+    uint64_t rowCount = 20000;
+    auto reader = createMultiStripeMemReader(memStream, nullptr, rowCount, 2000);
+
+    // too little for the buffers of the streams of a stripe
+    RowReaderOptions smallLimit;
+    smallLimit.setReadBufferMemoryLimit(BufferPool::MIN_POOLED_SIZE);
+    auto rowReader = reader->createRowReader(smallLimit);
+    auto batch = rowReader->createRowBatch(1000);
+    EXPECT_THROW(rowReader->next(*batch), MemoryLimitExceeded);
+
+    RowReaderOptions largeLimit;
+    largeLimit.setReadBufferMemoryLimit(1024 * 1024);
+    rowReader = reader->createRowReader(largeLimit);
+    batch = rowReader->createRowBatch(1000);
+    BufferPool* bufferPool = dynamic_cast<RowReaderImpl&>(*rowReader).getBufferPool();
+    uint64_t rows = 0;
+    while (rowReader->next(*batch)) {
+      auto& longBatch =
+          dynamic_cast<LongVectorBatch&>(*dynamic_cast<StructVectorBatch&>(*batch).fields[0]);
+      for (uint64_t i = 0; i < batch->numElements; ++i) {
+        ASSERT_EQ(static_cast<int64_t>(rows + i), longBatch.data[i]);
+      }
+      rows += batch->numElements;
+      EXPECT_GT(bufferPool->getMemoryUsage(), 0);
+      EXPECT_LE(bufferPool->getMemoryUsage(), largeLimit.getReadBufferMemoryLimit());
+    }
+    EXPECT_EQ(rowCount, rows);
+  }
+
+  TEST(TestRowReader, memoryPoolMetrics) {
+    auto pool = createTrackingMemoryPool(*getDefaultPool());
+    MemoryOutputStream memStream(DEFAULT_MEM_STREAM_SIZE);
+    WriterMetrics writerMetrics;
+    uint64_t rowCount = 10000;
+    writeMultiStripeFile(memStream, rowCount, 1000,
+                         multiStripeWriterOptions()
+                             .setDictionaryKeySizeThreshold(1.0)
+                             .setMemoryPool(pool.get())
+                             .setWriterMetrics(&writerMetrics));
+    EXPECT_GT(writerMetrics.MemoryPoolPeakBytes.load(), 0);
+    EXPECT_GT(writerMetrics.MemoryPoolAllocationCount.load(), 0);
+    MemoryPoolStats stats;
+    pool->getStats(stats);
+    EXPECT_EQ(0, stats.allocatedBytes);
+
+    for (bool lazyDecoding : {false, true}) {
+      ReaderMetrics readerMetrics;
+      {
+        auto inStream =
+            std::make_unique<MemoryInputStream>(memStream.getData(), memStream.getLength());
+        ReaderOptions readerOptions;
+        readerOptions.setMemoryPool(*pool).setReaderMetrics(&readerMetrics);
+        auto reader = createReader(std::move(inStream), readerOptions);
+        ASSERT_GT(reader->getNumberOfStripes(), 2);
+        RowReaderOptions rowReaderOptions;
+        rowReaderOptions.setUseStripeArena(true).setEnableLazyDecoding(lazyDecoding);
+        auto rowReader = reader->createRowReader(rowReaderOptions);
+        auto batch = rowReader->createRowBatch(1000);
+        uint64_t rows = 0;
+        while (rowReader->next(*batch)) {
+          auto& structBatch = dynamic_cast<StructVectorBatch&>(*batch);
+          auto& longBatch = dynamic_cast<LongVectorBatch&>(*structBatch.fields[0]);
+          for (uint64_t i = 0; i < batch->numElements; ++i) {
+            ASSERT_EQ(static_cast<int64_t>(rows + i), longBatch.data[i]);
+          }
+          rows += batch->numElements;
+        }
+        EXPECT_EQ(rowCount, rows);
+        EXPECT_GT(readerMetrics.MemoryPoolAllocatedBytes.load(), 0);
+        EXPECT_GE(readerMetrics.MemoryPoolPeakBytes.load(),
+                  readerMetrics.MemoryPoolAllocatedBytes.load());
+        EXPECT_GT(readerMetrics.StripeArenaPeakBytes.load(), 0);
+        // the batch keeps the dictionary of the last stripe after the reader is gone
+        rowReader.reset();
+      }
+      pool->getStats(stats);
+      EXPECT_EQ(0, stats.allocatedBytes);
+    }
+  }
+
+  TEST(TestBufferPool, reuseReleasedBuffers) {
+    BufferPool bufferPool(*getDefaultPool(), 128 * 1024);
+    uint64_t capacity;
+    char* first = bufferPool.acquire(5000, capacity);
+    EXPECT_EQ(8 * 1024, capacity);
+    bufferPool.release(first, capacity);
+    EXPECT_EQ(8 * 1024, bufferPool.getMemoryUsage());
+
+    // a buffer of the same size class is lent again
+    char* second = bufferPool.acquire(6000, capacity);
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(8 * 1024, bufferPool.getMemoryUsage());
+
+    // the kept buffers are freed before the limit is reached
+    char* third = bufferPool.acquire(50000, capacity);
+    bufferPool.release(second, 8 * 1024);
+    EXPECT_EQ(72 * 1024, bufferPool.getMemoryUsage());
+    char* fourth = bufferPool.acquire(60000, capacity);
+    EXPECT_EQ(128 * 1024, bufferPool.getMemoryUsage());
+    EXPECT_THROW(bufferPool.acquire(1, capacity), MemoryLimitExceeded);
+    bufferPool.release(third, 64 * 1024);
+    bufferPool.release(fourth, 64 * 1024);
+  }
+
+  TEST(TestBufferPool, releaseExhaustedStreams) {
+    BufferPool bufferPool(*getDefaultPool(), 1024 * 1024);
+    std::vector<char> data(10000, 'a');
+    MemoryInputStream input(data.data(), data.size());
+    SeekableFileInputStream stream(&input, 0, data.size(), *getDefaultPool(), 4096, &bufferPool);
+    const void* buffer;
+    int length;
+    ASSERT_TRUE(stream.Next(&buffer, &length));
+    EXPECT_EQ(4096, bufferPool.getLentMemory());
+    // skipping to the end gives the buffer back
+    EXPECT_FALSE(stream.Skip(static_cast<int>(data.size())));
+    EXPECT_EQ(0, bufferPool.getLentMemory());
+
+    // so does seeking to the end or reading past it
+    std::list<uint64_t> positions{4096, data.size()};
+    PositionProvider position(positions);
+    stream.seek(position);
+    ASSERT_TRUE(stream.Next(&buffer, &length));
+    EXPECT_GT(bufferPool.getLentMemory(), 0);
+    stream.seek(position);
+    EXPECT_EQ(0, bufferPool.getLentMemory());
+    positions = {4096 * 2};
+    position = PositionProvider(positions);
+    stream.seek(position);
+    ASSERT_TRUE(stream.Next(&buffer, &length));
+    EXPECT_EQ(data.size() - 4096 * 2, length);
+    EXPECT_GT(bufferPool.getLentMemory(), 0);
+    EXPECT_FALSE(stream.Next(&buffer, &length));
+    EXPECT_EQ(0, bufferPool.getLentMemory());
+  }
+
+  TEST(TestBufferPool, keepDrainedChunksForSeeks) {
+    std::string text;
+    for (int i = 0; text.size() < 5000; ++i) {
+      text += std::to_string(i * 7) + ",";
+    }
+    MemoryOutputStream compressed(DEFAULT_MEM_STREAM_SIZE);
+    {
+      auto out = createCompressor(CompressionKind_ZLIB, &compressed, CompressionStrategy_SPEED,
+                                  4 * 1024, 1024, *getDefaultPool(), nullptr);
+      size_t written = 0;
+      while (written < text.size()) {
+        void* target;
+        int size;
+        ASSERT_TRUE(out->Next(&target, &size));
+        size_t copied = std::min(static_cast<size_t>(size), text.size() - written);
+        memcpy(target, text.data() + written, copied);
+        out->BackUp(size - static_cast<int>(copied));
+        written += copied;
+      }
+      out->flush();
+    }
+
+    BufferPool bufferPool(*getDefaultPool(), 1024 * 1024);
+    CountingMemoryInputStream input(compressed.getData(), compressed.getLength());
+    auto stream = createDecompressor(
+        CompressionKind_ZLIB,
+        std::make_unique<SeekableFileInputStream>(&input, 0, compressed.getLength(),
+                                                  *getDefaultPool(), 0, &bufferPool),
+        1024, *getDefaultPool(), nullptr, nullptr, &bufferPool);
+    const void* buffer;
+    int length;
+    size_t offset = 0;
+    while (offset < text.size()) {
+      ASSERT_TRUE(stream->Next(&buffer, &length));
+      offset += static_cast<size_t>(length);
+    }
+    uint64_t readCount = input.getReadCount();
+
+    // seeking back into the drained input decompresses the chunk from its buffer
+    std::list<uint64_t> positions{0, 10};
+    PositionProvider position(positions);
+    stream->seek(position);
+    ASSERT_TRUE(stream->Next(&buffer, &length));
+    ASSERT_EQ(1014, length);
+    EXPECT_EQ(text.substr(10, 1014), std::string(static_cast<const char*>(buffer), 1014));
+    EXPECT_EQ(readCount, input.getReadCount());
+
+    // the buffers are given back once the stream is read to the end
+    offset = 1024;
+    while (stream->Next(&buffer, &length)) {
+      EXPECT_EQ(text.substr(offset, static_cast<size_t>(length)),
+                std::string(static_cast<const char*>(buffer), static_cast<size_t>(length)));
+      offset += static_cast<size_t>(length);
+    }
+    EXPECT_EQ(text.size(), offset);
+    EXPECT_EQ(0, bufferPool.getLentMemory());
+  }
+
+  TEST(TestRowReader, testMappedLocalFile) {
+    MemoryOutputStream memStream(DEFAULT_MEM_STREAM_SIZE);
+    uint64_t rowCount = 20000;
+    writeMultiStripeFile(memStream, rowCount, 2000);
+    const char* fileName = "mapped-file.orc";
+    {
+      auto outStream = writeLocalFile(fileName);
+      outStream->write(memStream.getData(), memStream.getLength());
+      outStream->close();
+    }
+
+    auto inStream = readMappedLocalFile(fileName);
+    ASSERT_EQ(memStream.getLength(), inStream->getLength());
+    const char* mapped = inStream->getMappedRange(0, inStream->getLength());
+    ASSERT_NE(nullptr, mapped);
+    EXPECT_EQ(0, memcmp(memStream.getData(), mapped, memStream.getLength()));
+    EXPECT_EQ(nullptr, inStream->getMappedRange(1, inStream->getLength()));
+
+    auto reader = createReader(std::move(inStream), ReaderOptions());
+    for (bool coalesce : {false, true}) {
+      RowReaderOptions options;
+      options.setCoalesceReads(coalesce);
+      auto rowReader = reader->createRowReader(options);
+      verifyMultiStripeRows(*rowReader, 0, rowCount);
+      rowReader->seekToRow(5000);
+      verifyMultiStripeRows(*rowReader, 5000, rowCount);
+    }
+    reader.reset();
+    std::remove(fileName);
+  }
+
+  TEST(TestReader, testFileTailCache) {
+    MemoryOutputStream memStream(DEFAULT_MEM_STREAM_SIZE);
+    uint64_t rowCount = 20000;
+    writeMultiStripeFile(memStream, rowCount, 2000);
+    FileTailCache* cache = getFileTailCache();
+    cache->clear();
+    cache->setCapacity(1024 * 1024);
+    uint64_t hitCount = cache->getHitCount();
+    uint64_t missCount = cache->getMissCount();
+
+    auto openFile = [&memStream](ReaderMetrics* metrics, const std::string& cacheKey) {
+      ReaderOptions readerOptions;
+      readerOptions.setReaderMetrics(metrics).setCacheKey(cacheKey);
+      return createReader(
+          std::make_unique<MemoryInputStream>(memStream.getData(), memStream.getLength()),
+          readerOptions);
+    };
+
+    ReaderMetrics metrics;
+    auto first = openFile(&metrics, "file@1");
+    EXPECT_EQ(1, metrics.FileTailCacheMiss.load());
+    EXPECT_EQ(1, cache->getEntryCount());
+    uint64_t size = cache->getSize();
+    EXPECT_GT(size, 0);
+    // loading the metadata adds it to the cached tail
+    EXPECT_EQ(first->getNumberOfStripes(), first->getNumberOfStripeStatistics());
+    EXPECT_GT(cache->getSize(), size);
+
+    auto second = openFile(&metrics, "file@1");
+    EXPECT_EQ(1, metrics.FileTailCacheHit.load());
+    EXPECT_EQ(first->getNumberOfStripes(), second->getNumberOfStripes());
+    EXPECT_EQ(first->getSerializedFileTail(), second->getSerializedFileTail());
+    EXPECT_EQ(first->getNumberOfStripes(), second->getNumberOfStripeStatistics());
+    auto rowReader = second->createRowReader(RowReaderOptions());
+    verifyMultiStripeRows(*rowReader, 0, rowCount);
+
+    // another version of the file is a different entry
+    auto third = openFile(&metrics, "file@2");
+    EXPECT_EQ(2, metrics.FileTailCacheMiss.load());
+    EXPECT_EQ(2, cache->getEntryCount());
+    EXPECT_EQ(hitCount + 1, cache->getHitCount());
+    EXPECT_EQ(missCount + 2, cache->getMissCount());
+
+    // a reader without a cache key does not use the cache
+    openFile(&metrics, "");
+    EXPECT_EQ(1, metrics.FileTailCacheHit.load());
+    EXPECT_EQ(2, metrics.FileTailCacheMiss.load());
+    EXPECT_EQ(2, cache->getEntryCount());
+
+    // the least recently used entry is evicted first
+    cache->setCapacity(cache->getSize() - 1);
+    EXPECT_EQ(1, cache->getEntryCount());
+    openFile(&metrics, "file@2");
+    EXPECT_EQ(2, metrics.FileTailCacheHit.load());
+
+    cache->setCapacity(0);
+    EXPECT_EQ(0, cache->getEntryCount());
+    EXPECT_EQ(0, cache->getSize());
+    // a disabled cache is not consulted
+    openFile(&metrics, "file@2");
+    EXPECT_EQ(2, metrics.FileTailCacheHit.load());
+    EXPECT_EQ(2, metrics.FileTailCacheMiss.load());
+  }
+
+  TEST(TestRowReader, testDecompressedChunkCache) {
+    MemoryOutputStream memStream(DEFAULT_MEM_STREAM_SIZE);
+    uint64_t rowCount = 20000;
+    writeMultiStripeFile(memStream, rowCount, 2000);
+    DecompressedChunkCache* cache = getDecompressedChunkCache();
+    cache->clear();
+    cache->setCapacity(64 * 1024 * 1024);
+
+    // a reader without a cache key does not use the cache
+    ReaderMetrics metrics;
+    ReaderOptions readerOptions;
+    readerOptions.setReaderMetrics(&metrics);
+    auto reader = createReader(
+        std::make_unique<MemoryInputStream>(memStream.getData(), memStream.getLength()),
+        readerOptions);
+    auto rowReader = reader->createRowReader(RowReaderOptions());
+    verifyMultiStripeRows(*rowReader, 0, rowCount);
+    EXPECT_EQ(0, metrics.DecompressedChunkCacheMiss.load());
+    EXPECT_EQ(0, cache->getEntryCount());
+
+    readerOptions.setCacheKey("file@0");
+    reader = createReader(
+        std::make_unique<MemoryInputStream>(memStream.getData(), memStream.getLength()),
+        readerOptions);
+    rowReader = reader->createRowReader(RowReaderOptions());
+    verifyMultiStripeRows(*rowReader, 0, rowCount);
+    uint64_t missCount = metrics.DecompressedChunkCacheMiss.load();
+    EXPECT_GT(missCount, 0);
+    EXPECT_EQ(0, metrics.DecompressedChunkCacheHit.load());
+    EXPECT_EQ(missCount, cache->getEntryCount());
+    EXPECT_GT(cache->getSize(), 0);
+
+    // a second scan decompresses nothing
+    rowReader = reader->createRowReader(RowReaderOptions());
+    verifyMultiStripeRows(*rowReader, 0, rowCount);
+    EXPECT_EQ(missCount, metrics.DecompressedChunkCacheHit.load());
+    EXPECT_EQ(missCount, metrics.DecompressedChunkCacheMiss.load());
+    // seeking reads the row index of the stripe, which was not read before
+    rowReader->seekToRow(12345);
+    verifyMultiStripeRows(*rowReader, 12345, rowCount);
+    uint64_t seekMissCount = metrics.DecompressedChunkCacheMiss.load() - missCount;
+    EXPECT_EQ(missCount + seekMissCount, cache->getEntryCount());
+
+    // another version of the file does not share the chunks
+    readerOptions.setCacheKey("file@1");
+    reader = createReader(
+        std::make_unique<MemoryInputStream>(memStream.getData(), memStream.getLength()),
+        readerOptions);
+    rowReader = reader->createRowReader(RowReaderOptions());
+    verifyMultiStripeRows(*rowReader, 0, rowCount);
+    EXPECT_EQ(2 * missCount + seekMissCount, metrics.DecompressedChunkCacheMiss.load());
+
+    // the chunks are allocated from the pool of the cache
+    auto pool = createTrackingMemoryPool(*getDefaultPool());
+    cache->clear();
+    cache->setMemoryPool(*pool);
+    rowReader = reader->createRowReader(RowReaderOptions());
+    verifyMultiStripeRows(*rowReader, 0, rowCount);
+    MemoryPoolStats stats;
+    pool->getStats(stats);
+    EXPECT_GT(stats.allocatedBytes, 0);
+    EXPECT_LE(stats.allocatedBytes, cache->getSize());
+    cache->clear();
+    pool->getStats(stats);
+    EXPECT_EQ(0, stats.allocatedBytes);
+    cache->setMemoryPool(*getDefaultPool());
+
+    cache->setCapacity(0);
+    EXPECT_EQ(0, cache->getEntryCount());
+    EXPECT_EQ(0, cache->getSize());
+  }
+
+  TEST(TestRowReader, testParallelRowReader) {
+    MemoryOutputStream memStream(DEFAULT_MEM_STREAM_SIZE);
+    ReaderMetrics metrics;
+    uint64_t rowCount = 20000;
+    auto reader = createMultiStripeMemReader(memStream, &metrics, rowCount, 2000);
+    EXPECT_GT(reader->getNumberOfStripes(), 3);
+
+    auto parallelReader = reader->createParallelRowReader(RowReaderOptions(), 1000, 3);
+    EXPECT_EQ("struct<col1:bigint,col2:string,col3:bigint>",
+              parallelReader->getSelectedType().toString());
+    uint64_t expected = 0;
+    while (auto batch = parallelReader->next()) {
+      EXPECT_EQ(expected, parallelReader->getRowNumber());
+      auto& structBatch = dynamic_cast<StructVectorBatch&>(*batch);
+      auto& longBatch = dynamic_cast<LongVectorBatch&>(*structBatch.fields[0]);
+      auto& stringBatch = dynamic_cast<StringVectorBatch&>(*structBatch.fields[1]);
+      for (uint64_t i = 0; i < batch->numElements; ++i, ++expected) {
+        EXPECT_EQ(static_cast<int64_t>(expected), longBatch.data[i]);
+        EXPECT_EQ(std::to_string(expected % 5000),
+                  std::string(stringBatch.data[i], static_cast<size_t>(stringBatch.length[i])));
+      }
+    }
+    EXPECT_EQ(rowCount, expected);
+    EXPECT_EQ(nullptr, parallelReader->next());
+
+    // the stripes after the first one, with a projection
+    uint64_t secondStripe = reader->getStripe(1)->getOffset();
+    RowReaderOptions options;
+    options.range(secondStripe, memStream.getLength()).include(std::list<uint64_t>{0});
+    parallelReader = reader->createParallelRowReader(options, 1000, 2);
+    EXPECT_EQ("struct<col1:bigint>", parallelReader->getSelectedType().toString());
+    auto batch = parallelReader->next();
+    ASSERT_NE(nullptr, batch);
+    expected = reader->getStripe(0)->getNumberOfRows();
+    EXPECT_EQ(expected, parallelReader->getRowNumber());
+    auto& longBatch =
+        dynamic_cast<LongVectorBatch&>(*dynamic_cast<StructVectorBatch&>(*batch).fields[0]);
+    EXPECT_EQ(static_cast<int64_t>(expected), longBatch.data[0]);
+    // the reader can be destroyed while stripes are still being decoded
+    parallelReader.reset();
+
+    // the stripes share the column decode threads and the read buffers
+    options = RowReaderOptions();
+    options.setColumnDecodeThreadCount(4).setReadBufferMemoryLimit(1024 * 1024);
+    parallelReader = reader->createParallelRowReader(options, 1000, 3);
+    expected = 0;
+    while (auto sharedBatch = parallelReader->next()) {
+      auto& ids =
+          dynamic_cast<LongVectorBatch&>(*dynamic_cast<StructVectorBatch&>(*sharedBatch).fields[0]);
+      for (uint64_t i = 0; i < sharedBatch->numElements; ++i, ++expected) {
+        EXPECT_EQ(static_cast<int64_t>(expected), ids.data[i]);
+      }
+    }
+    EXPECT_EQ(rowCount, expected);
+
+    // a limit within a batch cuts the fields too, with and without filtered stripes
+    uint64_t limit = reader->getStripe(0)->getNumberOfRows() + 500;
+    options = RowReaderOptions();
+    options.limit(limit);
+    for (bool filter : {false, true}) {
+      if (filter) {
+        options.searchArgument(SearchArgumentFactory::newBuilder()
+                                   ->startNot()
+                                   .lessThan("col1", PredicateDataType::LONG,
+                                             Literal(static_cast<int64_t>(0)))
+                                   .end()
+                                   .build());
+      }
+      parallelReader = reader->createParallelRowReader(options, 1000, 3);
+      uint64_t rows = 0;
+      while (auto limitedBatch = parallelReader->next()) {
+        auto& fields = dynamic_cast<StructVectorBatch&>(*limitedBatch).fields;
+        for (auto field : fields) {
+          EXPECT_EQ(limitedBatch->numElements, field->numElements);
+        }
+        rows += limitedBatch->numElements;
+      }
+      EXPECT_EQ(limit, rows);
+    }
+  }
+
+  TEST(TestThreadPool, runTasks) {
+    ThreadPool pool(3);
+    EXPECT_EQ(3, pool.getThreadCount());
+    std::vector<std::atomic<int>> counts(100);
+    std::vector<std::function<void()>> tasks;
+    for (size_t i = 0; i < counts.size(); ++i) {
+      tasks.push_back([&pool, &counts, i]() {
+        // tasks may run groups of their own
+        std::vector<std::function<void()>> nested{[&counts, i]() { ++counts[i]; }};
+        pool.run(nested);
+        ++counts[i];
+      });
+    }
+    pool.run(tasks);
+    for (const auto& count : counts) {
+      EXPECT_EQ(2, count.load());
+    }
+
+    tasks.push_back([]() { throw ParseError("task failed"); });
+    EXPECT_THROW(pool.run(tasks), ParseError);
+  }
+
+  TEST(TestRowReader, testColumnDecodeThreads) {
+    MemoryOutputStream memStream(DEFAULT_MEM_STREAM_SIZE);
+    MemoryPool* pool = getDefaultPool();
+    auto type = std::unique_ptr<Type>(Type::buildTypeFromString(
+        "struct<c0:bigint,c1:string,c2:bigint,c3:string,c4:double,c5:bigint,c6:string,"
+        "c7:struct<c8:bigint,c9:string>,c10:bigint,c11:string>"));
+    uint64_t rowCount = 5000;
+    WriterOptions writerOptions;
+    writerOptions.setStripeSize(1024)
+        .setCompressionBlockSize(1024)
+        .setCompression(CompressionKind_ZLIB)
+        .setMemoryPool(pool)
+        .setRowIndexStride(1000);
+    auto writer = createWriter(*type, &memStream, writerOptions);
+    auto batch = writer->createRowBatch(rowCount);
+    auto& structBatch = dynamic_cast<StructVectorBatch&>(*batch);
+    std::vector<std::string> values(rowCount);
+    for (uint64_t i = 0; i < rowCount; ++i) {
+      values[i] = std::to_string(i);
+    }
+    std::function<void(ColumnVectorBatch&, uint64_t)> fill = [&](ColumnVectorBatch& column,
+                                                                 uint64_t id) {
+      column.numElements = rowCount;
+      column.hasNulls = id % 3 == 0;
+      for (uint64_t i = 0; i < rowCount; ++i) {
+        column.notNull[i] = !column.hasNulls || (i + id) % 7 != 0;
+      }
+      if (auto longs = dynamic_cast<LongVectorBatch*>(&column)) {
+        for (uint64_t i = 0; i < rowCount; ++i) {
+          longs->data[i] = static_cast<int64_t>(i * id);
+        }
+      } else if (auto doubles = dynamic_cast<DoubleVectorBatch*>(&column)) {
+        for (uint64_t i = 0; i < rowCount; ++i) {
+          doubles->data[i] = static_cast<double>(i) / 2;
+        }
+      } else if (auto strings = dynamic_cast<StringVectorBatch*>(&column)) {
+        for (uint64_t i = 0; i < rowCount; ++i) {
+          strings->data[i] = const_cast<char*>(values[i].c_str());
+          strings->length[i] = static_cast<int64_t>(values[i].size());
+        }
+      } else {
+        auto& children = dynamic_cast<StructVectorBatch&>(column);
+        column.hasNulls = false;
+        for (uint64_t i = 0; i < children.fields.size(); ++i) {
+          fill(*children.fields[i], id + i + 1);
+        }
+      }
+    };
+    for (uint64_t i = 0, id = 0; i < structBatch.fields.size(); ++i, ++id) {
+      fill(*structBatch.fields[i], id);
+      id += type->getSubtype(i)->getSubtypeCount();
+    }
+    structBatch.numElements = rowCount;
+    for (int i = 0; i < 4; ++i) {
+      writer->add(*batch);
+    }
+    writer->close();
+
+    auto inStream = std::make_unique<MemoryInputStream>(memStream.getData(), memStream.getLength());
+    ReaderOptions readerOptions;
+    readerOptions.setMemoryPool(*pool);
+    auto reader = createReader(std::move(inStream), readerOptions);
+    EXPECT_GT(reader->getNumberOfStripes(), 1);
+
+    RowReaderOptions sequentialOptions;
+    RowReaderOptions parallelOptions;
+    parallelOptions.setColumnDecodeThreadCount(4);
+    EXPECT_EQ(4, parallelOptions.getColumnDecodeThreadCount());
+    auto sequentialReader = reader->createRowReader(sequentialOptions);
+    auto parallelReader = reader->createRowReader(parallelOptions);
+    auto expected = sequentialReader->createRowBatch(1000);
+    auto actual = parallelReader->createRowBatch(1000);
+    // compare the batches through their printed rows
+    auto printRows = [](const Type& selectedType, const ColumnVectorBatch& rowBatch) {
+      std::string rows;
+      auto printer = createColumnPrinter(rows, &selectedType);
+      printer->reset(rowBatch);
+      for (uint64_t i = 0; i < rowBatch.numElements; ++i) {
+        printer->printRow(i);
+      }
+      return rows;
+    };
+    uint64_t rows = 0;
+    while (sequentialReader->next(*expected)) {
+      ASSERT_TRUE(parallelReader->next(*actual));
+      EXPECT_EQ(printRows(sequentialReader->getSelectedType(), *expected),
+                printRows(parallelReader->getSelectedType(), *actual));
+      rows += expected->numElements;
+    }
+    EXPECT_FALSE(parallelReader->next(*actual));
+    EXPECT_EQ(4 * rowCount, rows);
+
+    // seeking works the same way
+    sequentialReader->seekToRow(12500);
+    parallelReader->seekToRow(12500);
+    ASSERT_TRUE(sequentialReader->next(*expected));
+    ASSERT_TRUE(parallelReader->next(*actual));
+    EXPECT_EQ(printRows(sequentialReader->getSelectedType(), *expected),
+              printRows(parallelReader->getSelectedType(), *actual));
+  }
+
+  TEST(TestRowReader, testRowFilter) {
+    MemoryOutputStream memStream(DEFAULT_MEM_STREAM_SIZE);
+    MemoryPool* pool = getDefaultPool();
+    auto type = std::unique_ptr<Type>(
+        Type::buildTypeFromString("struct<id:bigint,name:string,score:double,tags:array<int>>"));
+    WriterOptions writerOptions;
+    writerOptions.setStripeSize(1024)
+        .setCompressionBlockSize(1024)
+        .setCompression(CompressionKind_ZLIB)
+        .setMemoryPool(pool)
+        .setRowIndexStride(1000);
+    auto writer = createWriter(*type, &memStream, writerOptions);
+    uint64_t batchSize = 1000;
+    uint64_t rowCount = 10000;
+    // room for the list elements
+    auto batch = writer->createRowBatch(3 * batchSize);
+    auto& structBatch = dynamic_cast<StructVectorBatch&>(*batch);
+    auto& idBatch = dynamic_cast<LongVectorBatch&>(*structBatch.fields[0]);
+    auto& nameBatch = dynamic_cast<StringVectorBatch&>(*structBatch.fields[1]);
+    auto& scoreBatch = dynamic_cast<DoubleVectorBatch&>(*structBatch.fields[2]);
+    auto& tagsBatch = dynamic_cast<ListVectorBatch&>(*structBatch.fields[3]);
+    auto& tagBatch = dynamic_cast<LongVectorBatch&>(*tagsBatch.elements);
+    std::vector<std::string> names(batchSize);
+    for (uint64_t row = 0; row < rowCount; row += batchSize) {
+      nameBatch.hasNulls = true;
+      for (uint64_t i = 0; i < batchSize; ++i) {
+        uint64_t id = row + i;
+        idBatch.data[i] = static_cast<int64_t>(id);
+        names[i] = "name-" + std::to_string(id);
+        nameBatch.notNull[i] = id % 3 != 0;
+        nameBatch.data[i] = const_cast<char*>(names[i].c_str());
+        nameBatch.length[i] = static_cast<int64_t>(names[i].size());
+        scoreBatch.data[i] = static_cast<double>(id) / 4;
+        tagsBatch.offsets[i] = static_cast<int64_t>(3 * i - i % 3);
+        tagsBatch.offsets[i + 1] = static_cast<int64_t>(3 * (i + 1) - (i + 1) % 3);
+        for (int64_t j = tagsBatch.offsets[i]; j < tagsBatch.offsets[i + 1]; ++j) {
+          tagBatch.data[j] = static_cast<int64_t>(id) + j - tagsBatch.offsets[i];
+        }
+      }
+      structBatch.numElements = batchSize;
+      idBatch.numElements = batchSize;
+      nameBatch.numElements = batchSize;
+      scoreBatch.numElements = batchSize;
+      tagsBatch.numElements = batchSize;
+      tagBatch.numElements = static_cast<uint64_t>(tagsBatch.offsets[batchSize]);
+      writer->add(*batch);
+    }
+    writer->close();
+
+    auto inStream = std::make_unique<MemoryInputStream>(memStream.getData(), memStream.getLength());
+    ReaderOptions readerOptions;
+    readerOptions.setMemoryPool(*pool);
+    auto reader = createReader(std::move(inStream), readerOptions);
+    EXPECT_GT(reader->getNumberOfStripes(), 1);
+
+    // keep every 97th row, except for a range that drops whole batches
+    uint64_t filterCalls = 0;
+    RowReaderOptions options;
+    options.setRowFilter({"id"}, [&filterCalls](const StructVectorBatch& rows, char* selected) {
+      ++filterCalls;
+      EXPECT_EQ(rows.numElements, rows.fields[0]->numElements);
+      auto& ids = dynamic_cast<const LongVectorBatch&>(*rows.fields[0]);
+      for (uint64_t i = 0; i < rows.numElements; ++i) {
+        selected[i] = ids.data[i] % 97 == 0 && (ids.data[i] < 3000 || ids.data[i] >= 6000);
+      }
+    });
+    EXPECT_EQ(1, options.getRowFilterColumns().size());
+    auto rowReader = reader->createRowReader(options);
+    auto result = rowReader->createRowBatch(500);
+    auto& resultStruct = dynamic_cast<StructVectorBatch&>(*result);
+    uint64_t expected = 0;
+    while (rowReader->next(*result)) {
+      auto& ids = dynamic_cast<LongVectorBatch&>(*resultStruct.fields[0]);
+      auto& resultNames = dynamic_cast<StringVectorBatch&>(*resultStruct.fields[1]);
+      auto& scores = dynamic_cast<DoubleVectorBatch&>(*resultStruct.fields[2]);
+      auto& tags = dynamic_cast<ListVectorBatch&>(*resultStruct.fields[3]);
+      auto& tagValues = dynamic_cast<LongVectorBatch&>(*tags.elements);
+      EXPECT_GT(result->numElements, 0);
+      for (uint64_t i = 0; i < result->numElements; ++i) {
+        if (expected >= 3000 && expected < 6000) {
+          expected = 6014;
+        }
+        EXPECT_EQ(static_cast<int64_t>(expected), ids.data[i]);
+        EXPECT_EQ(expected % 3 != 0, resultNames.notNull[i] != 0);
+        if (expected % 3 != 0) {
+          EXPECT_EQ("name-" + std::to_string(expected),
+                    std::string(resultNames.data[i], static_cast<size_t>(resultNames.length[i])));
+        }
+        EXPECT_EQ(static_cast<double>(expected) / 4, scores.data[i]);
+        uint64_t row = expected % batchSize;
+        ASSERT_EQ(static_cast<int64_t>(3 - (row + 1) % 3 + row % 3),
+                  tags.offsets[i + 1] - tags.offsets[i]);
+        for (int64_t j = tags.offsets[i]; j < tags.offsets[i + 1]; ++j) {
+          EXPECT_EQ(static_cast<int64_t>(expected) + j - tags.offsets[i], tagValues.data[j]);
+        }
+        expected += 97;
+      }
+    }
+    EXPECT_EQ(10088, expected);
+    EXPECT_GE(filterCalls, rowCount / 500);
+
+    options.setRowFilter({"missing"}, [](const StructVectorBatch&, char*) {});
+    EXPECT_THROW(reader->createRowReader(options), ParseError);
+    options.setRowFilter({"id"}, [](const StructVectorBatch&, char*) {});
+    options.setEnableLazyDecoding(true);
+    EXPECT_THROW(reader->createRowReader(options), ParseError);
+  }
+
+  TEST(TestRowReader, testRowFilterColumnTypes) {
+    MemoryPool* pool = getDefaultPool();
+    auto type = std::unique_ptr<Type>(Type::buildTypeFromString(
+        "struct<id:bigint,small:smallint,num:int,dbl:double,"
+        "flt:float,str:string,nested:struct<a:bigint,b:string>,dec:decimal(10,2),"
+        "ts:timestamp>"));
+    uint64_t rowCount = 3000;
+    std::vector<std::string> strings(rowCount);
+    for (uint64_t i = 0; i < rowCount; ++i) {
+      strings[i] = "value-" + std::to_string(i % 50);
+    }
+    // the values of each field are derived from the row and the field id
+    std::function<void(ColumnVectorBatch&, uint64_t)> fill = [&](ColumnVectorBatch& column,
+                                                                 uint64_t id) {
+      column.numElements = rowCount;
+      column.hasNulls = id % 2 == 1;
+      for (uint64_t i = 0; i < rowCount; ++i) {
+        column.notNull[i] = !column.hasNulls || (i * id) % 5 != 0;
+      }
+      if (auto longs = dynamic_cast<LongVectorBatch*>(&column)) {
+        for (uint64_t i = 0; i < rowCount; ++i) {
+          longs->data[i] = id == 0 ? static_cast<int64_t>(i) : static_cast<int64_t>((i * id) % 100);
+        }
+      } else if (auto doubles = dynamic_cast<DoubleVectorBatch*>(&column)) {
+        for (uint64_t i = 0; i < rowCount; ++i) {
+          doubles->data[i] = static_cast<double>(i * id) / 8;
+        }
+      } else if (auto strs = dynamic_cast<StringVectorBatch*>(&column)) {
+        for (uint64_t i = 0; i < rowCount; ++i) {
+          strs->data[i] = const_cast<char*>(strings[i].c_str());
+          strs->length[i] = static_cast<int64_t>(strings[i].size());
+        }
+      } else if (auto decimals = dynamic_cast<Decimal64VectorBatch*>(&column)) {
+        for (uint64_t i = 0; i < rowCount; ++i) {
+          decimals->values[i] = static_cast<int64_t>(i * id);
+        }
+      } else if (auto timestamps = dynamic_cast<TimestampVectorBatch*>(&column)) {
+        for (uint64_t i = 0; i < rowCount; ++i) {
+          timestamps->data[i] = static_cast<int64_t>(i * id);
+          timestamps->nanoseconds[i] = static_cast<int64_t>(i * 1000);
+        }
+      } else {
+        auto& children = dynamic_cast<StructVectorBatch&>(column);
+        for (uint64_t i = 0; i < children.fields.size(); ++i) {
+          fill(*children.fields[i], id + i + 1);
+        }
+      }
+    };
+    auto selectRow = [](int64_t id) { return (id / 7) % 3 == 0 || id % 11 == 0; };
+
+    // direct and dictionary encoded strings
+    for (double dictionaryThreshold : {0.0, 1.0}) {
+      MemoryOutputStream memStream(DEFAULT_MEM_STREAM_SIZE);
+      WriterOptions writerOptions;
+      writerOptions.setMemoryPool(pool)
+          .setRowIndexStride(1000)
+          .setDictionaryKeySizeThreshold(dictionaryThreshold);
+      auto writer = createWriter(*type, &memStream, writerOptions);
+      auto batch = writer->createRowBatch(rowCount);
+      auto& structBatch = dynamic_cast<StructVectorBatch&>(*batch);
+      for (uint64_t i = 0, id = 0; i < structBatch.fields.size(); ++i, ++id) {
+        fill(*structBatch.fields[i], id);
+        id += type->getSubtype(i)->getSubtypeCount();
+      }
+      structBatch.numElements = rowCount;
+      writer->add(*batch);
+      writer->close();
+
+      auto inStream =
+          std::make_unique<MemoryInputStream>(memStream.getData(), memStream.getLength());
+      auto reader = createReader(std::move(inStream), ReaderOptions());
+      RowReaderOptions allOptions;
+      RowReaderOptions filterOptions;
+      filterOptions.setRowFilter({"id"}, [&](const StructVectorBatch& rows, char* selected) {
+        auto& ids = dynamic_cast<const LongVectorBatch&>(*rows.fields[0]);
+        for (uint64_t i = 0; i < rows.numElements; ++i) {
+          selected[i] = selectRow(ids.data[i]);
+        }
+      });
+      auto allReader = reader->createRowReader(allOptions);
+      std::string expected;
+      auto allBatch = allReader->createRowBatch(700);
+      auto allPrinter = createColumnPrinter(expected, &allReader->getSelectedType());
+      while (allReader->next(*allBatch)) {
+        allPrinter->reset(*allBatch);
+        auto& ids = dynamic_cast<LongVectorBatch&>(
+            *dynamic_cast<StructVectorBatch&>(*allBatch).fields[0]);
+        for (uint64_t i = 0; i < allBatch->numElements; ++i) {
+          if (selectRow(ids.data[i])) {
+            allPrinter->printRow(i);
+          }
+        }
+      }
+      EXPECT_FALSE(expected.empty());
+
+      // decode the columns in order and concurrently
+      for (uint32_t threadCount : {0, 4}) {
+        filterOptions.setColumnDecodeThreadCount(threadCount);
+        auto filterReader = reader->createRowReader(filterOptions);
+        std::string actual;
+        auto filterBatch = filterReader->createRowBatch(700);
+        auto filterPrinter = createColumnPrinter(actual, &filterReader->getSelectedType());
+        while (filterReader->next(*filterBatch)) {
+          filterPrinter->reset(*filterBatch);
+          for (uint64_t i = 0; i < filterBatch->numElements; ++i) {
+            filterPrinter->printRow(i);
+          }
+        }
+        EXPECT_EQ(expected, actual) << threadCount << " threads";
+      }
+    }
+  }
 }  // namespace orc
@@ -17,12 +17,22 @@
  */
 
 #include "Adaptor.hh"
+#include "BpackingAvx2.hh"
 #include "Compression.hh"
+#include "Dispatch.hh"
 #include "OrcTest.hh"
 #include "RLE.hh"
+#include "RLEv2.hh"
+#include "RleV2Avx2.hh"
+#if defined(ORC_HAVE_RUNTIME_AVX512)
+#include "RleV2Avx512.hh"
+#endif
+#include "RleV2Default.hh"
 #include "wrap/gtest-wrapper.h"
 
 #include <iostream>
+#include <limits>
+#include <random>
 #include <vector>
 
 namespace orc {
@@ -1136,6 +1146,97 @@ namespace orc {
     }
   }
 
+#if defined(ORC_HAVE_RUNTIME_AVX2)
+  TEST(RLEv2, avx2BitUnpack) {
+    if (!CpuInfo::getInstance()->isDetected(CpuInfo::AVX2 | CpuInfo::BMI2)) {
+      GTEST_SKIP() << "AVX2 is not available";
+    }
+    std::mt19937_64 random(11);
+    const uint64_t numValues = 1001;
+    for (uint64_t fbs : {1,  2,  3,  4,  5,  6,  7,  8,  9,  10, 11, 12, 13, 14, 15, 16, 17,
+                         18, 19, 20, 21, 22, 23, 24, 26, 28, 30, 32, 40, 48, 56, 64}) {
+      // pack the values with the most significant bit first
+      std::vector<int64_t> expected(numValues);
+      std::vector<unsigned char> bytes((numValues * fbs + 7) / 8);
+      uint64_t bit = 0;
+      for (uint64_t i = 0; i < numValues; ++i) {
+        uint64_t value = fbs == 64 ? random() : random() & ((1ULL << fbs) - 1);
+        expected[i] = static_cast<int64_t>(value);
+        for (uint64_t j = fbs; j > 0; --j, ++bit) {
+          if ((value >> (j - 1)) & 1) {
+            bytes[bit / 8] = static_cast<unsigned char>(bytes[bit / 8] | (0x80 >> (bit % 8)));
+          }
+        }
+      }
+      // small blocks make the values cross the buffer boundaries
+      RleDecoderV2 decoder(
+          std::make_unique<SeekableArrayInputStream>(bytes.data(), bytes.size(), 37), false,
+          *getDefaultPool(), getDefaultReaderMetrics());
+      std::vector<int64_t> data(numValues);
+      uint64_t position = 0;
+      for (uint64_t batch : {3, 100, 898}) {
+        BitUnpackAVX2::readLongs(&decoder, data.data(), position, batch, fbs);
+        position += batch;
+      }
+      EXPECT_EQ(expected, data) << "bit width " << fbs;
+    }
+  }
+#endif
+
+  TEST(RLEv2, runKernelsMatchDefault) {
+    struct Kernels {
+      decltype(&RleV2Default::prefixSum) prefixSum;
+      decltype(&RleV2Default::unZigZag) unZigZag;
+      decltype(&RleV2Default::applyPatches) applyPatches;
+    };
+    std::vector<Kernels> kernels;
+#if defined(ORC_HAVE_RUNTIME_AVX2)
+    if (CpuInfo::getInstance()->isDetected(CpuInfo::AVX2 | CpuInfo::BMI2)) {
+      kernels.push_back({RleV2AVX2::prefixSum, RleV2AVX2::unZigZag, RleV2Default::applyPatches});
+    }
+#endif
+#if defined(ORC_HAVE_RUNTIME_AVX512)
+    if (CpuInfo::getInstance()->isDetected(CpuInfo::AVX512)) {
+      kernels.push_back(
+          {RleV2AVX512::prefixSum, RleV2AVX512::unZigZag, RleV2AVX512::applyPatches});
+    }
+#endif
+    std::mt19937_64 random(3);
+    for (uint64_t numValues : {0, 1, 3, 4, 7, 8, 9, 31, 510}) {
+      std::vector<int64_t> values(numValues);
+      for (auto& value : values) {
+        value = static_cast<int64_t>(random() >> (random() % 64));
+      }
+      std::vector<int64_t> positions;
+      std::vector<int64_t> patches;
+      for (uint64_t i = 0; i < numValues; i += 1 + random() % 40) {
+        positions.push_back(static_cast<int64_t>(i));
+        patches.push_back(static_cast<int64_t>(random() % 1024));
+      }
+      for (const Kernels& kernel : kernels) {
+        for (bool decreasing : {false, true}) {
+          std::vector<int64_t> expected = values;
+          std::vector<int64_t> actual = values;
+          RleV2Default::prefixSum(expected.data(), numValues, -17, decreasing);
+          kernel.prefixSum(actual.data(), numValues, -17, decreasing);
+          EXPECT_EQ(expected, actual);
+        }
+        std::vector<int64_t> expected = values;
+        std::vector<int64_t> actual = values;
+        RleV2Default::unZigZag(expected.data(), numValues);
+        kernel.unZigZag(actual.data(), numValues);
+        EXPECT_EQ(expected, actual);
+
+        expected = values;
+        actual = values;
+        RleV2Default::applyPatches(expected.data(), positions.data(), patches.data(),
+                                   positions.size(), 20);
+        kernel.applyPatches(actual.data(), positions.data(), patches.data(), positions.size(), 20);
+        EXPECT_EQ(expected, actual);
+      }
+    }
+  }
+
   TEST(RLEv1, seekTest) {
     // Create the RLE stream from Java's
     // TestRunLengthIntegerEncoding.testUncompressedSeek
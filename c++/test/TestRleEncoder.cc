@@ -17,9 +17,19 @@
  */
 
 #include <cstdlib>
+#include <limits>
+#include <random>
+#include <vector>
 
+#include "Dispatch.hh"
 #include "MemoryOutputStream.hh"
+#include "RLEV2Util.hh"
 #include "RLEv1.hh"
+#include "RleV2Avx2.hh"
+#if defined(ORC_HAVE_RUNTIME_AVX512)
+#include "RleV2Avx512.hh"
+#endif
+#include "RleV2Default.hh"
 
 #include "wrap/gtest-wrapper.h"
 #include "wrap/orc-proto-wrapper.hh"
@@ -48,6 +58,8 @@ namespace orc {
 
     void runTest(RleVersion version, uint64_t numValues, int64_t start, int64_t delta, bool random,
                  bool isSigned, uint64_t numNulls = 0);
+
+    void runSkipTest(RleVersion version, bool isSigned);
   };
 
   void RleTest::SetUp() {
@@ -136,6 +148,61 @@ namespace orc {
     delete[] notNull;
   }
 
+  void RleTest::runSkipTest(RleVersion version, bool isSigned) {
+    // runs for each encoding: repeats, random values, sequences and small
+    // values with a few large ones, which RLEv2 writes as patched runs
+    std::mt19937_64 random(17);
+    std::vector<int64_t> data;
+    while (data.size() < 20000) {
+      uint64_t length = 1 + random() % 600;
+      int64_t start = static_cast<int64_t>(random() % 100000);
+      switch (random() % 4) {
+        case 0:
+          data.insert(data.end(), length, start);
+          break;
+        case 1:
+          for (uint64_t i = 0; i < length; ++i) {
+            data.push_back(static_cast<int64_t>(random() >> (1 + random() % 63)));
+          }
+          break;
+        case 2:
+          for (uint64_t i = 0; i < length; ++i) {
+            data.push_back(start - 7 * static_cast<int64_t>(i));
+          }
+          break;
+        default:
+          for (uint64_t i = 0; i < length; ++i) {
+            data.push_back(i % 50 == 7 ? static_cast<int64_t>(1) << 40
+                                       : static_cast<int64_t>(random() % 16));
+          }
+          break;
+      }
+    }
+
+    MemoryOutputStream memStream(DEFAULT_MEM_STREAM_SIZE);
+    std::unique_ptr<RleEncoder> encoder = getEncoder(version, memStream, isSigned);
+    encoder->add(data.data(), data.size(), nullptr);
+    encoder->flush();
+
+    std::unique_ptr<RleDecoder> decoder = createRleDecoder(
+        std::make_unique<SeekableArrayInputStream>(memStream.getData(), memStream.getLength()),
+        isSigned, version, *getDefaultPool(), getDefaultReaderMetrics());
+    std::vector<int64_t> result(50);
+    uint64_t position = 0;
+    while (data.size() - position >= 2050) {
+      // skip within a run or over several runs, then read a few values
+      uint64_t skipSize = random() % 2 == 0 ? random() % 10 : random() % 2000;
+      decoder->skip(skipSize);
+      position += skipSize;
+      uint64_t batchSize = random() % result.size();
+      decoder->next(result.data(), batchSize, nullptr);
+      for (uint64_t i = 0; i < batchSize; ++i) {
+        ASSERT_EQ(data[position], result[i]) << "Output wrong at value " << position;
+        position += 1;
+      }
+    }
+  }
+
   TEST_P(RleTest, RleV1_delta_increasing_sequance_unsigned) {
     runTest(RleVersion_1, 1024, 0, 1, false, false);
   }
@@ -274,5 +341,101 @@ namespace orc {
     runExampleTest(data, 9, expectedEncoded, 13);
   }
 
+  TEST_P(RleTest, RleV1_skip) {
+    runSkipTest(RleVersion_1, false);
+    runSkipTest(RleVersion_1, true);
+  }
+
+  TEST_P(RleTest, RleV2_skip) {
+    runSkipTest(RleVersion_2, false);
+    runSkipTest(RleVersion_2, true);
+  }
+
+  TEST(RLEv2, encoderKernelsMatchDefault) {
+    struct Kernels {
+      decltype(&RleV2Default::analyzeLiterals) analyzeLiterals;
+      decltype(&RleV2Default::zigZag) zigZag;
+      decltype(&RleV2Default::bitWidthHistogram) bitWidthHistogram;
+      decltype(&RleV2Default::packBits) packBits;
+    };
+    std::vector<Kernels> kernels = {{RleV2Default::analyzeLiterals, RleV2Default::zigZag,
+                                     RleV2Default::bitWidthHistogram, RleV2Default::packBits}};
+#if defined(ORC_HAVE_RUNTIME_AVX2)
+    if (CpuInfo::getInstance()->isDetected(CpuInfo::AVX2 | CpuInfo::BMI2)) {
+      kernels.push_back({RleV2AVX2::analyzeLiterals, RleV2AVX2::zigZag,
+                         RleV2Default::bitWidthHistogram, RleV2AVX2::packBits});
+    }
+#endif
+#if defined(ORC_HAVE_RUNTIME_AVX512)
+    if (CpuInfo::getInstance()->isDetected(CpuInfo::AVX512)) {
+      kernels.push_back({RleV2AVX512::analyzeLiterals, RleV2AVX512::zigZag,
+                         RleV2AVX512::bitWidthHistogram, RleV2AVX512::packBits});
+    }
+#endif
+    std::mt19937_64 random(5);
+    for (uint64_t numValues : {2, 3, 5, 6, 9, 10, 33, 512}) {
+      std::vector<std::vector<int64_t>> inputs(4, std::vector<int64_t>(numValues));
+      for (uint64_t i = 0; i < numValues; ++i) {
+        inputs[0][i] = static_cast<int64_t>(random() >> (random() % 64));
+        inputs[1][i] = 1000 + 3 * static_cast<int64_t>(i);
+        inputs[2][i] = -static_cast<int64_t>(random() % 100) - 10 * static_cast<int64_t>(i);
+        inputs[3][i] = i % 2 == 0 ? std::numeric_limits<int64_t>::min()
+                                  : std::numeric_limits<int64_t>::max();
+      }
+      for (const std::vector<int64_t>& values : inputs) {
+        LiteralStats expected;
+        std::vector<int64_t> expectedDeltas(numValues);
+        RleV2Default::analyzeLiterals(values.data(), numValues, expectedDeltas.data(), expected);
+        std::vector<int64_t> expectedZigZag(numValues);
+        RleV2Default::zigZag(values.data(), expectedZigZag.data(), numValues);
+        for (const Kernels& kernel : kernels) {
+          LiteralStats actual;
+          std::vector<int64_t> actualDeltas(numValues);
+          kernel.analyzeLiterals(values.data(), numValues, actualDeltas.data(), actual);
+          EXPECT_EQ(expected.min, actual.min);
+          EXPECT_EQ(expected.max, actual.max);
+          EXPECT_EQ(expected.lastDelta, actual.lastDelta);
+          EXPECT_EQ(expected.deltaMax, actual.deltaMax);
+          EXPECT_EQ(expected.isIncreasing, actual.isIncreasing);
+          EXPECT_EQ(expected.isDecreasing, actual.isDecreasing);
+          EXPECT_EQ(expected.isFixedDelta, actual.isFixedDelta);
+          expectedDeltas.back() = actualDeltas.back() = 0;
+          EXPECT_EQ(expectedDeltas, actualDeltas);
+
+          std::vector<int64_t> actualZigZag(numValues);
+          kernel.zigZag(values.data(), actualZigZag.data(), numValues);
+          EXPECT_EQ(expectedZigZag, actualZigZag);
+
+          std::vector<int32_t> histogram(HIST_LEN, 0);
+          kernel.bitWidthHistogram(values.data(), numValues, histogram.data());
+          for (int64_t value : values) {
+            histogram[encodeBitWidth(findClosestNumBits(value))] -= 1;
+          }
+          EXPECT_EQ(std::vector<int32_t>(HIST_LEN, 0), histogram);
+        }
+      }
+
+      // compare the packed bytes with the bits written one at a time
+      for (uint32_t bitSize = 1; bitSize <= 64; ++bitSize) {
+        const std::vector<int64_t>& values = inputs[0];
+        std::vector<char> expected((numValues * bitSize + 7) / 8, 0);
+        for (uint64_t i = 0; i < numValues; ++i) {
+          for (uint32_t bit = 0; bit < bitSize; ++bit) {
+            uint64_t position = i * bitSize + bit;
+            if ((static_cast<uint64_t>(values[i]) >> (bitSize - 1 - bit)) & 1) {
+              expected[position / 8] =
+                  static_cast<char>(expected[position / 8] | (0x80 >> (position % 8)));
+            }
+          }
+        }
+        for (const Kernels& kernel : kernels) {
+          std::vector<char> actual(numValues * 8 + RleV2Default::PACKING_PADDING);
+          actual.resize(kernel.packBits(values.data(), numValues, bitSize, actual.data()));
+          EXPECT_EQ(expected, actual) << "bit size " << bitSize;
+        }
+      }
+    }
+  }
+
   INSTANTIATE_TEST_SUITE_P(OrcTest, RleTest, Values(true, false));
 }  // namespace orc
@@ -403,6 +403,34 @@ namespace orc {
     EXPECT_EQ(1699164000 + 8 * 3600, la->convertFromUTC(1699164000));
   }
 
+  void checkVariantRanges(const Timezone& zone) {
+    // step a bit more than a month at a time from 1900 to 2400
+    for (int64_t clk = -2208988800; clk < 13569465600; clk += 3000017) {
+      int64_t start, end;
+      const TimezoneVariant& variant = zone.getVariantRange(clk, start, end);
+      EXPECT_EQ(&zone.getVariant(clk), &variant) << clk;
+      EXPECT_LE(start, clk);
+      EXPECT_GE(end, clk);
+      EXPECT_TRUE(zone.getVariant(start).hasSameTzRule(variant)) << clk;
+      EXPECT_TRUE(zone.getVariant(end).hasSameTzRule(variant)) << clk;
+    }
+  }
+
+  TEST(TestTimezone, testVariantRange) {
+    const Timezone* la = &getTimezoneByName("America/Los_Angeles");
+    checkVariantRanges(*la);
+    checkVariantRanges(getTimezoneByName("America/New_York"));
+    checkVariantRanges(getTimezoneByName("Asia/Shanghai"));
+    checkVariantRanges(getTimezoneByName("GMT"));
+
+    // 2023-05-29 22:20:00 UTC is in PDT from 2023-03-12 10:00:00 UTC
+    // until 2023-11-05 09:00:00 UTC
+    int64_t start, end;
+    EXPECT_EQ("PDT", la->getVariantRange(1685398800, start, end).name);
+    EXPECT_EQ(1678615200, start);
+    EXPECT_EQ(1699174800 - 1, end);
+  }
+
 #ifndef _MSC_VER
   TEST(TestTimezone, testMissingTZDB) {
     const char* tzDirBackup = std::getenv("TZDIR");
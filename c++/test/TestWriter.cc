@@ -723,6 +723,60 @@ namespace orc {
     testWriteTimestampWithTimezone(fileVersion, "America/Los_Angeles", "America/Los_Angeles",
                                    "2014-06-06 12:34:56", IS_DST);
   }
+
+  TEST_P(WriterTest, readTimestampBatchesAcrossDst) {
+    MemoryOutputStream memStream(DEFAULT_MEM_STREAM_SIZE);
+    MemoryPool* pool = getDefaultPool();
+    std::unique_ptr<Type> type(Type::buildTypeFromString("struct<col1:timestamp>"));
+    uint64_t rowCount = 300;
+
+    std::unique_ptr<Writer> writer = createWriter(16 * 1024, 1024, CompressionKind_ZLIB, *type,
+                                                  pool, &memStream, fileVersion, 0,
+                                                  "America/Los_Angeles");
+    auto batch = writer->createRowBatch(rowCount);
+    auto& structBatch = dynamic_cast<StructVectorBatch&>(*batch);
+    auto& tsBatch = dynamic_cast<TimestampVectorBatch&>(*structBatch.fields[0]);
+    // every 10 minutes from 2012-03-10 20:00:00 PST, over the start of PDT
+    for (uint64_t i = 0; i < rowCount; ++i) {
+      tsBatch.notNull[i] = i % 7 != 0;
+      tsBatch.data[i] = 1331438400 + static_cast<int64_t>(i) * 600;
+      tsBatch.nanoseconds[i] = static_cast<int64_t>(i % 10) * 100000000 + (i % 3) * 1000;
+    }
+    tsBatch.hasNulls = true;
+    structBatch.numElements = rowCount;
+    tsBatch.numElements = rowCount;
+    writer->add(*batch);
+    writer->close();
+
+    // read the rows in one batch and one row at a time
+    std::vector<int64_t> seconds[2];
+    for (uint64_t batchSize : {rowCount, uint64_t{1}}) {
+      auto inStream =
+          std::make_unique<MemoryInputStream>(memStream.getData(), memStream.getLength());
+      std::unique_ptr<Reader> reader = createReader(pool, std::move(inStream));
+      std::unique_ptr<RowReader> rowReader = createRowReader(reader.get(), "Asia/Shanghai");
+      auto readBatch = rowReader->createRowBatch(batchSize);
+      auto& readStruct = dynamic_cast<StructVectorBatch&>(*readBatch);
+      auto& readTs = dynamic_cast<TimestampVectorBatch&>(*readStruct.fields[0]);
+      std::vector<int64_t>& result = seconds[batchSize == 1];
+      while (rowReader->next(*readBatch)) {
+        for (uint64_t i = 0; i < readBatch->numElements; ++i) {
+          uint64_t row = result.size();
+          EXPECT_EQ(row % 7 != 0, readTs.notNull[i] != 0);
+          if (readTs.notNull[i]) {
+            EXPECT_EQ(static_cast<int64_t>(row % 10) * 100000000 + (row % 3) * 1000,
+                      readTs.nanoseconds[i]);
+          }
+          result.push_back(readTs.notNull[i] ? readTs.data[i] : 0);
+        }
+      }
+    }
+    EXPECT_EQ(rowCount, seconds[0].size());
+    EXPECT_EQ(seconds[1], seconds[0]);
+    // the same wall clock time in Shanghai, which is 16 and then 15 hours ahead
+    EXPECT_EQ(1331438400 - 16 * 3600, seconds[0][1] - 600);
+    EXPECT_EQ(1331438400 + 299 * 600 - 15 * 3600, seconds[0][299]);
+  }
 #endif
 
   TEST_P(WriterTest, writeTimestampInstant) {